@@ -46,6 +46,10 @@
 #include "stdlib.h"
 #include "stdio.h"
 #include "string.h"
+#include "math.h"
+#if HAS_PTHREAD
+#include "pthread.h"
+#endif
 
 #include "common.h"
 #include "data_rtl.h"
@@ -62,7 +66,40 @@
 #include "arr_rtl.h"
 
 
-#define QSORT_LIMIT 8
+#define INSERTION_SORT_LIMIT 16
+#define RADIX_SORT_LIMIT 256
+#define RADIX_SORT_BITS 8
+#define RADIX_SORT_BUCKETS (1 << RADIX_SORT_BITS)
+#define RADIX_SORT_PASSES (GENERIC_SIZE / RADIX_SORT_BITS)
+#define GENERIC_SIGN_BIT ((genericType) 1 << (GENERIC_SIZE - 1))
+#define PARALLEL_SORT_LIMIT 65536
+#define PARALLEL_SORT_CHUNK 16384
+#define MAX_SORT_THREADS 64
+
+typedef enum {
+    INT_SORT_KEYS, FLOAT_SORT_KEYS, CHAR_SORT_KEYS, STRI_SORT_KEYS
+  } sortKeyType;
+
+typedef struct {
+    rtlObjectType key;
+    memSizeType index;
+  } keyIndexRecord;
+
+#if HAS_PTHREAD
+typedef struct {
+    sortKeyType keyType;
+    rtlObjectType *left;
+    memSizeType left_size;
+    rtlObjectType *right;
+    memSizeType right_size;
+    rtlObjectType *dest;
+  } sortTaskRecord, *sortTaskType;
+#endif
+
+intType intCmpGeneric (const genericType value1, const genericType value2);
+intType fltCmpGeneric (const genericType value1, const genericType value2);
+intType chrCmpGeneric (const genericType value1, const genericType value2);
+intType strCmpGeneric (const genericType value1, const genericType value2);
 
 
 
@@ -99,66 +136,890 @@ static void printArgv (const int argc, const cstriType *const argv)
 
 
 /**
- *  Sort an array of 'rtlObjectType' elements with the quicksort algorithm.
- *  In contrast to qsort() this function uses a different compare function.
- *  The compare function of qsort() has two void pointers as parameters.
+ *  Compare two elements with 'cmp_func'.
+ *  Strings are compared with a direct call of strCompare().
+ *  @return -1, 0 or 1 if the first argument is considered to be
+ *          respectively less than, equal to, or greater than the
+ *          second.
+ */
+static inline intType compareElements (const genericType value1,
+    const genericType value2, const compareType cmp_func)
+
+  {
+    intType signumValue;
+
+  /* compareElements */
+    if (cmp_func == &strCmpGeneric) {
+      signumValue = strCompare(((const_rtlObjectType *) &value1)->value.striValue,
+                               ((const_rtlObjectType *) &value2)->value.striValue);
+    } else {
+      signumValue = cmp_func(value1, value2);
+    } /* if */
+    return signumValue;
+  } /* compareElements */
+
+
+
+/**
+ *  Sort an array of 'rtlObjectType' elements with the insertion sort algorithm.
+ *  The insertion sort is stable. Elements, which are considered equal,
+ *  keep their order.
  *  @param begin_sort Pointer to first element to be sorted.
  *  @param end_sort Pointer to the last element to be sorted.
  *  @param cmp_func Pointer to a compare function that gets two values as
  *         'genericType' and compares them.
  */
-static void rtl_qsort_array (rtlObjectType *begin_sort, rtlObjectType *end_sort,
+static void rtl_insertion_sort (rtlObjectType *begin_sort, rtlObjectType *end_sort,
     compareType cmp_func)
 
+  {
+    genericType compare_elem;
+    rtlObjectType *middle_elem;
+    rtlObjectType *insert_elem;
+
+  /* rtl_insertion_sort */
+    for (middle_elem = begin_sort + 1; middle_elem <= end_sort; middle_elem++) {
+      compare_elem = middle_elem->value.genericValue;
+      insert_elem = middle_elem;
+      while (insert_elem != begin_sort &&
+             compareElements(insert_elem[-1].value.genericValue,
+                             compare_elem, cmp_func) > 0) {
+        insert_elem->value.genericValue = insert_elem[-1].value.genericValue;
+        insert_elem--;
+      } /* while */
+      insert_elem->value.genericValue = compare_elem;
+    } /* for */
+  } /* rtl_insertion_sort */
+
+
+
+/**
+ *  Sort an array of 'rtlObjectType' elements with the heapsort algorithm.
+ *  The heapsort is used by rtl_intro_sort() to guarantee O(n log n).
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param size Number of elements to be sorted.
+ *  @param cmp_func Pointer to a compare function that gets two values as
+ *         'genericType' and compares them.
+ */
+static void rtl_heap_sort (rtlObjectType *begin_sort, memSizeType size,
+    compareType cmp_func)
+
+  {
+    memSizeType start;
+    memSizeType heap_size;
+    memSizeType pos;
+    memSizeType child;
+    genericType sift_elem;
+
+  /* rtl_heap_sort */
+    start = size >> 1;
+    heap_size = size;
+    while (heap_size > 1) {
+      if (start != 0) {
+        /* Build the heap. */
+        start--;
+        sift_elem = begin_sort[start].value.genericValue;
+        pos = start;
+      } else {
+        /* Move the biggest element behind the heap. */
+        heap_size--;
+        sift_elem = begin_sort[heap_size].value.genericValue;
+        begin_sort[heap_size].value.genericValue = begin_sort[0].value.genericValue;
+        pos = 0;
+      } /* if */
+      child = 2 * pos + 1;
+      while (child < heap_size) {
+        if (child + 1 < heap_size &&
+            compareElements(begin_sort[child].value.genericValue,
+                            begin_sort[child + 1].value.genericValue,
+                            cmp_func) < 0) {
+          child++;
+        } /* if */
+        if (compareElements(sift_elem, begin_sort[child].value.genericValue,
+                            cmp_func) < 0) {
+          begin_sort[pos].value.genericValue = begin_sort[child].value.genericValue;
+          pos = child;
+          child = 2 * pos + 1;
+        } else {
+          child = heap_size;
+        } /* if */
+      } /* while */
+      begin_sort[pos].value.genericValue = sift_elem;
+    } /* while */
+  } /* rtl_heap_sort */
+
+
+
+/**
+ *  Sort an array of 'rtlObjectType' elements with the introsort algorithm.
+ *  Introsort is a quicksort with a median of three pivot. If the recursion
+ *  gets deeper than 'depth_limit' the heapsort is used instead. This
+ *  guarantees O(n log n) also for inputs that are bad for the quicksort.
+ *  Small ranges are sorted with the insertion sort. The smaller partition
+ *  is sorted recursively and the larger one in a loop. In contrast to
+ *  qsort() this function uses a different compare function. The compare
+ *  function of qsort() has two void pointers as parameters.
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param end_sort Pointer to the last element to be sorted.
+ *  @param depth_limit Number of partition steps before the heapsort is used.
+ *  @param cmp_func Pointer to a compare function that gets two values as
+ *         'genericType' and compares them.
+ */
+static void rtl_intro_sort (rtlObjectType *begin_sort, rtlObjectType *end_sort,
+    unsigned int depth_limit, compareType cmp_func)
+
   {
     genericType compare_elem;
     genericType help_element;
     rtlObjectType *middle_elem;
     rtlObjectType *less_elem;
     rtlObjectType *greater_elem;
-    intType cmp;
 
-  /* rtl_qsort_array */
-    if (end_sort - begin_sort < QSORT_LIMIT) {
-      /* Use insertion sort */
-      for (middle_elem = begin_sort + 1; middle_elem <= end_sort; middle_elem++) {
+  /* rtl_intro_sort */
+    while (end_sort - begin_sort >= INSERTION_SORT_LIMIT) {
+      if (depth_limit == 0) {
+        rtl_heap_sort(begin_sort, (memSizeType) (end_sort - begin_sort) + 1,
+                      cmp_func);
+        end_sort = begin_sort;
+      } else {
+        depth_limit--;
+        /* Order the first, the middle and the last element. */
+        middle_elem = &begin_sort[((memSizeType) (end_sort - begin_sort)) >> 1];
+        if (compareElements(middle_elem->value.genericValue,
+                            begin_sort->value.genericValue, cmp_func) < 0) {
+          help_element = middle_elem->value.genericValue;
+          middle_elem->value.genericValue = begin_sort->value.genericValue;
+          begin_sort->value.genericValue = help_element;
+        } /* if */
+        if (compareElements(end_sort->value.genericValue,
+                            middle_elem->value.genericValue, cmp_func) < 0) {
+          help_element = end_sort->value.genericValue;
+          end_sort->value.genericValue = middle_elem->value.genericValue;
+          middle_elem->value.genericValue = help_element;
+          if (compareElements(middle_elem->value.genericValue,
+                              begin_sort->value.genericValue, cmp_func) < 0) {
+            help_element = middle_elem->value.genericValue;
+            middle_elem->value.genericValue = begin_sort->value.genericValue;
+            begin_sort->value.genericValue = help_element;
+          } /* if */
+        } /* if */
+        /* The first and the last element act as sentinels. */
         compare_elem = middle_elem->value.genericValue;
-        less_elem = begin_sort - 1;
+        less_elem = begin_sort;
+        greater_elem = end_sort;
         do {
-          less_elem++;
-          cmp = cmp_func(less_elem->value.genericValue, compare_elem);
-        } while (cmp < 0);
-        memmove(&less_elem[1], less_elem, (memSizeType)
-                (middle_elem - less_elem) * sizeof(rtlObjectType));
-        less_elem->value.genericValue = compare_elem;
+          do {
+            less_elem++;
+          } while (compareElements(less_elem->value.genericValue,
+                                   compare_elem, cmp_func) < 0);
+          do {
+            greater_elem--;
+          } while (compareElements(greater_elem->value.genericValue,
+                                   compare_elem, cmp_func) > 0);
+          if (less_elem < greater_elem) {
+            help_element = less_elem->value.genericValue;
+            less_elem->value.genericValue = greater_elem->value.genericValue;
+            greater_elem->value.genericValue = help_element;
+          } /* if */
+        } while (less_elem < greater_elem);
+        /* Now [begin_sort, less_elem - 1] <= compare_elem and */
+        /* [greater_elem + 1, end_sort] >= compare_elem holds. */
+        if (less_elem - begin_sort < end_sort - greater_elem) {
+          rtl_intro_sort(begin_sort, less_elem - 1, depth_limit, cmp_func);
+          begin_sort = greater_elem + 1;
+        } else {
+          rtl_intro_sort(greater_elem + 1, end_sort, depth_limit, cmp_func);
+          end_sort = less_elem - 1;
+        } /* if */
+      } /* if */
+    } /* while */
+    if (end_sort > begin_sort) {
+      rtl_insertion_sort(begin_sort, end_sort, cmp_func);
+    } /* if */
+  } /* rtl_intro_sort */
+
+
+
+/**
+ *  Sort an array of 'rtlObjectType' elements with the merge sort algorithm.
+ *  The merge sort is stable. Elements, which are considered equal,
+ *  keep their order.
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param size Number of elements to be sorted.
+ *  @param buffer Temporary storage for at least size / 2 elements.
+ *  @param cmp_func Pointer to a compare function that gets two values as
+ *         'genericType' and compares them.
+ */
+static void rtl_merge_sort (rtlObjectType *begin_sort, memSizeType size,
+    rtlObjectType *buffer, compareType cmp_func)
+
+  {
+    memSizeType half;
+    rtlObjectType *left_elem;
+    rtlObjectType *left_beyond;
+    rtlObjectType *right_elem;
+    rtlObjectType *right_beyond;
+    rtlObjectType *dest_elem;
+
+  /* rtl_merge_sort */
+    if (size <= INSERTION_SORT_LIMIT) {
+      if (size > 1) {
+        rtl_insertion_sort(begin_sort, &begin_sort[size - 1], cmp_func);
+      } /* if */
+    } else {
+      half = size >> 1;
+      rtl_merge_sort(begin_sort, half, buffer, cmp_func);
+      rtl_merge_sort(&begin_sort[half], size - half, buffer, cmp_func);
+      if (compareElements(begin_sort[half - 1].value.genericValue,
+                          begin_sort[half].value.genericValue, cmp_func) > 0) {
+        memcpy(buffer, begin_sort, half * sizeof(rtlObjectType));
+        left_elem = buffer;
+        left_beyond = &buffer[half];
+        right_elem = &begin_sort[half];
+        right_beyond = &begin_sort[size];
+        dest_elem = begin_sort;
+        while (left_elem != left_beyond && right_elem != right_beyond) {
+          /* Take the left element if both are equal. This keeps it stable. */
+          if (compareElements(right_elem->value.genericValue,
+                              left_elem->value.genericValue, cmp_func) < 0) {
+            dest_elem->value.genericValue = right_elem->value.genericValue;
+            right_elem++;
+          } else {
+            dest_elem->value.genericValue = left_elem->value.genericValue;
+            left_elem++;
+          } /* if */
+          dest_elem++;
+        } /* while */
+        /* Remaining right elements are already at their place. */
+        memcpy(dest_elem, left_elem,
+               (memSizeType) (left_beyond - left_elem) * sizeof(rtlObjectType));
+      } /* if */
+    } /* if */
+  } /* rtl_merge_sort */
+
+
+
+/**
+ *  Sort integer, float or char elements with a LSD radix sort.
+ *  The values are mapped to unsigned keys, which have the same order
+ *  as the values. Integers are mapped by flipping the sign bit.
+ *  Floats are mapped by flipping the sign bit of positive numbers and
+ *  all bits of negative numbers. NaN values are moved behind all
+ *  other floats, since fltCmp() considers them greater than all
+ *  other numbers. Chars are used as keys. Passes for bytes, which are
+ *  equal in all keys, are skipped. The radix sort is stable.
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param size Number of elements to be sorted.
+ *  @param buffer Temporary storage for at least size elements.
+ *  @param keyType Type of the elements.
+ */
+static void rtl_radix_sort_buffer (rtlObjectType *begin_sort, memSizeType size,
+    rtlObjectType *buffer, sortKeyType keyType)
+
+  {
+    memSizeType bucket_start[RADIX_SORT_PASSES][RADIX_SORT_BUCKETS];
+    rtlObjectType *source;
+    rtlObjectType *dest;
+    rtlObjectType *help_ptr;
+    memSizeType num_keys;
+    memSizeType num_nans = 0;
+    memSizeType pos;
+    memSizeType bucket_size;
+    memSizeType sum;
+    unsigned int pass;
+    unsigned int bucket;
+    genericType key;
+
+  /* rtl_radix_sort_buffer */
+    memset(bucket_start, 0, sizeof(bucket_start));
+    num_keys = 0;
+    for (pos = 0; pos < size; pos++) {
+      key = begin_sort[pos].value.genericValue;
+      if (keyType == FLOAT_SORT_KEYS &&
+          os_isnan(begin_sort[pos].value.floatValue)) {
+        buffer[num_nans].value.genericValue = key;
+        num_nans++;
+      } else {
+        if (keyType == INT_SORT_KEYS) {
+          key ^= GENERIC_SIGN_BIT;
+        } else if (keyType == CHAR_SORT_KEYS) {
+          key = (genericType) begin_sort[pos].value.charValue;
+        } else if (key & GENERIC_SIGN_BIT) {
+          key = ~key;
+        } else {
+          key |= GENERIC_SIGN_BIT;
+        } /* if */
+        begin_sort[num_keys].value.genericValue = key;
+        num_keys++;
+        for (pass = 0; pass < RADIX_SORT_PASSES; pass++) {
+          bucket_start[pass][(key >> (pass * RADIX_SORT_BITS)) &
+                             (RADIX_SORT_BUCKETS - 1)]++;
+        } /* for */
+      } /* if */
+    } /* for */
+    /* Append the NaN values in their original order. */
+    memcpy(&begin_sort[num_keys], buffer, num_nans * sizeof(rtlObjectType));
+    source = begin_sort;
+    dest = buffer;
+    for (pass = 0; pass < RADIX_SORT_PASSES; pass++) {
+      if (num_keys != 0 && bucket_start[pass][(source[0].value.genericValue >>
+          (pass * RADIX_SORT_BITS)) & (RADIX_SORT_BUCKETS - 1)] != num_keys) {
+        sum = 0;
+        for (bucket = 0; bucket < RADIX_SORT_BUCKETS; bucket++) {
+          bucket_size = bucket_start[pass][bucket];
+          bucket_start[pass][bucket] = sum;
+          sum += bucket_size;
+        } /* for */
+        for (pos = 0; pos < num_keys; pos++) {
+          key = source[pos].value.genericValue;
+          dest[bucket_start[pass][(key >> (pass * RADIX_SORT_BITS)) &
+                                  (RADIX_SORT_BUCKETS - 1)]++].value.genericValue = key;
+        } /* for */
+        help_ptr = source;
+        source = dest;
+        dest = help_ptr;
+      } /* if */
+    } /* for */
+    /* Map the keys back to the original values. */
+    for (pos = 0; pos < num_keys; pos++) {
+      key = source[pos].value.genericValue;
+      if (keyType == INT_SORT_KEYS) {
+        begin_sort[pos].value.genericValue = key ^ GENERIC_SIGN_BIT;
+      } else if (keyType == CHAR_SORT_KEYS) {
+        begin_sort[pos].value.charValue = (charType) key;
+      } else if (key & GENERIC_SIGN_BIT) {
+        begin_sort[pos].value.genericValue = key & ~GENERIC_SIGN_BIT;
+      } else {
+        begin_sort[pos].value.genericValue = ~key;
+      } /* if */
+    } /* for */
+  } /* rtl_radix_sort_buffer */
+
+
+
+/**
+ *  Sort integer, float or char elements with a LSD radix sort.
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param size Number of elements to be sorted.
+ *  @param keyType Type of the elements.
+ *  @return TRUE if the elements have been sorted, or
+ *          FALSE if there was not enough memory.
+ */
+static boolType rtl_radix_sort (rtlObjectType *begin_sort, memSizeType size,
+    sortKeyType keyType)
+
+  {
+    rtlObjectType *buffer;
+    boolType okay;
+
+  /* rtl_radix_sort */
+    if (unlikely(!ALLOC_TABLE(buffer, rtlObjectType, size))) {
+      okay = FALSE;
+    } else {
+      rtl_radix_sort_buffer(begin_sort, size, buffer, keyType);
+      FREE_TABLE(buffer, rtlObjectType, size);
+      okay = TRUE;
+    } /* if */
+    return okay;
+  } /* rtl_radix_sort */
+
+
+
+#if HAS_PTHREAD
+/**
+ *  Map a float to an unsigned key with the same order as the radix sort.
+ *  NaN values are mapped to the biggest key.
+ */
+static inline genericType floatSortKey (const genericType value)
+
+  {
+    genericType key;
+
+  /* floatSortKey */
+    if (os_isnan(((const_rtlObjectType *) &value)->value.floatValue)) {
+      key = ~(genericType) 0;
+    } else if (value & GENERIC_SIGN_BIT) {
+      key = ~value;
+    } else {
+      key = value | GENERIC_SIGN_BIT;
+    } /* if */
+    return key;
+  } /* floatSortKey */
+
+
+
+/**
+ *  Check if an element is sorted before another one.
+ *  The order is the same as the one of the sequential sort.
+ *  Floats are ordered like the radix sort orders them.
+ *  @return TRUE if 'value1' is less than 'value2', or
+ *          FALSE otherwise.
+ */
+static inline boolType lessElement (const genericType value1,
+    const genericType value2, const sortKeyType keyType)
+
+  {
+    boolType less;
+
+  /* lessElement */
+    switch (keyType) {
+      case INT_SORT_KEYS:
+        less = ((const_rtlObjectType *) &value1)->value.intValue <
+               ((const_rtlObjectType *) &value2)->value.intValue;
+        break;
+      case CHAR_SORT_KEYS:
+        less = ((const_rtlObjectType *) &value1)->value.charValue <
+               ((const_rtlObjectType *) &value2)->value.charValue;
+        break;
+      case FLOAT_SORT_KEYS:
+        less = floatSortKey(value1) < floatSortKey(value2);
+        break;
+      default:
+        less = strCompare(((const_rtlObjectType *) &value1)->value.striValue,
+                          ((const_rtlObjectType *) &value2)->value.striValue) < 0;
+        break;
+    } /* switch */
+    return less;
+  } /* lessElement */
+
+
+
+/**
+ *  Execute a task of the parallel sort.
+ *  If 'task->right' is NULL the elements at 'task->left' are sorted
+ *  in place and 'task->dest' is used as temporary storage. Otherwise
+ *  the sorted runs at 'task->left' and 'task->right' are merged into
+ *  'task->dest'. The merge is stable.
+ *  @param task Pointer to a sortTaskRecord.
+ *  @return NULL.
+ */
+static void *rtl_sort_task (void *task_arg)
+
+  {
+    sortTaskType task;
+    unsigned int depth_limit = 0;
+    rtlObjectType *left_elem;
+    rtlObjectType *left_beyond;
+    rtlObjectType *right_elem;
+    rtlObjectType *right_beyond;
+    rtlObjectType *dest_elem;
+
+  /* rtl_sort_task */
+    task = (sortTaskType) task_arg;
+    if (task->right == NULL) {
+      if (task->keyType == STRI_SORT_KEYS) {
+        while (task->left_size >> depth_limit > 1) {
+          depth_limit++;
+        } /* while */
+        rtl_intro_sort(task->left, &task->left[task->left_size - 1],
+                       2 * depth_limit, &strCmpGeneric);
+      } else {
+        rtl_radix_sort_buffer(task->left, task->left_size, task->dest,
+                              task->keyType);
+      } /* if */
+    } else {
+      left_elem = task->left;
+      left_beyond = &task->left[task->left_size];
+      right_elem = task->right;
+      right_beyond = &task->right[task->right_size];
+      dest_elem = task->dest;
+      while (left_elem != left_beyond && right_elem != right_beyond) {
+        if (lessElement(right_elem->value.genericValue,
+                        left_elem->value.genericValue, task->keyType)) {
+          dest_elem->value.genericValue = right_elem->value.genericValue;
+          right_elem++;
+        } else {
+          dest_elem->value.genericValue = left_elem->value.genericValue;
+          left_elem++;
+        } /* if */
+        dest_elem++;
+      } /* while */
+      memcpy(dest_elem, left_elem,
+             (memSizeType) (left_beyond - left_elem) * sizeof(rtlObjectType));
+      dest_elem += left_beyond - left_elem;
+      memcpy(dest_elem, right_elem,
+             (memSizeType) (right_beyond - right_elem) * sizeof(rtlObjectType));
+    } /* if */
+    return NULL;
+  } /* rtl_sort_task */
+
+
+
+/**
+ *  Determine how many elements of the left run are merged first.
+ *  The stable merge of 'left' and 'right' is considered. The first
+ *  'dest_pos' elements of the merge consist of the first n elements
+ *  of 'left' and the first dest_pos - n elements of 'right'.
+ *  @return the number n of elements from the left run.
+ */
+static memSizeType rtl_merge_split (const rtlObjectType *left,
+    memSizeType left_size, const rtlObjectType *right,
+    memSizeType right_size, memSizeType dest_pos, sortKeyType keyType)
+
+  {
+    memSizeType low;
+    memSizeType high;
+    memSizeType middle;
+
+  /* rtl_merge_split */
+    low = dest_pos > right_size ? dest_pos - right_size : 0;
+    high = dest_pos < left_size ? dest_pos : left_size;
+    while (low < high) {
+      middle = low + ((high - low) >> 1);
+      if (lessElement(right[dest_pos - middle - 1].value.genericValue,
+                      left[middle].value.genericValue, keyType)) {
+        high = middle;
+      } else {
+        low = middle + 1;
+      } /* if */
+    } /* while */
+    return low;
+  } /* rtl_merge_split */
+
+
+
+/**
+ *  Execute the tasks of the parallel sort concurrently.
+ *  The first task is executed by the current thread. Every other
+ *  task gets its own thread. If a thread cannot be created its task
+ *  is executed by the current thread.
+ */
+static void rtl_run_sort_tasks (sortTaskRecord *tasks, int num_tasks)
+
+  {
+    pthread_t threads[MAX_SORT_THREADS];
+    boolType started[MAX_SORT_THREADS];
+    int task_num;
+
+  /* rtl_run_sort_tasks */
+    for (task_num = 1; task_num < num_tasks; task_num++) {
+      started[task_num] = pthread_create(&threads[task_num], NULL,
+          rtl_sort_task, &tasks[task_num]) == 0;
+    } /* for */
+    rtl_sort_task(&tasks[0]);
+    for (task_num = 1; task_num < num_tasks; task_num++) {
+      if (started[task_num]) {
+        pthread_join(threads[task_num], NULL);
+      } else {
+        rtl_sort_task(&tasks[task_num]);
+      } /* if */
+    } /* for */
+  } /* rtl_run_sort_tasks */
+
+
+
+/**
+ *  Sort integer, float, char or string elements with several threads.
+ *  The array is split into one run per thread and the runs are sorted
+ *  concurrently. Afterwards pairs of runs are merged until one run is
+ *  left. Every merge is split into pieces of equal size, such that all
+ *  threads are busy in every merge round. The result is identical to
+ *  the result of the sequential sort.
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param size Number of elements to be sorted.
+ *  @param keyType Type of the elements.
+ *  @param numThreads Number of threads (2 to MAX_SORT_THREADS).
+ *  @return TRUE if the elements have been sorted, or
+ *          FALSE if there was not enough memory.
+ */
+static boolType rtl_parallel_sort (rtlObjectType *begin_sort, memSizeType size,
+    sortKeyType keyType, int numThreads)
+
+  {
+    sortTaskRecord tasks[MAX_SORT_THREADS];
+    memSizeType run_start[MAX_SORT_THREADS + 1];
+    rtlObjectType *buffer;
+    rtlObjectType *source;
+    rtlObjectType *dest;
+    rtlObjectType *help_ptr;
+    int num_runs;
+    int run;
+    int num_pieces;
+    int piece;
+    int num_tasks;
+    memSizeType left_size;
+    memSizeType right_size;
+    memSizeType dest_pos;
+    memSizeType left_pos;
+    memSizeType prev_dest_pos;
+    memSizeType prev_left_pos;
+    boolType okay;
+
+  /* rtl_parallel_sort */
+    if (unlikely(!ALLOC_TABLE(buffer, rtlObjectType, size))) {
+      okay = FALSE;
+    } else {
+      num_runs = numThreads;
+      for (run = 0; run <= num_runs; run++) {
+        run_start[run] = size / (memSizeType) num_runs * (memSizeType) run +
+            size % (memSizeType) num_runs * (memSizeType) run / (memSizeType) num_runs;
+      } /* for */
+      for (run = 0; run < num_runs; run++) {
+        tasks[run].keyType = keyType;
+        tasks[run].left = &begin_sort[run_start[run]];
+        tasks[run].left_size = run_start[run + 1] - run_start[run];
+        tasks[run].right = NULL;
+        tasks[run].right_size = 0;
+        tasks[run].dest = &buffer[run_start[run]];
+      } /* for */
+      rtl_run_sort_tasks(tasks, num_runs);
+      source = begin_sort;
+      dest = buffer;
+      while (num_runs > 1) {
+        num_pieces = numThreads / ((num_runs + 1) / 2);
+        num_tasks = 0;
+        for (run = 0; run < num_runs; run += 2) {
+          left_size = run_start[run + 1] - run_start[run];
+          if (run + 1 < num_runs) {
+            right_size = run_start[run + 2] - run_start[run + 1];
+          } else {
+            right_size = 0;
+          } /* if */
+          prev_dest_pos = 0;
+          prev_left_pos = 0;
+          for (piece = 1; piece <= num_pieces; piece++) {
+            dest_pos = (left_size + right_size) / (memSizeType) num_pieces *
+                       (memSizeType) piece;
+            if (piece == num_pieces) {
+              dest_pos = left_size + right_size;
+            } /* if */
+            left_pos = rtl_merge_split(&source[run_start[run]], left_size,
+                                       &source[run_start[run + 1]], right_size,
+                                       dest_pos, keyType);
+            tasks[num_tasks].keyType = keyType;
+            tasks[num_tasks].left = &source[run_start[run] + prev_left_pos];
+            tasks[num_tasks].left_size = left_pos - prev_left_pos;
+            tasks[num_tasks].right = &source[run_start[run + 1] +
+                                             prev_dest_pos - prev_left_pos];
+            tasks[num_tasks].right_size = (dest_pos - left_pos) -
+                                          (prev_dest_pos - prev_left_pos);
+            tasks[num_tasks].dest = &dest[run_start[run] + prev_dest_pos];
+            num_tasks++;
+            prev_dest_pos = dest_pos;
+            prev_left_pos = left_pos;
+          } /* for */
+          run_start[run / 2] = run_start[run];
+        } /* for */
+        num_runs = (num_runs + 1) / 2;
+        run_start[num_runs] = size;
+        rtl_run_sort_tasks(tasks, num_tasks);
+        help_ptr = source;
+        source = dest;
+        dest = help_ptr;
+      } /* while */
+      if (source != begin_sort) {
+        memcpy(begin_sort, source, size * sizeof(rtlObjectType));
+      } /* if */
+      FREE_TABLE(buffer, rtlObjectType, size);
+      okay = TRUE;
+    } /* if */
+    return okay;
+  } /* rtl_parallel_sort */
+#endif
+
+
+
+/**
+ *  Check if the key of a key index record is less than another key.
+ *  @return TRUE if the key of 'record1' is less than the key of
+ *          'record2', or FALSE otherwise.
+ */
+static inline boolType lessKey (const keyIndexRecord *record1,
+    const keyIndexRecord *record2, const sortKeyType keyType)
+
+  {
+    boolType less;
+
+  /* lessKey */
+    if (keyType == INT_SORT_KEYS) {
+      less = record1->key.value.intValue < record2->key.value.intValue;
+    } else {
+      less = strCompare(record1->key.value.striValue,
+                        record2->key.value.striValue) < 0;
+    } /* if */
+    return less;
+  } /* lessKey */
+
+
+
+/**
+ *  Sort key index records with a stable merge sort.
+ *  @param begin_sort Pointer to first record to be sorted.
+ *  @param size Number of records to be sorted.
+ *  @param buffer Temporary storage for at least size / 2 records.
+ *  @param keyType Type of the keys (INT_SORT_KEYS or STRI_SORT_KEYS).
+ */
+static void rtl_key_merge_sort (keyIndexRecord *begin_sort, memSizeType size,
+    keyIndexRecord *buffer, sortKeyType keyType)
+
+  {
+    memSizeType half;
+    memSizeType pos;
+    memSizeType insert_pos;
+    keyIndexRecord record;
+    keyIndexRecord *left_elem;
+    keyIndexRecord *left_beyond;
+    keyIndexRecord *right_elem;
+    keyIndexRecord *right_beyond;
+    keyIndexRecord *dest_elem;
+
+  /* rtl_key_merge_sort */
+    if (size <= INSERTION_SORT_LIMIT) {
+      for (pos = 1; pos < size; pos++) {
+        record = begin_sort[pos];
+        insert_pos = pos;
+        while (insert_pos > 0 && lessKey(&record, &begin_sort[insert_pos - 1], keyType)) {
+          begin_sort[insert_pos] = begin_sort[insert_pos - 1];
+          insert_pos--;
+        } /* while */
+        begin_sort[insert_pos] = record;
       } /* for */
     } else {
-      middle_elem = &begin_sort[((memSizeType)(end_sort - begin_sort)) >> 1];
-      compare_elem = middle_elem->value.genericValue;
-      middle_elem->value.genericValue = end_sort->value.genericValue;
-      end_sort->value.genericValue = compare_elem;
-      less_elem = begin_sort - 1;
-      greater_elem = end_sort;
-      do {
-        do {
-          less_elem++;
-          cmp = cmp_func(less_elem->value.genericValue, compare_elem);
-        } while (cmp < 0);
-        do {
-          greater_elem--;
-          cmp = cmp_func(greater_elem->value.genericValue, compare_elem);
-        } while (cmp > 0 && greater_elem != begin_sort);
-        help_element = less_elem->value.genericValue;
-        less_elem->value.genericValue = greater_elem->value.genericValue;
-        greater_elem->value.genericValue = help_element;
-      } while (greater_elem > less_elem);
-      greater_elem->value.genericValue = less_elem->value.genericValue;
-      less_elem->value.genericValue = compare_elem;
-      end_sort->value.genericValue = help_element;
-      rtl_qsort_array(begin_sort, less_elem - 1, cmp_func);
-      rtl_qsort_array(less_elem + 1, end_sort, cmp_func);
+      half = size >> 1;
+      rtl_key_merge_sort(begin_sort, half, buffer, keyType);
+      rtl_key_merge_sort(&begin_sort[half], size - half, buffer, keyType);
+      if (lessKey(&begin_sort[half], &begin_sort[half - 1], keyType)) {
+        memcpy(buffer, begin_sort, half * sizeof(keyIndexRecord));
+        left_elem = buffer;
+        left_beyond = &buffer[half];
+        right_elem = &begin_sort[half];
+        right_beyond = &begin_sort[size];
+        dest_elem = begin_sort;
+        while (left_elem != left_beyond && right_elem != right_beyond) {
+          if (lessKey(right_elem, left_elem, keyType)) {
+            *dest_elem = *right_elem;
+            right_elem++;
+          } else {
+            *dest_elem = *left_elem;
+            left_elem++;
+          } /* if */
+          dest_elem++;
+        } /* while */
+        memcpy(dest_elem, left_elem,
+               (memSizeType) (left_beyond - left_elem) * sizeof(keyIndexRecord));
+      } /* if */
     } /* if */
-  } /* rtl_qsort_array */
+  } /* rtl_key_merge_sort */
+
+
+
+#if INTTYPE_SIZE == GENERIC_SIZE
+/**
+ *  Sort key index records with integer keys with a LSD radix sort.
+ *  The radix sort is stable. Passes for bytes, which are equal in
+ *  all keys, are skipped.
+ *  @param begin_sort Pointer to first record to be sorted.
+ *  @param size Number of records to be sorted.
+ *  @param buffer Temporary storage for at least size records.
+ */
+static void rtl_key_radix_sort (keyIndexRecord *begin_sort, memSizeType size,
+    keyIndexRecord *buffer)
+
+  {
+    memSizeType bucket_start[RADIX_SORT_PASSES][RADIX_SORT_BUCKETS];
+    keyIndexRecord *source;
+    keyIndexRecord *dest;
+    keyIndexRecord *help_ptr;
+    memSizeType pos;
+    memSizeType bucket_size;
+    memSizeType sum;
+    unsigned int pass;
+    unsigned int bucket;
+    genericType key;
+
+  /* rtl_key_radix_sort */
+    memset(bucket_start, 0, sizeof(bucket_start));
+    for (pos = 0; pos < size; pos++) {
+      key = begin_sort[pos].key.value.genericValue ^ GENERIC_SIGN_BIT;
+      for (pass = 0; pass < RADIX_SORT_PASSES; pass++) {
+        bucket_start[pass][(key >> (pass * RADIX_SORT_BITS)) &
+                           (RADIX_SORT_BUCKETS - 1)]++;
+      } /* for */
+    } /* for */
+    source = begin_sort;
+    dest = buffer;
+    for (pass = 0; pass < RADIX_SORT_PASSES; pass++) {
+      key = source[0].key.value.genericValue ^ GENERIC_SIGN_BIT;
+      if (bucket_start[pass][(key >> (pass * RADIX_SORT_BITS)) &
+                             (RADIX_SORT_BUCKETS - 1)] != size) {
+        sum = 0;
+        for (bucket = 0; bucket < RADIX_SORT_BUCKETS; bucket++) {
+          bucket_size = bucket_start[pass][bucket];
+          bucket_start[pass][bucket] = sum;
+          sum += bucket_size;
+        } /* for */
+        for (pos = 0; pos < size; pos++) {
+          key = source[pos].key.value.genericValue ^ GENERIC_SIGN_BIT;
+          dest[bucket_start[pass][(key >> (pass * RADIX_SORT_BITS)) &
+                                  (RADIX_SORT_BUCKETS - 1)]++] = source[pos];
+        } /* for */
+        help_ptr = source;
+        source = dest;
+        dest = help_ptr;
+      } /* if */
+    } /* for */
+    if (source != begin_sort) {
+      memcpy(begin_sort, source, size * sizeof(keyIndexRecord));
+    } /* if */
+  } /* rtl_key_radix_sort */
+#endif
+
+
+
+/**
+ *  Sort an array by keys, which have been computed for its elements.
+ *  The elements are permuted in place along the cycles of the order.
+ *  @param arr1 Array to be sorted. It is sorted in place.
+ *  @param keys Array with the key of every element of 'arr1'.
+ *  @param striKeys TRUE if the keys are strings, or
+ *         FALSE if the keys are integers.
+ *  @return the sorted array.
+ *  @exception RANGE_ERROR The arrays 'arr1' and 'keys' have different sizes.
+ *  @exception MEMORY_ERROR Not enough memory for the temporary arrays.
+ */
+static rtlArrayType rtl_sort_by_keys (rtlArrayType arr1,
+    const const_rtlArrayType keys, boolType striKeys)
+
+  {
+    memSizeType size;
+    memSizeType *order;
+    memSizeType start;
+    memSizeType pos;
+    memSizeType next;
+    genericType element;
+
+  /* rtl_sort_by_keys */
+    size = arraySize(arr1);
+    if (unlikely(arraySize(keys) != size)) {
+      logError(printf("rtl_sort_by_keys(arr1 (size=" FMT_U_MEM "), "
+                      "keys (size=" FMT_U_MEM "), %d): "
+                      "Number of keys and elements differ.\n",
+                      size, arraySize(keys), striKeys););
+      raise_error(RANGE_ERROR);
+    } else if (size > 1) {
+      order = arrKeyOrder(keys, striKeys);
+      if (unlikely(order == NULL)) {
+        raise_error(MEMORY_ERROR);
+      } else {
+        for (start = 0; start < size; start++) {
+          if (order[start] != start) {
+            element = arr1->arr[start].value.genericValue;
+            pos = start;
+            while (order[pos] != start) {
+              next = order[pos];
+              arr1->arr[pos].value.genericValue = arr1->arr[next].value.genericValue;
+              order[pos] = pos;
+              pos = next;
+            } /* while */
+            arr1->arr[pos].value.genericValue = element;
+            order[pos] = pos;
+          } /* if */
+        } /* for */
+        FREE_TABLE(order, memSizeType, size);
+      } /* if */
+    } /* if */
+    return arr1;
+  } /* rtl_sort_by_keys */
 
 
 
@@ -563,6 +1424,94 @@ void freeRtlStriArray (rtlArrayType work_array, intType used_max_position)
 
 
 
+/**
+ *  Enlarge the capacity of an array.
+ *  This function is called from the macro GROW_RTL_ARRAY, if the
+ *  capacity of an array is not sufficient. GrowRtlArray enlarges the
+ *  capacity such that at least 'len' elements fit into it.
+ *  It is assumed that 'arr' will grow further, therefore the
+ *  capacity is usually doubled. This way appending elements
+ *  one by one takes amortized constant time.
+ *  @param arr Array for which the capacity is enlarged.
+ *  @param len Number of elements that must fit into the array.
+ *  @return the enlarged array, or NULL if the allocation failed.
+ */
+rtlArrayType growRtlArray (rtlArrayType arr, memSizeType len)
+
+  {
+    memSizeType newCapacity;
+    rtlArrayType result;
+
+  /* growRtlArray */
+    if (unlikely(len > MAX_RTL_ARR_LEN)) {
+      result = NULL;
+    } else {
+      if (2 * arr->capacity >= len) {
+        newCapacity = 2 * arr->capacity;
+      } else {
+        newCapacity = len;
+      } /* if */
+      if (newCapacity < MIN_GROW_SHRINK_ARRAY_CAPACITY) {
+        newCapacity = MIN_GROW_SHRINK_ARRAY_CAPACITY;
+      } else if (unlikely(newCapacity > MAX_RTL_ARR_LEN)) {
+        newCapacity = MAX_RTL_ARR_LEN;
+      } /* if */
+      result = REALLOC_HEAP(arr, rtlArrayType, SIZ_RTL_ARR(newCapacity));
+      if (unlikely(result == NULL)) {
+        do {
+          newCapacity = (newCapacity + len) / 2;
+          result = REALLOC_HEAP(arr, rtlArrayType, SIZ_RTL_ARR(newCapacity));
+        } while (result == NULL && newCapacity != len);
+      } /* if */
+      if (likely(result != NULL)) {
+        COUNT3_RTL_ARRAY(result->capacity, newCapacity);
+        result->capacity = newCapacity;
+      } else {
+        logError(printf("growRtlArray(" FMT_X_MEM " (capacity=" FMT_U_MEM "), "
+                        FMT_U_MEM ") failed\n",
+                        (memSizeType) arr, arr->capacity, len););
+      } /* if */
+    } /* if */
+    logFunction(printf("growRtlArray --> " FMT_X_MEM "\n", (memSizeType) result);
+                fflush(stdout););
+    return result;
+  } /* growRtlArray */
+
+
+
+/**
+ *  Reduce the capacity of an array.
+ *  This function is called from the macro SHRINK_RTL_ARRAY, if the
+ *  capacity of an array is much too large. ShrinkRtlArray reduces the
+ *  capacity, but it leaves room, such that it can grow again.
+ *  @param arr Array for which the capacity is reduced.
+ *  @param len Number of elements that must fit into the array.
+ *  @return the reduced array.
+ */
+rtlArrayType shrinkRtlArray (rtlArrayType arr, memSizeType len)
+
+  {
+    memSizeType newCapacity;
+    rtlArrayType result;
+
+  /* shrinkRtlArray */
+    newCapacity = 2 * len;
+    if (newCapacity < MIN_GROW_SHRINK_ARRAY_CAPACITY) {
+      newCapacity = MIN_GROW_SHRINK_ARRAY_CAPACITY;
+    } /* if */
+    result = REALLOC_HEAP(arr, rtlArrayType, SIZ_RTL_ARR(newCapacity));
+    if (unlikely(result == NULL)) {
+      /* Keeping the larger capacity is not an error. */
+      result = arr;
+    } else {
+      COUNT3_RTL_ARRAY(result->capacity, newCapacity);
+      result->capacity = newCapacity;
+    } /* if */
+    return result;
+  } /* shrinkRtlArray */
+
+
+
 /**
  *  Fill an array of 'len' objects with the generic value 'element'.
  *  This function uses loop unrolling inspired by Duff's device.
@@ -647,11 +1596,10 @@ void arrAppend (rtlArrayType *const arr_variable, const rtlArrayType extension)
         raise_error(MEMORY_ERROR);
       } else {
         new_size = arr_to_size + extension_size;
-        arr_to = REALLOC_RTL_ARRAY(arr_to, arr_to_size, new_size);
+        GROW_RTL_ARRAY(arr_to, arr_to, new_size);
         if (unlikely(arr_to == NULL)) {
           raise_error(MEMORY_ERROR);
         } else {
-          COUNT3_RTL_ARRAY(arr_to_size, new_size);
           *arr_variable = arr_to;
           arr_to->max_position = arrayMaxPos(arr_to->min_position, new_size);
           memcpy(&arr_to->arr[arr_to_size], extension->arr,
@@ -755,11 +1703,10 @@ rtlArrayType arrCat (rtlArrayType arr1, const rtlArrayType arr2)
       result = NULL;
     } else {
       result_size = arr1_size + arr2_size;
-      result = REALLOC_RTL_ARRAY(arr1, arr1_size, result_size);
+      GROW_RTL_ARRAY(result, arr1, result_size);
       if (unlikely(result == NULL)) {
         raise_error(MEMORY_ERROR);
       } else {
-        COUNT3_RTL_ARRAY(arr1_size, result_size);
         result->max_position = arrayMaxPos(result->min_position, result_size);
         memcpy(&result->arr[arr1_size], arr2->arr, arr2_size * sizeof(rtlObjectType));
         FREE_RTL_ARRAY(arr2, arr2_size);
@@ -791,11 +1738,10 @@ rtlArrayType arrExtend (rtlArrayType arr1, const genericType element)
       result = NULL;
     } else {
       result_size = arr1_size + 1;
-      result = REALLOC_RTL_ARRAY(arr1, arr1_size, result_size);
+      GROW_RTL_ARRAY(result, arr1, result_size);
       if (unlikely(result == NULL)) {
         raise_error(MEMORY_ERROR);
       } else {
-        COUNT3_RTL_ARRAY(arr1_size, result_size);
         result->max_position++;
         result->arr[arr1_size].value.genericValue = element;
       } /* if */
@@ -815,12 +1761,8 @@ rtlArrayType arrExtend (rtlArrayType arr1, const genericType element)
  */
 void arrFree (rtlArrayType oldArray)
 
-  {
-    memSizeType size;
-
-  /* arrFree */
-    size = arraySize(oldArray);
-    FREE_RTL_ARRAY(oldArray, size);
+  { /* arrFree */
+    FREE_RTL_ARRAY(oldArray, arraySize(oldArray));
   } /* arrFree */
 
 
@@ -939,12 +1881,11 @@ rtlArrayType arrHeadTemp (rtlArrayType *arr_temp, intType stop)
           new_arr1->max_position = arr1->max_position;
           memcpy(new_arr1->arr, &arr1->arr[result_size],
                  (size_t) ((arr1_size - result_size) * sizeof(rtlObjectType)));
-          result = REALLOC_RTL_ARRAY(arr1, arr1_size, result_size);
+          SHRINK_RTL_ARRAY(result, arr1, result_size);
           if (unlikely(result == NULL)) {
             FREE_RTL_ARRAY(new_arr1, arr1_size - result_size);
             raise_error(MEMORY_ERROR);
           } else {
-            COUNT3_RTL_ARRAY(arr1_size, result_size);
             result->max_position = stop;
             *arr_temp = new_arr1;
           } /* if */
@@ -1008,14 +1949,9 @@ genericType arrIdxTemp (rtlArrayType *arr_temp, intType position)
         arr1->arr[position - arr1->min_position].value.genericValue =
             arr1->arr[arr1_size - 1].value.genericValue;
       } /* if */
-      resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, arr1_size - 1);
-      if (unlikely(resized_arr1 == NULL)) {
-        raise_error(MEMORY_ERROR);
-      } else {
-        COUNT3_RTL_ARRAY(arr1_size, arr1_size - 1);
-        resized_arr1->max_position--;
-        *arr_temp = resized_arr1;
-      } /* if */
+      SHRINK_RTL_ARRAY(resized_arr1, arr1, arr1_size - 1);
+      resized_arr1->max_position--;
+      *arr_temp = resized_arr1;
     } /* if */
     return result;
   } /* arrIdxTemp */
@@ -1048,12 +1984,11 @@ void arrInsert (rtlArrayType *arr_to, intType position, genericType element)
       raise_error(INDEX_ERROR);
     } else {
       arr1_size = arraySize(arr1);
-      resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, arr1_size + 1);
+      GROW_RTL_ARRAY(resized_arr1, arr1, arr1_size + 1);
       if (unlikely(resized_arr1 == NULL)) {
         raise_error(MEMORY_ERROR);
       } else {
         arr1 = resized_arr1;
-        COUNT3_RTL_ARRAY(arr1_size, arr1_size + 1);
         array_pointer = arr1->arr;
         memmove(&array_pointer[position - arr1->min_position + 1],
             &array_pointer[position - arr1->min_position],
@@ -1101,11 +2036,10 @@ void arrInsertArray (rtlArrayType *arr_to, intType position,
           raise_error(MEMORY_ERROR);
         } else {
           new_size = arr1_size + elements_size;
-          resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, new_size);
+          GROW_RTL_ARRAY(resized_arr1, arr1, new_size);
           if (unlikely(resized_arr1 == NULL)) {
             raise_error(MEMORY_ERROR);
           } else {
-            COUNT3_RTL_ARRAY(arr1_size, new_size);
             *arr_to = resized_arr1;
             array_pointer = resized_arr1->arr;
             memmove(&array_pointer[arrayIndex(resized_arr1, position) + elements_size],
@@ -1135,6 +2069,61 @@ void arrInsertArray (rtlArrayType *arr_to, intType position,
 
 
 
+/**
+ *  Determine the order of elements sorted by their keys.
+ *  Every key is paired with the index of its element. The pairs are
+ *  sorted stable by the keys. Integer keys are sorted with a radix
+ *  sort and string keys with a merge sort.
+ *  @param keys Array with the keys of the elements.
+ *  @param striKeys TRUE if the keys are strings, or
+ *         FALSE if the keys are integers.
+ *  @return an array with the original indices (starting with 0) of
+ *          the elements in sorted order, or NULL if there was not
+ *          enough memory. It must be freed with FREE_TABLE(order,
+ *          memSizeType, arraySize(keys)).
+ */
+memSizeType *arrKeyOrder (const const_rtlArrayType keys, boolType striKeys)
+
+  {
+    memSizeType size;
+    sortKeyType keyType;
+    keyIndexRecord *records;
+    keyIndexRecord *buffer;
+    memSizeType pos;
+    memSizeType *order = NULL;
+
+  /* arrKeyOrder */
+    size = arraySize(keys);
+    keyType = striKeys ? STRI_SORT_KEYS : INT_SORT_KEYS;
+    if (ALLOC_TABLE(records, keyIndexRecord, size)) {
+      if (ALLOC_TABLE(buffer, keyIndexRecord, size)) {
+        if (ALLOC_TABLE(order, memSizeType, size)) {
+          for (pos = 0; pos < size; pos++) {
+            records[pos].key.value.genericValue = keys->arr[pos].value.genericValue;
+            records[pos].index = pos;
+          } /* for */
+#if INTTYPE_SIZE == GENERIC_SIZE
+          if (keyType == INT_SORT_KEYS && size >= RADIX_SORT_LIMIT) {
+            rtl_key_radix_sort(records, size, buffer);
+          } else {
+            rtl_key_merge_sort(records, size, buffer, keyType);
+          } /* if */
+#else
+          rtl_key_merge_sort(records, size, buffer, keyType);
+#endif
+          for (pos = 0; pos < size; pos++) {
+            order[pos] = records[pos].index;
+          } /* for */
+        } /* if */
+        FREE_TABLE(buffer, keyIndexRecord, size);
+      } /* if */
+      FREE_TABLE(records, keyIndexRecord, size);
+    } /* if */
+    return order;
+  } /* arrKeyOrder */
+
+
+
 /**
  *  Allocate memory for an array with given min and max positions.
  *  The min and max positions of the created array are set.
@@ -1198,11 +2187,10 @@ void arrPush (rtlArrayType *const arr_variable, const genericType element)
       raise_error(MEMORY_ERROR);
     } else {
       new_size = arr_to_size + 1;
-      arr_to = REALLOC_RTL_ARRAY(arr_to, arr_to_size, new_size);
+      GROW_RTL_ARRAY(arr_to, arr_to, new_size);
       if (unlikely(arr_to == NULL)) {
         raise_error(MEMORY_ERROR);
       } else {
-        COUNT3_RTL_ARRAY(arr_to_size, new_size);
         *arr_variable = arr_to;
         arr_to->max_position ++;
         arr_to->arr[arr_to_size].value.genericValue = element;
@@ -1315,7 +2303,7 @@ rtlArrayType arrRangeTemp (rtlArrayType *arr_temp, intType start, intType stop)
                  (size_t) (result_size * sizeof(rtlObjectType)));
           memmove(&arr1->arr[start_idx], &arr1->arr[stop_idx + 1],
                   (size_t) ((arr1_size - stop_idx - 1) * sizeof(rtlObjectType)));
-          resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, arr1_size - result_size);
+          SHRINK_RTL_ARRAY(resized_arr1, arr1, arr1_size - result_size);
           if (unlikely(resized_arr1 == NULL)) {
             memcpy(&arr1->arr[arr1_size - result_size], result->arr,
                    (size_t) (result_size * sizeof(rtlObjectType)));
@@ -1323,7 +2311,6 @@ rtlArrayType arrRangeTemp (rtlArrayType *arr_temp, intType start, intType stop)
             raise_error(MEMORY_ERROR);
             result = NULL;
           } else {
-            COUNT3_RTL_ARRAY(arr1_size, arr1_size - result_size);
             resized_arr1->max_position = arrayMaxPos(resized_arr1->min_position,
                                                      arr1_size - result_size);
             *arr_temp = resized_arr1;
@@ -1366,14 +2353,13 @@ rtlArrayType arrRealloc (rtlArrayType arr, memSizeType oldSize, memSizeType newS
     rtlArrayType resized_arr;
 
   /* arrRealloc */
-    resized_arr = REALLOC_RTL_ARRAY(arr, oldSize, newSize);
-    if (unlikely(resized_arr == NULL)) {
-      if (oldSize >= newSize) {
-        resized_arr = arr;
+    if (newSize > oldSize) {
+      GROW_RTL_ARRAY(resized_arr, arr, newSize);
+      if (unlikely(resized_arr == NULL)) {
+        raise_error(MEMORY_ERROR);
       } /* if */
-      raise_error(MEMORY_ERROR);
     } else {
-      COUNT3_RTL_ARRAY(oldSize, newSize);
+      SHRINK_RTL_ARRAY(resized_arr, arr, newSize);
     } /* if */
     return resized_arr;
   } /* arrRealloc */
@@ -1390,7 +2376,6 @@ genericType arrRemove (rtlArrayType *arr_to, intType position)
 
   {
     rtlArrayType arr1;
-    rtlArrayType resized_arr1;
     rtlObjectType *array_pointer;
     memSizeType arr1_size;
     genericType result;
@@ -1413,24 +2398,9 @@ genericType arrRemove (rtlArrayType *arr_to, intType position)
           &array_pointer[position - arr1->min_position + 1],
           (arraySize2(position, arr1->max_position) - 1) * sizeof(rtlObjectType));
       arr1_size = arraySize(arr1);
-      resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, arr1_size - 1);
-      if (unlikely(resized_arr1 == NULL)) {
-        /* A realloc, which shrinks memory, usually succeeds. */
-        /* The probability that this code path is executed is */
-        /* probably zero. The code below restores the old     */
-        /* value of arr1.                                     */
-        memmove(&array_pointer[position - arr1->min_position + 1],
-            &array_pointer[position - arr1->min_position],
-            (arraySize2(position, arr1->max_position) - 1) * sizeof(rtlObjectType));
-        array_pointer[position - arr1->min_position].value.genericValue = result;
-        raise_error(MEMORY_ERROR);
-        result = 0;
-      } else {
-        arr1 = resized_arr1;
-        COUNT3_RTL_ARRAY(arr1_size, arr1_size - 1);
-        arr1->max_position--;
-        *arr_to = arr1;
-      } /* if */
+      SHRINK_RTL_ARRAY(arr1, arr1, arr1_size - 1);
+      arr1->max_position--;
+      *arr_to = arr1;
     } /* if */
     return result;
   } /* arrRemove */
@@ -1493,7 +2463,7 @@ rtlArrayType arrRemoveArray (rtlArrayType *arr_to, intType position, intType len
                 &array_pointer[arrayIndex(arr1, position) + result_size],
                 (arraySize2(position, arr1->max_position) - result_size) * sizeof(rtlObjectType));
         arr1_size = arraySize(arr1);
-        resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, arr1_size - result_size);
+        SHRINK_RTL_ARRAY(resized_arr1, arr1, arr1_size - result_size);
         if (unlikely(resized_arr1 == NULL)) {
           /* A realloc, which shrinks memory, usually succeeds. */
           /* The probability that this code path is executed is */
@@ -1509,7 +2479,6 @@ rtlArrayType arrRemoveArray (rtlArrayType *arr_to, intType position, intType len
           return NULL;
         } else {
           arr1 = resized_arr1;
-          COUNT3_RTL_ARRAY(arr1_size, arr1_size - result_size);
           arr1->max_position = arrayMaxPos(arr1->min_position, arr1_size - result_size);
           *arr_to = arr1;
         } /* if */
@@ -1520,16 +2489,264 @@ rtlArrayType arrRemoveArray (rtlArrayType *arr_to, intType position, intType len
 
 
 
+/**
+ *  Reserve space for at least 'capacity' elements in 'arr_variable'.
+ *  The length of the array is not changed. A 'capacity' that is
+ *  less than the current capacity has no effect.
+ *  @exception RANGE_ERROR The capacity is negative.
+ *  @exception MEMORY_ERROR Not enough memory to reserve the space.
+ */
+void arrReserve (rtlArrayType *const arr_variable, const intType capacity)
+
+  {
+    rtlArrayType arr1;
+    rtlArrayType resized_arr1;
+    memSizeType old_capacity;
+
+  /* arrReserve */
+    logFunction(printf("arrReserve(*, " FMT_D ")\n", capacity););
+    arr1 = *arr_variable;
+    if (unlikely(capacity < 0)) {
+      logError(printf("arrReserve(*, " FMT_D "): "
+                      "Capacity is negative.\n", capacity););
+      raise_error(RANGE_ERROR);
+    } else if ((uintType) capacity > arr1->capacity) {
+      if (unlikely((uintType) capacity > MAX_RTL_ARR_LEN)) {
+        raise_error(MEMORY_ERROR);
+      } else {
+        old_capacity = arr1->capacity;
+        REALLOC_RTL_ARRAY(resized_arr1, arr1, old_capacity,
+                          (memSizeType) capacity);
+        if (unlikely(resized_arr1 == NULL)) {
+          raise_error(MEMORY_ERROR);
+        } else {
+          COUNT3_RTL_ARRAY(old_capacity, (memSizeType) capacity);
+          *arr_variable = resized_arr1;
+        } /* if */
+      } /* if */
+    } /* if */
+  } /* arrReserve */
+
+
+
+/**
+ *  Sort an array with the compare function 'cmp_func'.
+ *  Arrays of integers, floats and chars are sorted with a radix sort.
+ *  Other arrays are sorted with the introsort, which needs
+ *  O(n log n) comparisons also in the worst case. Strings are
+ *  compared without calling 'cmp_func'. The sort is not stable.
+ *  @param arr1 Array to be sorted. It is sorted in place.
+ *  @param cmp_func Pointer to a compare function that gets two values as
+ *         'genericType' and compares them.
+ *  @return the sorted array.
+ */
 rtlArrayType arrSort (rtlArrayType arr1, compareType cmp_func)
 
-  { /* arrSort */
-    /* printf("arrSort(%lX, %ld, %ld)\n", arr1, arr1->min_position, arr1->max_position); */
-    rtl_qsort_array(arr1->arr, &arr1->arr[arr1->max_position - arr1->min_position], cmp_func);
+  {
+    memSizeType size;
+    boolType sorted;
+    unsigned int depth_limit = 0;
+
+  /* arrSort */
+    logFunction(printf("arrSort(" FMT_X_MEM " (size=" FMT_U_MEM "), "
+                       FMT_X_MEM ")\n",
+                       (memSizeType) arr1, arraySize(arr1),
+                       (memSizeType) cmp_func););
+    size = arraySize(arr1);
+    sorted = size <= 1;
+    if (!sorted && size >= RADIX_SORT_LIMIT) {
+#if INTTYPE_SIZE == GENERIC_SIZE
+      if (cmp_func == &intCmpGeneric) {
+        sorted = rtl_radix_sort(arr1->arr, size, INT_SORT_KEYS);
+      } /* if */
+#endif
+#if FLOATTYPE_SIZE == GENERIC_SIZE
+      if (cmp_func == &fltCmpGeneric) {
+        sorted = rtl_radix_sort(arr1->arr, size, FLOAT_SORT_KEYS);
+      } /* if */
+#endif
+      if (cmp_func == &chrCmpGeneric) {
+        sorted = rtl_radix_sort(arr1->arr, size, CHAR_SORT_KEYS);
+      } /* if */
+    } /* if */
+    if (!sorted) {
+      while (size >> depth_limit > 1) {
+        depth_limit++;
+      } /* while */
+      rtl_intro_sort(arr1->arr, &arr1->arr[size - 1], 2 * depth_limit, cmp_func);
+    } /* if */
     return arr1;
   } /* arrSort */
 
 
 
+/**
+ *  Sort an array with the compare function 'cmp_func'.
+ *  The sort is stable. Elements, which are considered equal, keep
+ *  their order. Arrays of integers and chars are sorted with a radix sort.
+ *  Other arrays are sorted with the merge sort.
+ *  @param arr1 Array to be sorted. It is sorted in place.
+ *  @param cmp_func Pointer to a compare function that gets two values as
+ *         'genericType' and compares them.
+ *  @return the sorted array.
+ *  @exception MEMORY_ERROR Not enough memory for the temporary buffer.
+ */
+rtlArrayType arrSortStable (rtlArrayType arr1, compareType cmp_func)
+
+  {
+    memSizeType size;
+    boolType sorted = FALSE;
+    rtlObjectType *buffer;
+
+  /* arrSortStable */
+    logFunction(printf("arrSortStable(" FMT_X_MEM " (size=" FMT_U_MEM "), "
+                       FMT_X_MEM ")\n",
+                       (memSizeType) arr1, arraySize(arr1),
+                       (memSizeType) cmp_func););
+    size = arraySize(arr1);
+    if (size >= RADIX_SORT_LIMIT) {
+#if INTTYPE_SIZE == GENERIC_SIZE
+      if (cmp_func == &intCmpGeneric) {
+        sorted = rtl_radix_sort(arr1->arr, size, INT_SORT_KEYS);
+      } /* if */
+#endif
+      if (cmp_func == &chrCmpGeneric) {
+        sorted = rtl_radix_sort(arr1->arr, size, CHAR_SORT_KEYS);
+      } /* if */
+    } /* if */
+    if (sorted) {
+      /* The radix sort is stable. */
+    } else if (size > INSERTION_SORT_LIMIT) {
+      if (unlikely(!ALLOC_TABLE(buffer, rtlObjectType, size >> 1))) {
+        raise_error(MEMORY_ERROR);
+      } else {
+        rtl_merge_sort(arr1->arr, size, buffer, cmp_func);
+        FREE_TABLE(buffer, rtlObjectType, size >> 1);
+      } /* if */
+    } else if (size > 1) {
+      rtl_insertion_sort(arr1->arr, &arr1->arr[size - 1], cmp_func);
+    } /* if */
+    return arr1;
+  } /* arrSortStable */
+
+
+
+/**
+ *  Sort an array with the compare function 'cmp_func' and several threads.
+ *  Arrays of integers, floats, chars and strings with at least
+ *  PARALLEL_SORT_LIMIT elements are split into 'numThreads' runs,
+ *  which are sorted concurrently and merged afterwards. The result is
+ *  identical to the result of arrSort(). Other arrays and arrays with
+ *  other compare functions are sorted with arrSort(), because
+ *  'cmp_func' might not be thread safe.
+ *  @param arr1 Array to be sorted. It is sorted in place.
+ *  @param cmp_func Pointer to a compare function that gets two values as
+ *         'genericType' and compares them.
+ *  @param numThreads Maximum number of threads used to sort.
+ *  @return the sorted array.
+ *  @exception RANGE_ERROR If 'numThreads' is less than 1.
+ */
+rtlArrayType arrSortParallel (rtlArrayType arr1, compareType cmp_func,
+    intType numThreads)
+
+  {
+#if HAS_PTHREAD
+    memSizeType size;
+    sortKeyType keyType = STRI_SORT_KEYS;
+    boolType threadSafe;
+#endif
+    boolType sorted = FALSE;
+
+  /* arrSortParallel */
+    logFunction(printf("arrSortParallel(" FMT_X_MEM " (size=" FMT_U_MEM "), "
+                       FMT_X_MEM ", " FMT_D ")\n",
+                       (memSizeType) arr1, arraySize(arr1),
+                       (memSizeType) cmp_func, numThreads););
+    if (unlikely(numThreads < 1)) {
+      logError(printf("arrSortParallel(" FMT_X_MEM ", " FMT_X_MEM ", " FMT_D "): "
+                      "Number of threads less than 1.\n",
+                      (memSizeType) arr1, (memSizeType) cmp_func, numThreads););
+      raise_error(RANGE_ERROR);
+    } else {
+#if HAS_PTHREAD
+      size = arraySize(arr1);
+      if (numThreads > MAX_SORT_THREADS) {
+        numThreads = MAX_SORT_THREADS;
+      } /* if */
+      if ((memSizeType) numThreads > size / PARALLEL_SORT_CHUNK) {
+        numThreads = (intType) (size / PARALLEL_SORT_CHUNK);
+      } /* if */
+      threadSafe = cmp_func == &strCmpGeneric || cmp_func == &chrCmpGeneric;
+#if INTTYPE_SIZE == GENERIC_SIZE
+      if (cmp_func == &intCmpGeneric) {
+        keyType = INT_SORT_KEYS;
+        threadSafe = TRUE;
+      } /* if */
+#endif
+#if FLOATTYPE_SIZE == GENERIC_SIZE
+      if (cmp_func == &fltCmpGeneric) {
+        keyType = FLOAT_SORT_KEYS;
+        threadSafe = TRUE;
+      } /* if */
+#endif
+      if (cmp_func == &chrCmpGeneric) {
+        keyType = CHAR_SORT_KEYS;
+      } /* if */
+      if (threadSafe && numThreads > 1 && size >= PARALLEL_SORT_LIMIT) {
+        sorted = rtl_parallel_sort(arr1->arr, size, keyType, (int) numThreads);
+      } /* if */
+#endif
+      if (!sorted) {
+        arrSort(arr1, cmp_func);
+      } /* if */
+    } /* if */
+    return arr1;
+  } /* arrSortParallel */
+
+
+
+/**
+ *  Sort an array by integer keys, which have been computed for its elements.
+ *  The sort is stable. Elements with equal keys keep their order.
+ *  @param arr1 Array to be sorted. It is sorted in place.
+ *  @param keys Array with the key of every element of 'arr1'.
+ *  @return the sorted array.
+ *  @exception RANGE_ERROR The arrays 'arr1' and 'keys' have different sizes.
+ *  @exception MEMORY_ERROR Not enough memory for the temporary arrays.
+ */
+rtlArrayType arrSortIntKeys (rtlArrayType arr1, const const_rtlArrayType keys)
+
+  { /* arrSortIntKeys */
+    logFunction(printf("arrSortIntKeys(" FMT_X_MEM " (size=" FMT_U_MEM "), "
+                       FMT_X_MEM " (size=" FMT_U_MEM "))\n",
+                       (memSizeType) arr1, arraySize(arr1),
+                       (memSizeType) keys, arraySize(keys)););
+    return rtl_sort_by_keys(arr1, keys, FALSE);
+  } /* arrSortIntKeys */
+
+
+
+/**
+ *  Sort an array by string keys, which have been computed for its elements.
+ *  The sort is stable. Elements with equal keys keep their order.
+ *  @param arr1 Array to be sorted. It is sorted in place.
+ *  @param keys Array with the key of every element of 'arr1'.
+ *  @return the sorted array.
+ *  @exception RANGE_ERROR The arrays 'arr1' and 'keys' have different sizes.
+ *  @exception MEMORY_ERROR Not enough memory for the temporary arrays.
+ */
+rtlArrayType arrSortStriKeys (rtlArrayType arr1, const const_rtlArrayType keys)
+
+  { /* arrSortStriKeys */
+    logFunction(printf("arrSortStriKeys(" FMT_X_MEM " (size=" FMT_U_MEM "), "
+                       FMT_X_MEM " (size=" FMT_U_MEM "))\n",
+                       (memSizeType) arr1, arraySize(arr1),
+                       (memSizeType) keys, arraySize(keys)););
+    return rtl_sort_by_keys(arr1, keys, TRUE);
+  } /* arrSortStriKeys */
+
+
+
 /**
  *  Get a sub array from the position 'start' with maximum length 'length'.
  *  @return the sub array from position 'start' with maximum length 'length'.
@@ -1632,7 +2849,7 @@ rtlArrayType arrSubarrTemp (rtlArrayType *arr_temp, intType start, intType lengt
                    (size_t) (result_size * sizeof(rtlObjectType)));
             memmove(&arr1->arr[start_idx], &arr1->arr[stop_idx + 1],
                     (size_t) ((arr1_size - stop_idx - 1) * sizeof(rtlObjectType)));
-            resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, arr1_size - result_size);
+            SHRINK_RTL_ARRAY(resized_arr1, arr1, arr1_size - result_size);
             if (unlikely(resized_arr1 == NULL)) {
               memcpy(&arr1->arr[arr1_size - result_size], result->arr,
                      (size_t) (result_size * sizeof(rtlObjectType)));
@@ -1640,7 +2857,6 @@ rtlArrayType arrSubarrTemp (rtlArrayType *arr_temp, intType start, intType lengt
               raise_error(MEMORY_ERROR);
               result = NULL;
             } else {
-              COUNT3_RTL_ARRAY(arr1_size, arr1_size - result_size);
               resized_arr1->max_position = arrayMaxPos(resized_arr1->min_position,
                                                        arr1_size - result_size);
               *arr_temp = resized_arr1;
@@ -1761,13 +2977,12 @@ rtlArrayType arrTailTemp (rtlArrayType *arr_temp, intType start)
         start_idx = arrayIndex(arr1, start);
         memcpy(result->arr, &arr1->arr[start_idx],
                (size_t) (result_size * sizeof(rtlObjectType)));
-        resized_arr1 = REALLOC_RTL_ARRAY(arr1, arr1_size, arr1_size - result_size);
+        SHRINK_RTL_ARRAY(resized_arr1, arr1, arr1_size - result_size);
         if (unlikely(resized_arr1 == NULL)) {
           FREE_RTL_ARRAY(result, result_size);
           raise_error(MEMORY_ERROR);
           result = NULL;
         } else {
-          COUNT3_RTL_ARRAY(arr1_size, arr1_size - result_size);
           resized_arr1->max_position = start - 1;
           *arr_temp = resized_arr1;
         } /* if */
@@ -38,6 +38,8 @@ rtlArrayType getArgv (const int argc, const cstriType *const argv,
 #endif
 striType examineSearchPath (const const_striType fileName);
 void freeRtlStriArray (rtlArrayType work_array, intType used_max_position);
+rtlArrayType growRtlArray (rtlArrayType arr, memSizeType len);
+rtlArrayType shrinkRtlArray (rtlArrayType arr, memSizeType len);
 void arrAppend (rtlArrayType *const arr_variable, const rtlArrayType arr_from);
 rtlArrayType arrArrlit2 (intType start_position, rtlArrayType arr1);
 rtlArrayType arrBaselit (const genericType element);
@@ -51,6 +53,7 @@ rtlArrayType arrHeadTemp (rtlArrayType *arr_temp, intType stop);
 genericType arrIdxTemp (rtlArrayType *arr_temp, intType pos);
 void arrInsert (rtlArrayType *arr_to, intType position, genericType element);
 void arrInsertArray (rtlArrayType *arr_to, intType position, rtlArrayType elements);
+memSizeType *arrKeyOrder (const const_rtlArrayType keys, boolType striKeys);
 rtlArrayType arrMalloc (intType min_position, intType max_position);
 void arrPush (rtlArrayType *const arr_variable, const genericType element);
 rtlArrayType arrRange (const const_rtlArrayType arr1, intType start, intType stop);
@@ -58,7 +61,13 @@ rtlArrayType arrRangeTemp (rtlArrayType *arr_temp, intType start, intType stop);
 rtlArrayType arrRealloc (rtlArrayType arr, memSizeType oldSize, memSizeType newSize);
 genericType arrRemove (rtlArrayType *arr_to, intType position);
 rtlArrayType arrRemoveArray (rtlArrayType *arr_to, intType position, intType length);
+void arrReserve (rtlArrayType *const arr_variable, const intType capacity);
 rtlArrayType arrSort (rtlArrayType arr1, compareType cmp_func);
+rtlArrayType arrSortStable (rtlArrayType arr1, compareType cmp_func);
+rtlArrayType arrSortParallel (rtlArrayType arr1, compareType cmp_func,
+    intType numThreads);
+rtlArrayType arrSortIntKeys (rtlArrayType arr1, const const_rtlArrayType keys);
+rtlArrayType arrSortStriKeys (rtlArrayType arr1, const const_rtlArrayType keys);
 rtlArrayType arrSubarr (const const_rtlArrayType arr1, intType start, intType len);
 rtlArrayType arrSubarrTemp (rtlArrayType *arr_temp, intType start, intType len);
 rtlArrayType arrTail (const const_rtlArrayType arr1, intType start);
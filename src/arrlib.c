@@ -36,6 +36,7 @@
 
 #include "common.h"
 #include "data.h"
+#include "data_rtl.h"
 #include "heaputl.h"
 #include "flistutl.h"
 #include "syvarutl.h"
@@ -43,26 +44,170 @@
 #include "executl.h"
 #include "objutl.h"
 #include "runerr.h"
+#include "arrutl.h"
+#include "intlib.h"
+#include "chrlib.h"
+#include "fltlib.h"
+#include "strlib.h"
+#include "flt_rtl.h"
+#include "str_rtl.h"
+#include "arr_rtl.h"
 
 #undef EXTERN
 #define EXTERN
 #include "arrlib.h"
 
 
-#define QSORT_LIMIT 8
+#define INSERTION_SORT_LIMIT 16
+
+intType intCmpGeneric (const genericType value1, const genericType value2);
+intType fltCmpGeneric (const genericType value1, const genericType value2);
+intType chrCmpGeneric (const genericType value1, const genericType value2);
+intType strCmpGeneric (const genericType value1, const genericType value2);
+
+
+
+/**
+ *  Compare two array elements.
+ *  If 'cmp_action' is the action of the integer, float or string
+ *  compare function the elements are compared directly. Otherwise
+ *  the function 'cmp_func' is called.
+ *  @param cmp_func Object describing the compare function to be used.
+ *  @param cmp_action Action of 'cmp_func' or NULL if 'cmp_func'
+ *         is not an action.
+ *  @return -1, 0 or 1 if the first argument is considered to be
+ *          respectively less than, equal to, or greater than the
+ *          second.
+ */
+static inline intType compare_elements (objectType elem1, objectType elem2,
+    objectType cmp_func, actType cmp_action)
+
+  {
+    objectType cmp_obj;
+    intType cmp;
+
+  /* compare_elements */
+    if (cmp_action == &int_cmp) {
+      cmp = elem1->value.intValue < elem2->value.intValue ? -1 :
+            elem1->value.intValue > elem2->value.intValue;
+    } else if (cmp_action == &str_cmp) {
+      cmp = strCompare(elem1->value.striValue, elem2->value.striValue);
+    } else if (cmp_action == &flt_cmp) {
+      cmp = fltCmp(elem1->value.floatValue, elem2->value.floatValue);
+    } else {
+      cmp_obj = param3_call(cmp_func, elem1, elem2, cmp_func);
+      isit_int2(cmp_obj);
+      cmp = take_int(cmp_obj);
+      FREE_OBJECT(cmp_obj);
+    } /* if */
+    return cmp;
+  } /* compare_elements */
+
+
+
+/**
+ *  Sort an array of 'objectRecord' elements with the insertion sort algorithm.
+ *  The insertion sort is stable. Elements, which are considered equal,
+ *  keep their order.
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param end_sort Pointer to the last element to be sorted.
+ *  @param cmp_func Object describing the compare function to be used.
+ *  @param cmp_action Action of 'cmp_func' or NULL.
+ */
+static void insertion_sort_array (objectType begin_sort, objectType end_sort,
+    objectType cmp_func, actType cmp_action)
+
+  {
+    objectRecord compare_elem;
+    objectType middle_elem;
+    objectType insert_elem;
+
+  /* insertion_sort_array */
+    for (middle_elem = begin_sort + 1; middle_elem <= end_sort; middle_elem++) {
+      memcpy(&compare_elem, middle_elem, sizeof(objectRecord));
+      insert_elem = middle_elem;
+      while (insert_elem != begin_sort &&
+             compare_elements(&insert_elem[-1], &compare_elem,
+                              cmp_func, cmp_action) > 0) {
+        memcpy(insert_elem, &insert_elem[-1], sizeof(objectRecord));
+        insert_elem--;
+      } /* while */
+      memcpy(insert_elem, &compare_elem, sizeof(objectRecord));
+    } /* for */
+  } /* insertion_sort_array */
+
+
+
+/**
+ *  Sort an array of 'objectRecord' elements with the heapsort algorithm.
+ *  The heapsort is used by intro_sort_array() to guarantee O(n log n).
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param size Number of elements to be sorted.
+ *  @param cmp_func Object describing the compare function to be used.
+ *  @param cmp_action Action of 'cmp_func' or NULL.
+ */
+static void heap_sort_array (objectType begin_sort, memSizeType size,
+    objectType cmp_func, actType cmp_action)
+
+  {
+    memSizeType start;
+    memSizeType heap_size;
+    memSizeType pos;
+    memSizeType child;
+    objectRecord sift_elem;
+
+  /* heap_sort_array */
+    start = size >> 1;
+    heap_size = size;
+    while (heap_size > 1) {
+      if (start != 0) {
+        /* Build the heap. */
+        start--;
+        memcpy(&sift_elem, &begin_sort[start], sizeof(objectRecord));
+        pos = start;
+      } else {
+        /* Move the biggest element behind the heap. */
+        heap_size--;
+        memcpy(&sift_elem, &begin_sort[heap_size], sizeof(objectRecord));
+        memcpy(&begin_sort[heap_size], begin_sort, sizeof(objectRecord));
+        pos = 0;
+      } /* if */
+      child = 2 * pos + 1;
+      while (child < heap_size) {
+        if (child + 1 < heap_size &&
+            compare_elements(&begin_sort[child], &begin_sort[child + 1],
+                             cmp_func, cmp_action) < 0) {
+          child++;
+        } /* if */
+        if (compare_elements(&sift_elem, &begin_sort[child],
+                             cmp_func, cmp_action) < 0) {
+          memcpy(&begin_sort[pos], &begin_sort[child], sizeof(objectRecord));
+          pos = child;
+          child = 2 * pos + 1;
+        } else {
+          child = heap_size;
+        } /* if */
+      } /* while */
+      memcpy(&begin_sort[pos], &sift_elem, sizeof(objectRecord));
+    } /* while */
+  } /* heap_sort_array */
 
 
 
 /**
- *  Sort an array of 'objectRecord' elements with the quicksort algorithm.
- *  In contrast to qsort() this function uses a different compare function.
- *  The compare function of qsort() has two void pointers as parameters.
+ *  Sort an array of 'objectRecord' elements with the introsort algorithm.
+ *  Introsort is a quicksort with a median of three pivot. If the recursion
+ *  gets deeper than 'depth_limit' the heapsort is used instead. This
+ *  guarantees O(n log n) also for inputs that are bad for the quicksort.
+ *  Small ranges are sorted with the insertion sort.
  *  @param begin_sort Pointer to first element to be sorted.
  *  @param end_sort Pointer to the last element to be sorted.
+ *  @param depth_limit Number of partition steps before the heapsort is used.
  *  @param cmp_func Object describing the compare function to be used.
+ *  @param cmp_action Action of 'cmp_func' or NULL.
  */
-static void qsort_array (objectType begin_sort, objectType end_sort,
-    objectType cmp_func)
+static void intro_sort_array (objectType begin_sort, objectType end_sort,
+    unsigned int depth_limit, objectType cmp_func, actType cmp_action)
 
   {
     objectRecord compare_elem;
@@ -70,59 +215,226 @@ static void qsort_array (objectType begin_sort, objectType end_sort,
     objectType middle_elem;
     objectType less_elem;
     objectType greater_elem;
-    objectType cmp_obj;
-    intType cmp;
 
-  /* qsort_array */
-    if (end_sort - begin_sort < QSORT_LIMIT) {
-      /* Use insertion sort */
-      for (middle_elem = begin_sort + 1; middle_elem <= end_sort; middle_elem++) {
+  /* intro_sort_array */
+    while (end_sort - begin_sort >= INSERTION_SORT_LIMIT) {
+      if (depth_limit == 0) {
+        heap_sort_array(begin_sort, (memSizeType) (end_sort - begin_sort) + 1,
+                        cmp_func, cmp_action);
+        end_sort = begin_sort;
+      } else {
+        depth_limit--;
+        /* Order the first, the middle and the last element. */
+        middle_elem = &begin_sort[(memSizeType) (end_sort - begin_sort) >> 1];
+        if (compare_elements(middle_elem, begin_sort, cmp_func, cmp_action) < 0) {
+          memcpy(&help_element, middle_elem, sizeof(objectRecord));
+          memcpy(middle_elem, begin_sort, sizeof(objectRecord));
+          memcpy(begin_sort, &help_element, sizeof(objectRecord));
+        } /* if */
+        if (compare_elements(end_sort, middle_elem, cmp_func, cmp_action) < 0) {
+          memcpy(&help_element, end_sort, sizeof(objectRecord));
+          memcpy(end_sort, middle_elem, sizeof(objectRecord));
+          memcpy(middle_elem, &help_element, sizeof(objectRecord));
+          if (compare_elements(middle_elem, begin_sort, cmp_func, cmp_action) < 0) {
+            memcpy(&help_element, middle_elem, sizeof(objectRecord));
+            memcpy(middle_elem, begin_sort, sizeof(objectRecord));
+            memcpy(begin_sort, &help_element, sizeof(objectRecord));
+          } /* if */
+        } /* if */
+        /* The first and the last element act as sentinels. */
         memcpy(&compare_elem, middle_elem, sizeof(objectRecord));
-        less_elem = begin_sort - 1;
+        less_elem = begin_sort;
+        greater_elem = end_sort;
         do {
-          less_elem++;
-          cmp_obj = param3_call(cmp_func, less_elem, &compare_elem, cmp_func);
-          isit_int2(cmp_obj);
-          cmp = take_int(cmp_obj);
-          FREE_OBJECT(cmp_obj);
-        } while (cmp < 0);
-        memmove(&less_elem[1], less_elem,
-                (memSizeType) (middle_elem - less_elem) * sizeof(objectRecord));
-        memcpy(less_elem, &compare_elem, sizeof(objectRecord));
+          do {
+            less_elem++;
+          } while (compare_elements(less_elem, &compare_elem,
+                                    cmp_func, cmp_action) < 0);
+          do {
+            greater_elem--;
+          } while (compare_elements(greater_elem, &compare_elem,
+                                    cmp_func, cmp_action) > 0);
+          if (less_elem < greater_elem) {
+            memcpy(&help_element, less_elem, sizeof(objectRecord));
+            memcpy(less_elem, greater_elem, sizeof(objectRecord));
+            memcpy(greater_elem, &help_element, sizeof(objectRecord));
+          } /* if */
+        } while (less_elem < greater_elem);
+        if (less_elem - begin_sort < end_sort - greater_elem) {
+          intro_sort_array(begin_sort, less_elem - 1, depth_limit,
+                           cmp_func, cmp_action);
+          begin_sort = greater_elem + 1;
+        } else {
+          intro_sort_array(greater_elem + 1, end_sort, depth_limit,
+                           cmp_func, cmp_action);
+          end_sort = less_elem - 1;
+        } /* if */
+      } /* if */
+    } /* while */
+    if (end_sort > begin_sort) {
+      insertion_sort_array(begin_sort, end_sort, cmp_func, cmp_action);
+    } /* if */
+  } /* intro_sort_array */
+
+
+
+/**
+ *  Sort an array of 'objectRecord' elements with the merge sort algorithm.
+ *  The merge sort is stable. Elements, which are considered equal,
+ *  keep their order.
+ *  @param begin_sort Pointer to first element to be sorted.
+ *  @param size Number of elements to be sorted.
+ *  @param buffer Temporary storage for at least size / 2 elements.
+ *  @param cmp_func Object describing the compare function to be used.
+ *  @param cmp_action Action of 'cmp_func' or NULL.
+ */
+static void merge_sort_array (objectType begin_sort, memSizeType size,
+    objectType buffer, objectType cmp_func, actType cmp_action)
+
+  {
+    memSizeType half;
+    objectType left_elem;
+    objectType left_beyond;
+    objectType right_elem;
+    objectType right_beyond;
+    objectType dest_elem;
+
+  /* merge_sort_array */
+    if (size <= INSERTION_SORT_LIMIT) {
+      if (size > 1) {
+        insertion_sort_array(begin_sort, &begin_sort[size - 1],
+                             cmp_func, cmp_action);
+      } /* if */
+    } else {
+      half = size >> 1;
+      merge_sort_array(begin_sort, half, buffer, cmp_func, cmp_action);
+      merge_sort_array(&begin_sort[half], size - half, buffer,
+                       cmp_func, cmp_action);
+      if (compare_elements(&begin_sort[half - 1], &begin_sort[half],
+                           cmp_func, cmp_action) > 0) {
+        memcpy(buffer, begin_sort, half * sizeof(objectRecord));
+        left_elem = buffer;
+        left_beyond = &buffer[half];
+        right_elem = &begin_sort[half];
+        right_beyond = &begin_sort[size];
+        dest_elem = begin_sort;
+        while (left_elem != left_beyond && right_elem != right_beyond) {
+          /* Take the left element if both are equal. This keeps it stable. */
+          if (compare_elements(right_elem, left_elem, cmp_func, cmp_action) < 0) {
+            memcpy(dest_elem, right_elem, sizeof(objectRecord));
+            right_elem++;
+          } else {
+            memcpy(dest_elem, left_elem, sizeof(objectRecord));
+            left_elem++;
+          } /* if */
+          dest_elem++;
+        } /* while */
+        /* Remaining right elements are already at their place. */
+        memcpy(dest_elem, left_elem,
+               (memSizeType) (left_beyond - left_elem) * sizeof(objectRecord));
+      } /* if */
+    } /* if */
+  } /* merge_sort_array */
+
+
+
+/**
+ *  Sort an array by keys, which have been computed for its elements.
+ *  The keys are copied to a temporary array and arrKeyOrder()
+ *  determines the order. Afterwards the elements are permuted in
+ *  place along the cycles of the order.
+ *  @param arguments Arguments of the primitive action, which are
+ *         the array and the array of keys.
+ *  @param striKeys TRUE if the keys are strings, or
+ *         FALSE if the keys are integers.
+ *  @return the sorted array.
+ */
+static objectType sort_by_keys (listType arguments, boolType striKeys)
+
+  {
+    objectType arr_arg;
+    arrayType keys;
+    arrayType arr1;
+    memSizeType result_size;
+    arrayType result;
+    rtlArrayType key_values;
+    memSizeType *order = NULL;
+    memSizeType start;
+    memSizeType pos;
+    memSizeType next;
+    objectRecord element;
+
+  /* sort_by_keys */
+    arr_arg = arg_1(arguments);
+    isit_array(arr_arg);
+    isit_array(arg_2(arguments));
+    keys = take_array(arg_2(arguments));
+    result_size = arraySize(take_array(arr_arg));
+    if (unlikely(arraySize(keys) != result_size)) {
+      logError(printf("sort_by_keys(arr1 (size=" FMT_U_MEM "), "
+                      "keys (size=" FMT_U_MEM "), %d): "
+                      "Number of keys and elements differ.\n",
+                      result_size, arraySize(keys), striKeys););
+      return raise_exception(SYS_RNG_EXCEPTION);
+    } else if (result_size > 1) {
+      if (unlikely(!ALLOC_RTL_ARRAY(key_values, result_size))) {
+        return raise_exception(SYS_MEM_EXCEPTION);
+      } /* if */
+      key_values->min_position = 1;
+      key_values->max_position = (intType) result_size;
+      for (pos = 0; pos < result_size; pos++) {
+        if (striKeys) {
+          key_values->arr[pos].value.striValue = keys->arr[pos].value.striValue;
+        } else {
+          key_values->arr[pos].value.intValue = keys->arr[pos].value.intValue;
+        } /* if */
       } /* for */
+      order = arrKeyOrder(key_values, striKeys);
+      FREE_RTL_ARRAY(key_values, result_size);
+      if (unlikely(order == NULL)) {
+        return raise_exception(SYS_MEM_EXCEPTION);
+      } /* if */
+    } /* if */
+    if (TEMP2_OBJECT(arr_arg)) {
+      result = take_array(arr_arg);
+      arr_arg->value.arrayValue = NULL;
     } else {
-      middle_elem = &begin_sort[(memSizeType) (end_sort - begin_sort) >> 1];
-      memcpy(&compare_elem, middle_elem, sizeof(objectRecord));
-      memcpy(middle_elem, end_sort, sizeof(objectRecord));
-      memcpy(end_sort, &compare_elem, sizeof(objectRecord));
-      less_elem = begin_sort - 1;
-      greater_elem = end_sort;
-      do {
-        do {
-          less_elem++;
-          cmp_obj = param3_call(cmp_func, less_elem, &compare_elem, cmp_func);
-          isit_int2(cmp_obj);
-          cmp = take_int(cmp_obj);
-          FREE_OBJECT(cmp_obj);
-        } while (cmp < 0);
-        do {
-          greater_elem--;
-          cmp_obj = param3_call(cmp_func, greater_elem, &compare_elem, cmp_func);
-          isit_int2(cmp_obj);
-          cmp = take_int(cmp_obj);
-          FREE_OBJECT(cmp_obj);
-        } while (cmp > 0 && greater_elem != begin_sort);
-        memcpy(&help_element, less_elem, sizeof(objectRecord));
-        memcpy(less_elem, greater_elem, sizeof(objectRecord));
-        memcpy(greater_elem, &help_element, sizeof(objectRecord));
-      } while (greater_elem > less_elem);
-      memcpy(greater_elem, less_elem, sizeof(objectRecord));
-      memcpy(less_elem, &compare_elem, sizeof(objectRecord));
-      memcpy(end_sort, &help_element, sizeof(objectRecord));
-      qsort_array(begin_sort, less_elem - 1, cmp_func);
-      qsort_array(less_elem + 1, end_sort, cmp_func);
+      arr1 = take_array(arr_arg);
+      if (unlikely(!ALLOC_ARRAY(result, result_size))) {
+        if (order != NULL) {
+          FREE_TABLE(order, memSizeType, result_size);
+        } /* if */
+        return raise_exception(SYS_MEM_EXCEPTION);
+      } /* if */
+      result->min_position = arr1->min_position;
+      result->max_position = arr1->max_position;
+      if (unlikely(!crea_array(result->arr, arr1->arr, result_size))) {
+        FREE_ARRAY(result, result_size);
+        if (order != NULL) {
+          FREE_TABLE(order, memSizeType, result_size);
+        } /* if */
+        return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
+      } /* if */
+    } /* if */
+    if (order != NULL) {
+      for (start = 0; start < result_size; start++) {
+        if (order[start] != start) {
+          element = result->arr[start];
+          pos = start;
+          while (order[pos] != start) {
+            next = order[pos];
+            result->arr[pos] = result->arr[next];
+            order[pos] = pos;
+            pos = next;
+          } /* while */
+          result->arr[pos] = element;
+          order[pos] = pos;
+        } /* if */
+      } /* for */
+      FREE_TABLE(order, memSizeType, result_size);
     } /* if */
-  } /* qsort_array */
+    return bld_array_temp(result);
+  } /* sort_by_keys */
 
 
 
@@ -158,11 +470,10 @@ objectType arr_append (listType arguments)
         return raise_exception(SYS_MEM_EXCEPTION);
       } else {
         new_size = arr_to_size + extension_size;
-        new_arr = REALLOC_ARRAY(arr_to, arr_to_size, new_size);
+        GROW_ARRAY(new_arr, arr_to, new_size);
         if (unlikely(new_arr == NULL)) {
           return raise_exception(SYS_MEM_EXCEPTION);
         } else {
-          COUNT3_ARRAY(arr_to_size, new_size);
           arr_variable->value.arrayValue = new_arr;
           if (TEMP_OBJECT(arg_3(arguments))) {
             memcpy(&new_arr->arr[arr_to_size], extension->arr,
@@ -173,18 +484,12 @@ objectType arr_append (listType arguments)
           } else {
             /* It is possible that arr_to == extension holds. */
             /* In this case 'extension' must be corrected     */
-            /* after realloc() enlarged 'arr_to'.             */
+            /* after GROW_ARRAY() enlarged 'arr_to'.          */
             if (arr_to == extension) {
               extension = new_arr;
             } /* if */
             if (unlikely(!crea_array(&new_arr->arr[arr_to_size], extension->arr,
                                      extension_size))) {
-              arr_to = REALLOC_ARRAY(new_arr, new_size, arr_to_size);
-              if (unlikely(arr_to == NULL)) {
-                return raise_exception(SYS_MEM_EXCEPTION);
-              } /* if */
-              COUNT3_ARRAY(new_size, arr_to_size);
-              arr_variable->value.arrayValue = arr_to;
               return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
             } else {
               new_arr->max_position = arrayMaxPos(new_arr->min_position, new_size);
@@ -403,12 +708,10 @@ objectType arr_cat (listType arguments)
     } else {
       result_size = arr1_size + arr2_size;
       if (TEMP_OBJECT(arg_1(arguments))) {
-        result = arr1;
-        result = REALLOC_ARRAY(result, arr1_size, result_size);
+        GROW_ARRAY(result, arr1, result_size);
         if (unlikely(result == NULL)) {
           return raise_exception(SYS_MEM_EXCEPTION);
         } /* if */
-        COUNT3_ARRAY(arr1_size, result_size);
         result->max_position = arrayMaxPos(result->min_position, result_size);
         arg_1(arguments)->value.arrayValue = NULL;
       } else {
@@ -650,12 +953,10 @@ objectType arr_extend (listType arguments)
     } else {
       result_size = arr1_size + 1;
       if (TEMP_OBJECT(arg_1(arguments))) {
-        result = arr1;
-        result = REALLOC_ARRAY(result, arr1_size, result_size);
+        GROW_ARRAY(result, arr1, result_size);
         if (unlikely(result == NULL)) {
           return raise_exception(SYS_MEM_EXCEPTION);
         } /* if */
-        COUNT3_ARRAY(arr1_size, result_size);
         result->max_position++;
         arg_1(arguments)->value.arrayValue = NULL;
       } else {
@@ -758,7 +1059,6 @@ objectType arr_head (listType arguments)
     intType stop;
     memSizeType arr1_size;
     memSizeType result_size;
-    arrayType resized_result;
     arrayType result;
 
   /* arr_head */
@@ -776,14 +1076,7 @@ objectType arr_head (listType arguments)
         result = arr1;
         arg_1(arguments)->value.arrayValue = NULL;
         destr_array(&result->arr[result_size], arr1_size - result_size);
-        resized_result = REALLOC_ARRAY(result, arr1_size, result_size);
-        if (unlikely(resized_result == NULL)) {
-          destr_array(result->arr, result_size);
-          FREE_ARRAY(result, arr1_size);
-          return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
-        } /* if */
-        result = resized_result;
-        COUNT3_ARRAY(arr1_size, result_size);
+        SHRINK_ARRAY(result, result, result_size);
         result->max_position = stop;
       } else {
         if (unlikely(!ALLOC_ARRAY(result, result_size))) {
@@ -918,12 +1211,11 @@ objectType arr_insert (listType arguments)
         result = raise_exception(SYS_MEM_EXCEPTION);
       } else {
         arr1_size = arraySize(arr1);
-        resized_arr1 = REALLOC_ARRAY(arr1, arr1_size, arr1_size + 1);
+        GROW_ARRAY(resized_arr1, arr1, arr1_size + 1);
         if (unlikely(resized_arr1 == NULL)) {
           result = raise_exception(SYS_MEM_EXCEPTION);
         } else {
           arr1 = resized_arr1;
-          COUNT3_ARRAY(arr1_size, arr1_size - 1);
           array_pointer = arr1->arr;
           memmove(&array_pointer[position - arr1->min_position + 1],
                   &array_pointer[position - arr1->min_position],
@@ -985,11 +1277,10 @@ objectType arr_insert_array (listType arguments)
         return raise_exception(SYS_MEM_EXCEPTION);
       } else {
         new_size = arr1_size + elements_size;
-        resized_arr1 = REALLOC_ARRAY(arr1, arr1_size, new_size);
+        GROW_ARRAY(resized_arr1, arr1, new_size);
         if (unlikely(resized_arr1 == NULL)) {
           return raise_exception(SYS_MEM_EXCEPTION);
         } else {
-          COUNT3_ARRAY(arr1_size, new_size);
           arr_variable->value.arrayValue = resized_arr1;
           array_pointer = resized_arr1->arr;
           memmove(&array_pointer[arrayIndex(resized_arr1, position) + elements_size],
@@ -1026,12 +1317,6 @@ objectType arr_insert_array (listType arguments)
               memmove(&array_pointer[arrayIndex(resized_arr1, position)],
                       &array_pointer[arrayIndex(resized_arr1, position) + elements_size],
                       arraySize2(position, resized_arr1->max_position) * sizeof(objectRecord));
-              arr1 = REALLOC_ARRAY(resized_arr1, new_size, arr1_size);
-              if (unlikely(arr1 == NULL)) {
-                return raise_exception(SYS_MEM_EXCEPTION);
-              } /* if */
-              COUNT3_ARRAY(new_size, arr1_size);
-              arr_variable->value.arrayValue = arr1;
               return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
             } else {
               resized_arr1->max_position = arrayMaxPos(resized_arr1->min_position, new_size);
@@ -1126,11 +1411,10 @@ objectType arr_push (listType arguments)
       return raise_exception(SYS_MEM_EXCEPTION);
     } else {
       new_size = dest_size + 1;
-      new_arr = REALLOC_ARRAY(dest, dest_size, new_size);
+      GROW_ARRAY(new_arr, dest, new_size);
       if (unlikely(new_arr == NULL)) {
         return raise_exception(SYS_MEM_EXCEPTION);
       } else {
-        COUNT3_ARRAY(dest_size, new_size);
         arr_variable->value.arrayValue = new_arr;
         /* The element type of the result is the type of the 3rd formal parameter */
         result_element_type = curr_exec_object->value.listValue->obj->
@@ -1145,12 +1429,6 @@ objectType arr_push (listType arguments)
         } else {
           if (unlikely(!arr_elem_initialisation(result_element_type,
                                                 &new_arr->arr[dest_size], element))) {
-            dest = REALLOC_ARRAY(new_arr, new_size, dest_size);
-            if (unlikely(dest == NULL)) {
-              return raise_exception(SYS_MEM_EXCEPTION);
-            } /* if */
-            COUNT3_ARRAY(new_size, dest_size);
-            arr_variable->value.arrayValue = dest;
             return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
           } else {
             new_arr->max_position ++;
@@ -1277,7 +1555,7 @@ objectType arr_remove (listType arguments)
                 &array_pointer[position - arr1->min_position + 1],
                 (arraySize2(position, arr1->max_position) - 1) * sizeof(objectRecord));
         arr1_size = arraySize(arr1);
-        resized_arr1 = REALLOC_ARRAY(arr1, arr1_size, arr1_size - 1);
+        SHRINK_ARRAY(resized_arr1, arr1, arr1_size - 1);
         if (unlikely(resized_arr1 == NULL)) {
           /* A realloc, which shrinks memory, usually succeeds. */
           /* The probability that this code path is executed is */
@@ -1291,7 +1569,6 @@ objectType arr_remove (listType arguments)
           result = raise_exception(SYS_MEM_EXCEPTION);
         } else {
           arr1 = resized_arr1;
-          COUNT3_ARRAY(arr1_size, arr1_size - 1);
           arr1->max_position--;
           arg_1(arguments)->value.arrayValue = arr1;
           SET_TEMP_FLAG(result);
@@ -1365,7 +1642,7 @@ objectType arr_remove_array (listType arguments)
                 &array_pointer[arrayIndex(arr1, position) + result_size],
                 (arraySize2(position, arr1->max_position) - result_size) * sizeof(objectRecord));
         arr1_size = arraySize(arr1);
-        resized_arr1 = REALLOC_ARRAY(arr1, arr1_size, arr1_size - result_size);
+        SHRINK_ARRAY(resized_arr1, arr1, arr1_size - result_size);
         if (unlikely(resized_arr1 == NULL)) {
           /* A realloc, which shrinks memory, usually succeeds. */
           /* The probability that this code path is executed is */
@@ -1380,7 +1657,6 @@ objectType arr_remove_array (listType arguments)
           return raise_exception(SYS_MEM_EXCEPTION);
         } else {
           arr1 = resized_arr1;
-          COUNT3_ARRAY(arr1_size, arr1_size - result_size);
           arr1->max_position = arrayMaxPos(arr1->min_position, arr1_size - result_size);
           arg_1(arguments)->value.arrayValue = arr1;
         } /* if */
@@ -1391,14 +1667,71 @@ objectType arr_remove_array (listType arguments)
 
 
 
+/**
+ *  Reserve space for at least 'capacity' elements in 'arr'.
+ *  The length of 'arr' is not changed. A 'capacity' that is
+ *  less than the current capacity has no effect.
+ *  @exception RANGE_ERROR If 'capacity' is negative.
+ *  @exception MEMORY_ERROR Not enough memory to reserve the space.
+ */
+objectType arr_reserve (listType arguments)
+
+  {
+    arrayType arr1;
+    arrayType resized_arr1;
+    intType capacity;
+    memSizeType old_capacity;
+
+  /* arr_reserve */
+    logFunction(printf("arr_reserve\n"););
+    isit_array(arg_1(arguments));
+    isit_int(arg_2(arguments));
+    is_variable(arg_1(arguments));
+    arr1 = take_array(arg_1(arguments));
+    capacity = take_int(arg_2(arguments));
+    if (unlikely(capacity < 0)) {
+      logError(printf("arr_reserve(arr1, " FMT_D "): "
+                      "Capacity is negative.\n", capacity););
+      return raise_exception(SYS_RNG_EXCEPTION);
+    } else if ((uintType) capacity > arr1->capacity) {
+      if (unlikely((uintType) capacity > MAX_ARR_LEN)) {
+        return raise_exception(SYS_MEM_EXCEPTION);
+      } else {
+        old_capacity = arr1->capacity;
+        REALLOC_ARRAY(resized_arr1, arr1, old_capacity,
+                      (memSizeType) capacity);
+        if (unlikely(resized_arr1 == NULL)) {
+          return raise_exception(SYS_MEM_EXCEPTION);
+        } else {
+          COUNT3_ARRAY(old_capacity, (memSizeType) capacity);
+          arg_1(arguments)->value.arrayValue = resized_arr1;
+        } /* if */
+      } /* if */
+    } /* if */
+    return SYS_EMPTY_OBJECT;
+  } /* arr_reserve */
+
+
+
+/**
+ *  Sort an array with the compare function 'dataCompare'.
+ *  The introsort is used. It needs O(n log n) comparisons also in
+ *  the worst case. Integers, floats and strings are compared without
+ *  calling 'dataCompare'. The sort is not stable.
+ *  @param arguments Arguments of the primitive action, which are
+ *         the array and the reference of the 'dataCompare' function.
+ *  @return the sorted array.
+ */
 objectType arr_sort (listType arguments)
 
   {
     objectType arr_arg;
     objectType data_cmp_func;
+    actType cmp_action = NULL;
     arrayType arr1;
     memSizeType result_size;
     arrayType result;
+    unsigned int depth_limit = 0;
 
   /* arr_sort */
     arr_arg = arg_1(arguments);
@@ -1420,14 +1753,239 @@ objectType arr_sort (listType arguments)
         return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
       } /* if */
     } /* if */
-    qsort_array(result->arr,
-        &result->arr[result->max_position - result->min_position],
-        data_cmp_func);
+    if (CATEGORY_OF_OBJ(data_cmp_func) == ACTOBJECT) {
+      cmp_action = take_action(data_cmp_func);
+    } /* if */
+    result_size = arraySize(result);
+    if (result_size > 1) {
+      while (result_size >> depth_limit > 1) {
+        depth_limit++;
+      } /* while */
+      intro_sort_array(result->arr, &result->arr[result_size - 1],
+                       2 * depth_limit, data_cmp_func, cmp_action);
+    } /* if */
     return bld_array_temp(result);
   } /* arr_sort */
 
 
 
+/**
+ *  Sort an array by integer keys, which have been computed for its elements.
+ *  The sort is stable. Elements with equal keys keep their order.
+ *  @param arguments Arguments of the primitive action, which are
+ *         the array and the array with the key of every element.
+ *  @return the sorted array.
+ *  @exception RANGE_ERROR The array and the keys have different sizes.
+ */
+objectType arr_sort_int_keys (listType arguments)
+
+  { /* arr_sort_int_keys */
+    return sort_by_keys(arguments, FALSE);
+  } /* arr_sort_int_keys */
+
+
+
+/**
+ *  Sort an array with the compare function 'dataCompare'.
+ *  The merge sort is used. The sort is stable. Elements, which are
+ *  considered equal, keep their order.
+ *  @param arguments Arguments of the primitive action, which are
+ *         the array and the reference of the 'dataCompare' function.
+ *  @return the sorted array.
+ *  @exception MEMORY_ERROR Not enough memory for the temporary buffer.
+ */
+objectType arr_sort_stable (listType arguments)
+
+  {
+    objectType arr_arg;
+    objectType data_cmp_func;
+    actType cmp_action = NULL;
+    arrayType arr1;
+    memSizeType result_size;
+    arrayType result;
+    objectType buffer;
+
+  /* arr_sort_stable */
+    arr_arg = arg_1(arguments);
+    isit_array(arr_arg);
+    data_cmp_func    = take_reference(arg_2(arguments));
+    result_size = arraySize(take_array(arr_arg));
+    if (result_size <= INSERTION_SORT_LIMIT) {
+      buffer = NULL;
+    } else if (unlikely(!ALLOC_TABLE(buffer, objectRecord, result_size >> 1))) {
+      return raise_exception(SYS_MEM_EXCEPTION);
+    } /* if */
+    if (TEMP2_OBJECT(arr_arg)) {
+      result = take_array(arr_arg);
+      arr_arg->value.arrayValue = NULL;
+    } else {
+      arr1 = take_array(arr_arg);
+      if (unlikely(!ALLOC_ARRAY(result, result_size))) {
+        if (buffer != NULL) {
+          FREE_TABLE(buffer, objectRecord, result_size >> 1);
+        } /* if */
+        return raise_exception(SYS_MEM_EXCEPTION);
+      } /* if */
+      result->min_position = arr1->min_position;
+      result->max_position = arr1->max_position;
+      if (unlikely(!crea_array(result->arr, arr1->arr, result_size))) {
+        FREE_ARRAY(result, result_size);
+        if (buffer != NULL) {
+          FREE_TABLE(buffer, objectRecord, result_size >> 1);
+        } /* if */
+        return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
+      } /* if */
+    } /* if */
+    if (CATEGORY_OF_OBJ(data_cmp_func) == ACTOBJECT) {
+      cmp_action = take_action(data_cmp_func);
+    } /* if */
+    if (buffer != NULL) {
+      merge_sort_array(result->arr, result_size, buffer,
+                       data_cmp_func, cmp_action);
+      FREE_TABLE(buffer, objectRecord, result_size >> 1);
+    } else if (result_size > 1) {
+      insertion_sort_array(result->arr, &result->arr[result_size - 1],
+                           data_cmp_func, cmp_action);
+    } /* if */
+    return bld_array_temp(result);
+  } /* arr_sort_stable */
+
+
+
+/**
+ *  Sort an array by string keys, which have been computed for its elements.
+ *  The sort is stable. Elements with equal keys keep their order.
+ *  @param arguments Arguments of the primitive action, which are
+ *         the array and the array with the key of every element.
+ *  @return the sorted array.
+ *  @exception RANGE_ERROR The array and the keys have different sizes.
+ */
+objectType arr_sort_stri_keys (listType arguments)
+
+  { /* arr_sort_stri_keys */
+    return sort_by_keys(arguments, TRUE);
+  } /* arr_sort_stri_keys */
+
+
+
+/**
+ *  Sort an array with the compare function 'dataCompare' and several threads.
+ *  Arrays of integers, floats, chars and strings, which are compared
+ *  with their default compare function, are sorted with arrSortParallel().
+ *  Other arrays are sorted with the introsort of arr_sort(), because
+ *  'dataCompare' is interpreted and the interpreter is not thread safe.
+ *  @param arguments Arguments of the primitive action, which are
+ *         the array, the reference of the 'dataCompare' function and
+ *         the maximum number of threads.
+ *  @return the sorted array.
+ *  @exception RANGE_ERROR If the number of threads is less than 1.
+ */
+objectType arr_sort_parallel (listType arguments)
+
+  {
+    objectType arr_arg;
+    objectType data_cmp_func;
+    intType numThreads;
+    actType cmp_action = NULL;
+    compareType cmp_func = NULL;
+    arrayType arr1;
+    memSizeType result_size;
+    arrayType result;
+    rtlArrayType values = NULL;
+    memSizeType pos;
+    unsigned int depth_limit = 0;
+
+  /* arr_sort_parallel */
+    arr_arg = arg_1(arguments);
+    isit_array(arr_arg);
+    data_cmp_func    = take_reference(arg_2(arguments));
+    isit_int(arg_3(arguments));
+    numThreads = take_int(arg_3(arguments));
+    if (unlikely(numThreads < 1)) {
+      logError(printf("arr_sort_parallel(arr1, *, " FMT_D "): "
+                      "Number of threads less than 1.\n",
+                      numThreads););
+      return raise_exception(SYS_RNG_EXCEPTION);
+    } /* if */
+    if (CATEGORY_OF_OBJ(data_cmp_func) == ACTOBJECT) {
+      cmp_action = take_action(data_cmp_func);
+      if (cmp_action == &int_cmp) {
+        cmp_func = &intCmpGeneric;
+      } else if (cmp_action == &flt_cmp) {
+        cmp_func = &fltCmpGeneric;
+      } else if (cmp_action == &chr_cmp) {
+        cmp_func = &chrCmpGeneric;
+      } else if (cmp_action == &str_cmp) {
+        cmp_func = &strCmpGeneric;
+      } /* if */
+    } /* if */
+    result_size = arraySize(take_array(arr_arg));
+    if (cmp_func != NULL && numThreads > 1 && result_size > 1) {
+      if (unlikely(!ALLOC_RTL_ARRAY(values, result_size))) {
+        return raise_exception(SYS_MEM_EXCEPTION);
+      } /* if */
+      values->min_position = 1;
+      values->max_position = (intType) result_size;
+    } /* if */
+    if (TEMP2_OBJECT(arr_arg)) {
+      result = take_array(arr_arg);
+      arr_arg->value.arrayValue = NULL;
+    } else {
+      arr1 = take_array(arr_arg);
+      if (unlikely(!ALLOC_ARRAY(result, result_size))) {
+        if (values != NULL) {
+          FREE_RTL_ARRAY(values, result_size);
+        } /* if */
+        return raise_exception(SYS_MEM_EXCEPTION);
+      } /* if */
+      result->min_position = arr1->min_position;
+      result->max_position = arr1->max_position;
+      if (unlikely(!crea_array(result->arr, arr1->arr, result_size))) {
+        FREE_ARRAY(result, result_size);
+        if (values != NULL) {
+          FREE_RTL_ARRAY(values, result_size);
+        } /* if */
+        return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
+      } /* if */
+    } /* if */
+    if (values != NULL) {
+      /* The elements differ only in their values. */
+      for (pos = 0; pos < result_size; pos++) {
+        if (cmp_func == &intCmpGeneric) {
+          values->arr[pos].value.intValue = result->arr[pos].value.intValue;
+        } else if (cmp_func == &fltCmpGeneric) {
+          values->arr[pos].value.floatValue = result->arr[pos].value.floatValue;
+        } else if (cmp_func == &chrCmpGeneric) {
+          values->arr[pos].value.charValue = result->arr[pos].value.charValue;
+        } else {
+          values->arr[pos].value.striValue = result->arr[pos].value.striValue;
+        } /* if */
+      } /* for */
+      arrSortParallel(values, cmp_func, numThreads);
+      for (pos = 0; pos < result_size; pos++) {
+        if (cmp_func == &intCmpGeneric) {
+          result->arr[pos].value.intValue = values->arr[pos].value.intValue;
+        } else if (cmp_func == &fltCmpGeneric) {
+          result->arr[pos].value.floatValue = values->arr[pos].value.floatValue;
+        } else if (cmp_func == &chrCmpGeneric) {
+          result->arr[pos].value.charValue = values->arr[pos].value.charValue;
+        } else {
+          result->arr[pos].value.striValue = values->arr[pos].value.striValue;
+        } /* if */
+      } /* for */
+      FREE_RTL_ARRAY(values, result_size);
+    } else if (result_size > 1) {
+      while (result_size >> depth_limit > 1) {
+        depth_limit++;
+      } /* while */
+      intro_sort_array(result->arr, &result->arr[result_size - 1],
+                       2 * depth_limit, data_cmp_func, cmp_action);
+    } /* if */
+    return bld_array_temp(result);
+  } /* arr_sort_parallel */
+
+
+
 /**
  *  Get a sub array from the position 'start' with maximum length 'length'.
  *  @return the sub array from position 'start' with maximum length 'length'.
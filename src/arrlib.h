@@ -48,8 +48,13 @@ objectType arr_minidx       (listType arguments);
 objectType arr_push         (listType arguments);
 objectType arr_range        (listType arguments);
 objectType arr_remove       (listType arguments);
+objectType arr_reserve      (listType arguments);
 objectType arr_remove_array (listType arguments);
 objectType arr_sort         (listType arguments);
+objectType arr_sort_int_keys (listType arguments);
+objectType arr_sort_parallel (listType arguments);
+objectType arr_sort_stable  (listType arguments);
+objectType arr_sort_stri_keys (listType arguments);
 objectType arr_subarr       (listType arguments);
 objectType arr_tail         (listType arguments);
 objectType arr_times        (listType arguments);
@@ -66,3 +66,84 @@ rtlArrayType gen_rtl_array (arrayType anArray)
     } /* if */
     return rtlArray;
   } /* gen_rtl_array */
+
+
+
+/**
+ *  Enlarge the capacity of an array.
+ *  This function is called from the macro GROW_ARRAY, if the
+ *  capacity of an array is not sufficient. GrowArray enlarges the
+ *  capacity such that at least 'len' elements fit into it.
+ *  It is assumed that 'arr' will grow further, therefore the
+ *  capacity is usually doubled.
+ *  @param arr Array for which the capacity is enlarged.
+ *  @param len Number of elements that must fit into the array.
+ *  @return the enlarged array, or NULL if the allocation failed.
+ */
+arrayType growArray (arrayType arr, memSizeType len)
+
+  {
+    memSizeType newCapacity;
+    arrayType result;
+
+  /* growArray */
+    if (unlikely(len > MAX_ARR_LEN)) {
+      result = NULL;
+    } else {
+      if (2 * arr->capacity >= len) {
+        newCapacity = 2 * arr->capacity;
+      } else {
+        newCapacity = len;
+      } /* if */
+      if (newCapacity < MIN_GROW_SHRINK_ARRAY_CAPACITY) {
+        newCapacity = MIN_GROW_SHRINK_ARRAY_CAPACITY;
+      } else if (unlikely(newCapacity > MAX_ARR_LEN)) {
+        newCapacity = MAX_ARR_LEN;
+      } /* if */
+      result = REALLOC_HEAP(arr, arrayType, SIZ_ARR(newCapacity));
+      if (unlikely(result == NULL)) {
+        do {
+          newCapacity = (newCapacity + len) / 2;
+          result = REALLOC_HEAP(arr, arrayType, SIZ_ARR(newCapacity));
+        } while (result == NULL && newCapacity != len);
+      } /* if */
+      if (likely(result != NULL)) {
+        COUNT3_ARRAY(result->capacity, newCapacity);
+        result->capacity = newCapacity;
+      } /* if */
+    } /* if */
+    return result;
+  } /* growArray */
+
+
+
+/**
+ *  Reduce the capacity of an array.
+ *  This function is called from the macro SHRINK_ARRAY, if the
+ *  capacity of an array is much too large. ShrinkArray reduces the
+ *  capacity, but it leaves room, such that it can grow again.
+ *  @param arr Array for which the capacity is reduced.
+ *  @param len Number of elements that must fit into the array.
+ *  @return the reduced array.
+ */
+arrayType shrinkArray (arrayType arr, memSizeType len)
+
+  {
+    memSizeType newCapacity;
+    arrayType result;
+
+  /* shrinkArray */
+    newCapacity = 2 * len;
+    if (newCapacity < MIN_GROW_SHRINK_ARRAY_CAPACITY) {
+      newCapacity = MIN_GROW_SHRINK_ARRAY_CAPACITY;
+    } /* if */
+    result = REALLOC_HEAP(arr, arrayType, SIZ_ARR(newCapacity));
+    if (unlikely(result == NULL)) {
+      /* Keeping the larger capacity is not an error. */
+      result = arr;
+    } else {
+      COUNT3_ARRAY(result->capacity, newCapacity);
+      result->capacity = newCapacity;
+    } /* if */
+    return result;
+  } /* shrinkArray */
@@ -29,3 +29,5 @@
 
 
 rtlArrayType gen_rtl_array (arrayType anArray);
+arrayType growArray (arrayType arr, memSizeType len);
+arrayType shrinkArray (arrayType arr, memSizeType len);
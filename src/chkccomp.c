@@ -9273,6 +9273,57 @@ int main (int argc, char **argv)
                          "wchar_t ch1 = 0x0102;\n"
                          "printf(\"%d\\n\", wmemchr(str1, ch1, 2) ==  &str1[1]);\n"
                          "return 0;}\n") && doTest() == 1);
+    fprintf(versionFile, "#define HAS_SSE2_INTRINSICS %d\n",
+        compileAndLinkOk("#include <stdio.h>\n#include <emmintrin.h>\n"
+                         "#ifndef __SSE2__\n#error SSE2 not enabled\n#endif\n"
+                         "int main(int argc, char *argv[]){\n"
+                         "unsigned int data[] = {1, 2, 3, 4};\n"
+                         "__m128i block = _mm_loadu_si128((const __m128i *) data);\n"
+                         "__m128i found = _mm_cmpeq_epi32(block, _mm_set1_epi32(3));\n"
+                         "unsigned int mask = (unsigned int)\n"
+                         "    _mm_movemask_ps(_mm_castsi128_ps(found));\n"
+                         "printf(\"%d\\n\", mask == 4 && __builtin_ctz(mask) == 2);\n"
+                         "return 0;}\n") && doTest() == 1);
+    fprintf(versionFile, "#define HAS_AVX2_TARGET_ATTRIBUTE %d\n",
+        compileAndLinkOk("#include <stdio.h>\n#include <immintrin.h>\n"
+                         "__attribute__((target(\"avx2\")))\n"
+                         "static unsigned int findAvx2 (const unsigned int *data)\n"
+                         "{__m256i block = _mm256_loadu_si256((const __m256i *) data);\n"
+                         "__m256i found = _mm256_cmpeq_epi32(block, _mm256_set1_epi32(7));\n"
+                         "return (unsigned int)\n"
+                         "    _mm256_movemask_ps(_mm256_castsi256_ps(found));}\n"
+                         "int main(int argc, char *argv[]){\n"
+                         "unsigned int data[] = {1, 2, 3, 4, 5, 6, 7, 8};\n"
+                         "__builtin_cpu_init();\n"
+                         "printf(\"%d\\n\", !__builtin_cpu_supports(\"avx2\") ||\n"
+                         "                  findAvx2(data) == 64);\n"
+                         "return 0;}\n") && doTest() == 1);
+    fprintf(versionFile, "#define HAS_POPCNT_TARGET_ATTRIBUTE %d\n",
+        compileAndLinkOk("#include <stdio.h>\n"
+                         "__attribute__((target(\"popcnt\")))\n"
+                         "static int countPopcnt (unsigned long long number)\n"
+                         "{return __builtin_popcountll(number);}\n"
+                         "int main(int argc, char *argv[]){\n"
+                         "unsigned long long number = 0xf00000000000f0a0ULL;\n"
+                         "__builtin_cpu_init();\n"
+                         "printf(\"%d\\n\", __builtin_ctzll(number) == 5 &&\n"
+                         "                  (!__builtin_cpu_supports(\"popcnt\") ||\n"
+                         "                   countPopcnt(number) == 10));\n"
+                         "return 0;}\n") && doTest() == 1);
+    fprintf(versionFile, "#define HAS_PTHREAD %d\n",
+        compileAndLinkOk("#include <stdio.h>\n#include <pthread.h>\n"
+                         "static void *task (void *arg)\n"
+                         "{*(int *) arg = 1; return NULL;}\n"
+                         "int main(int argc, char *argv[]){\n"
+                         "pthread_t thread;\n"
+                         "int done = 0;\n"
+                         "if (pthread_create(&thread, NULL, task, &done) == 0 &&\n"
+                         "    pthread_join(thread, NULL) == 0) {\n"
+                         "  printf(\"%d\\n\", done);\n"
+                         "} else {\n"
+                         "  printf(\"0\\n\");\n"
+                         "}\n"
+                         "return 0;}\n") && doTest() == 1);
     fprintf(versionFile, "#define HAS_WCSNLEN %d\n",
         compileAndLinkOk("#include <stdio.h>\n#include <wchar.h>\n"
                          "int main(int argc, char *argv[]){\n"
@@ -0,0 +1,8 @@
+#define LIST_DIRECTORY_CONTENTS "ls"
+#define CC_OPT_LINK_TIME_OPTIMIZATION "-flto"
+#define LINKER_OPT_STATIC_LINKING "-static"
+#define LINKER_OPT_NO_LTO "-fno-lto"
+#define LINKER_OPT_DYN_LINK_LIBS "-ldl"
+#define LINKER_OPT_PARTIAL_LINKING "-r", "-r -nostdlib"
+#define USE_GMP 0
+#define ALLOW_REPLACEMENT_OF_SYSTEM_HEADERS
@@ -885,9 +885,9 @@ static rtlArrayType addStriToRtlArray (const striType stri,
                        striAsUnquotedCStri(stri), used_max_position););
     if (used_max_position >= work_array->max_position) {
       if (unlikely(work_array->max_position > (intType) (MAX_RTL_ARR_INDEX - ARRAY_SIZE_DELTA) ||
-          (resized_work_array = REALLOC_RTL_ARRAY(work_array,
+          (REALLOC_RTL_ARRAY(resized_work_array, work_array,
               (uintType) work_array->max_position,
-              (uintType) work_array->max_position + ARRAY_SIZE_DELTA)) == NULL)) {
+              (uintType) work_array->max_position + ARRAY_SIZE_DELTA), resized_work_array == NULL))) {
         FREE_STRI(stri, stri->size);
         freeRtlStriArray(work_array, used_max_position);
         work_array = NULL;
@@ -914,7 +914,7 @@ static rtlArrayType completeRtlStriArray (rtlArrayType work_array,
 
   /* completeRtlStriArray */
     if (likely(work_array != NULL)) {
-      resized_work_array = REALLOC_RTL_ARRAY(work_array,
+      REALLOC_RTL_ARRAY(resized_work_array, work_array,
           (uintType) work_array->max_position, (uintType) used_max_position);
       if (unlikely(resized_work_array == NULL)) {
         freeRtlStriArray(work_array, used_max_position);
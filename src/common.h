@@ -591,6 +591,21 @@ boolType findTermDll (void);
 #define bitsetSize2(min_position,max_position) (memSizeType) ((uintType) (max_position) - (uintType) (min_position) + 1)
 #define bitsetIndex(set,pos) (memSizeType) ((uintType) (pos) - (uintType) (set)->min_position)
 
+/* A set with min_position > max_position uses the sparse    */
+/* representation: The number of slots is stored in          */
+/* min_position. The first half of bitset holds the word     */
+/* positions of the slots and the second half holds the      */
+/* corresponding words. The last -max_position slots are     */
+/* free. The positions of the used slots are ascending. If   */
+/* several slots have the same position only the first of    */
+/* them may hold a non-zero word. Slots with a zero word are */
+/* unused. They allow an insertion without moving all the    */
+/* following slots.                                          */
+#define setIsSparse(set) ((set)->min_position > (set)->max_position)
+#define sparseSize(set) ((memSizeType) (set)->min_position)
+#define sparseUsed(set) ((memSizeType) ((set)->min_position + (set)->max_position))
+#define setAllocSize(set) (setIsSparse(set) ? 2 * sparseSize(set) : bitsetSize(set))
+
 
 typedef struct setStruct      *setType;
 typedef struct striStruct     *striType;
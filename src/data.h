@@ -315,12 +315,14 @@ typedef struct blockStruct {
 typedef struct arrayStruct {
     intType min_position;
     intType max_position;
+    memSizeType capacity;
     objectRecord arr[1];
   } arrayRecord;
 
 typedef struct hashElemStruct {
     hashElemType next_less;
     hashElemType next_greater;
+    intType hashcode;
     objectRecord key;
     objectRecord data;
   } hashElemRecord;
@@ -330,7 +332,7 @@ typedef struct hashStruct {
     unsigned int mask;
     unsigned int table_size;
     memSizeType size;
-    hashElemType table[1];
+    hashElemType *table;
   } hashRecord;
 
 typedef struct structStruct {
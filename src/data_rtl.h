@@ -153,6 +153,7 @@ typedef struct rtlListStruct {
 typedef struct rtlArrayStruct {
     intType min_position;
     intType max_position;
+    memSizeType capacity;
     rtlObjectType arr[1];
   } rtlArrayRecord;
 
@@ -165,6 +166,7 @@ typedef struct rtlStructStruct {
 typedef struct rtlHashElemStruct {
     rtlHashElemType next_less;
     rtlHashElemType next_greater;
+    intType hashcode;
     rtlObjectType key;
     rtlObjectType data;
   } rtlHashElemRecord;
@@ -174,7 +176,7 @@ typedef struct rtlHashStruct {
     unsigned int mask;
     unsigned int table_size;
     memSizeType size;
-    rtlHashElemType table[1];
+    rtlHashElemType *table;
   } rtlHashRecord;
 
 typedef struct rtlTimeStruct {
@@ -51,6 +51,7 @@
 #include "objutl.h"
 #include "runerr.h"
 #include "match.h"
+#include "name.h"
 #include "prclib.h"
 
 #undef EXTERN
@@ -59,6 +60,72 @@
 #include "exec.h"
 
 
+/* Number of list elements in a frame on the C stack. */
+#define FRAME_SIZE 8
+
+/**
+ *  Append 'object' to a list whose first elements are taken from
+ *  'frame'. The array 'frame' is located on the C stack and has
+ *  FRAME_SIZE list elements. If 'index' is not less than FRAME_SIZE
+ *  the list element is taken from the heap.
+ */
+#define append_to_frame(insert_place, frame, index, object, act_param_list) \
+    if (likely((index) < FRAME_SIZE)) {                         \
+      (frame)[index].next = NULL;                               \
+      (frame)[index].obj = object;                              \
+      *(insert_place) = &(frame)[index];                        \
+      insert_place = &(frame)[index].next;                      \
+    } else {                                                    \
+      append_to_list(insert_place, object, act_param_list);     \
+    }
+
+/**
+ *  Free the list elements of a list created with append_to_frame.
+ *  Only list elements from the heap are freed.
+ */
+#define free_frame(frame, length) \
+    if (unlikely((length) > FRAME_SIZE)) {           \
+      free_list((frame)[FRAME_SIZE - 1].next);       \
+    }
+
+#define DYNAMIC_CACHE_SIZE 256
+#define DYNAMIC_CACHE_WAYS 4
+#define DYNAMIC_CACHE_PARAMS 8
+
+/**
+ *  Element of a DYNAMIC call as seen by match_prog_expression.
+ *  The match of an element depends only on its symbol (if it has
+ *  one), its type and whether it is a variable.
+ */
+typedef struct {
+    objectType symbol;
+    typeType type_of;
+    boolType is_var;
+  } dynamicParamType;
+
+typedef struct {
+    progType prog;
+    unsigned long declaration_change_count;
+    objectType function;
+    unsigned int length;
+    unsigned int symbol_matched;
+    dynamicParamType param[DYNAMIC_CACHE_PARAMS];
+  } dynamicCacheEntryType;
+
+typedef struct {
+    unsigned int next_replace;
+    dynamicCacheEntryType entry[DYNAMIC_CACHE_WAYS];
+  } dynamicCacheLineType;
+
+/**
+ *  Inline cache of the functions found by exec_dynamic.
+ *  The cache line is selected by the DYNAMIC call object, so every
+ *  call site keeps up to DYNAMIC_CACHE_WAYS resolved functions for
+ *  different parameter types.
+ */
+static dynamicCacheLineType dynamic_cache[DYNAMIC_CACHE_SIZE];
+
+
 extern boolType interpreter_exception;
 
 
@@ -172,12 +239,14 @@ objectType exec_object (register objectType object)
  *  When a TEMP2 parameter is used for a deeper function call
  *  The TEMP2 flag is cleared to avoid unwanted effects.
  */
-static inline void par_init (locListType form_param_list,
-    listType *backup_form_params, listType act_param_list,
-    listType *evaluated_act_params)
+static inline int par_init (locListType form_param_list,
+    listType *backup_form_params, listRecord *backup_frame,
+    listType act_param_list, listType *evaluated_act_params,
+    listRecord *evaluated_frame)
 
   {
     locListType form_param;
+    int param_num = 0;
     listType *backup_insert_place;
     listType *evaluated_insert_place;
     listType param_list_elem;
@@ -192,12 +261,14 @@ static inline void par_init (locListType form_param_list,
     *evaluated_act_params = NULL;
     evaluated_insert_place = evaluated_act_params;
     while (form_param != NULL && !fail_flag) {
-      append_to_list(backup_insert_place,
-          form_param->local.object->value.objValue, act_param_list);
+      append_to_frame(backup_insert_place, backup_frame,
+          param_num, form_param->local.object->value.objValue, act_param_list);
       param_value = exec_object(act_param_list->obj);
-      append_to_list(evaluated_insert_place, param_value, act_param_list);
+      append_to_frame(evaluated_insert_place, evaluated_frame,
+          param_num, param_value, act_param_list);
       form_param = form_param->next;
       act_param_list = act_param_list->next;
+      param_num++;
     } /* while */
     if (fail_flag) {
       param_list_elem = *evaluated_act_params;
@@ -262,6 +333,7 @@ static inline void par_init (locListType form_param_list,
       } /* while */
     } /* if */
     logFunction(printf("par_init -->\n"););
+    return param_num;
   } /* par_init */
 
 
@@ -324,11 +396,12 @@ static inline void par_restore (const_locListType form_param,
 
 
 
-static void loc_init (const_locListType loc_var, listType *backup_loc_var,
-    listType act_param_list)
+static int loc_init (const_locListType loc_var, listType *backup_loc_var,
+    listRecord *backup_frame, listType act_param_list)
 
   {
     listType *list_insert_place;
+    int var_num = 0;
     errInfoType err_info = OKAY_NO_ERROR;
 
   /* loc_init */
@@ -336,12 +409,14 @@ static void loc_init (const_locListType loc_var, listType *backup_loc_var,
     *backup_loc_var = NULL;
     list_insert_place = backup_loc_var;
     while (loc_var != NULL && !fail_flag) {
-      append_to_list(list_insert_place,
-          loc_var->local.object->value.objValue, act_param_list);
+      append_to_frame(list_insert_place, backup_frame,
+          var_num, loc_var->local.object->value.objValue, act_param_list);
       create_local_object(&loc_var->local, loc_var->local.init_value, &err_info);
       loc_var = loc_var->next;
+      var_num++;
     } /* while */
     logFunction(printf("loc_init -->\n"););
+    return var_num;
   } /* loc_init */
 
 
@@ -484,24 +559,31 @@ static objectType exec_lambda (const_blockType block,
     listType actual_parameters, objectType object)
 
   {
+    listRecord backup_param_frame[FRAME_SIZE];
+    listRecord evaluated_param_frame[FRAME_SIZE];
+    listRecord backup_local_frame[FRAME_SIZE];
     objectType result;
     listType evaluated_act_params;
     listType backup_form_params;
     objectType backup_block_result;
     listType backup_loc_var;
+    int param_count;
+    int local_count;
 
   /* exec_lambda */
     logFunction(printf("exec_lambda\n"););
-    par_init(block->params, &backup_form_params, actual_parameters,
-        &evaluated_act_params);
+    param_count = par_init(block->params, &backup_form_params,
+        backup_param_frame, actual_parameters, &evaluated_act_params,
+        evaluated_param_frame);
     if (fail_flag) {
-      free_list(backup_form_params);
-      free_list(evaluated_act_params);
+      free_frame(backup_param_frame, param_count);
+      free_frame(evaluated_param_frame, param_count);
       result = fail_value;
     } else {
-      loc_init(block->local_vars, &backup_loc_var, actual_parameters);
+      local_count = loc_init(block->local_vars, &backup_loc_var,
+          backup_local_frame, actual_parameters);
       if (fail_flag) {
-        free_list(backup_loc_var);
+        free_frame(backup_local_frame, local_count);
         result = fail_value;
       } else {
         if (res_init(&block->result, &backup_block_result)) {
@@ -517,12 +599,12 @@ static objectType exec_lambda (const_blockType block,
           result = raise_with_arguments(SYS_MEM_EXCEPTION, actual_parameters);
         } /* if */
         loc_restore(block->local_vars, backup_loc_var);
-        free_list(backup_loc_var);
+        free_frame(backup_local_frame, local_count);
       } /* if */
       /* show_arg_list(evaluated_act_params); */
       par_restore(block->params, backup_form_params, evaluated_act_params);
-      free_list(backup_form_params);
-      free_list(evaluated_act_params);
+      free_frame(backup_param_frame, param_count);
+      free_frame(evaluated_param_frame, param_count);
     } /* if */
     logFunction(printf("exec_lambda -->\n"););
     return result;
@@ -530,7 +612,21 @@ static objectType exec_lambda (const_blockType block,
 
 
 
-static listType eval_arg_list (register listType act_param_list, uint32Type *temp_bits_ptr)
+/**
+ *  Evaluate the actual parameters of an action.
+ *  The evaluated parameters are linked together as list, which
+ *  is used as argument list of the action. The first
+ *  FRAME_SIZE list elements are taken from 'frame', which
+ *  is located in the stack frame of exec_action. Only actions with
+ *  more parameters need list elements from the heap. This way most
+ *  action calls do not allocate and free list elements.
+ *  @param frame Array with FRAME_SIZE list elements.
+ *  @param param_count_ptr Place to return the number of evaluated
+ *         parameters.
+ *  @return the list of evaluated parameters.
+ */
+static listType eval_arg_list (register listType act_param_list,
+    listRecord *frame, uint32Type *temp_bits_ptr, int *param_count_ptr)
 
   {
     listType evaluated_act_params = NULL;
@@ -542,8 +638,25 @@ static listType eval_arg_list (register listType act_param_list, uint32Type *tem
   /* eval_arg_list */
     evaluated_insert_place = &evaluated_act_params;
     while (act_param_list != NULL && !fail_flag) {
-      evaluated_object = exec_object(act_param_list->obj);
-      append_to_list(evaluated_insert_place, evaluated_object, act_param_list);
+      /* Inlined version of exec_object() */
+      evaluated_object = act_param_list->obj;
+      switch (CATEGORY_OF_OBJ(evaluated_object)) {
+        case CALLOBJECT:
+          evaluated_object = exec_call(evaluated_object);
+          break;
+        case VALUEPARAMOBJECT:
+        case REFPARAMOBJECT:
+        case RESULTOBJECT:
+        case LOCALVOBJECT:
+          if (evaluated_object->value.objValue != NULL) {
+            evaluated_object = evaluated_object->value.objValue;
+          } /* if */
+          break;
+        default:
+          break;
+      } /* switch */
+      append_to_frame(evaluated_insert_place, frame,
+          param_num, evaluated_object, act_param_list);
       if (evaluated_object != NULL && TEMP_OBJECT(evaluated_object)) {
         temp_bits |= (uint32Type) 1 << param_num;
       } /* if */
@@ -551,31 +664,34 @@ static listType eval_arg_list (register listType act_param_list, uint32Type *tem
       param_num++;
     } /* while */
     *temp_bits_ptr = temp_bits;
+    *param_count_ptr = param_num;
     return evaluated_act_params;
   } /* eval_arg_list */
 
 
 
-static void dump_arg_list (listType evaluated_act_params, uint32Type temp_bits)
+/**
+ *  Free the temporary values of the evaluated parameters.
+ *  The list elements from 'frame' are not freed. If the action
+ *  had more than FRAME_SIZE parameters the list elements
+ *  from the heap are freed.
+ */
+static void dump_arg_list (listType evaluated_act_params, listRecord *frame,
+    uint32Type temp_bits, int param_count)
 
   {
-    register listType list_end;
+    register listType list_elem;
 
   /* dump_arg_list */
-    if (evaluated_act_params != NULL) {
-      list_end = evaluated_act_params;
-      while (list_end->next != NULL) {
-        if (list_end->obj != NULL && temp_bits & 1 && TEMP_OBJECT(list_end->obj)) {
-          dump_any_temp(list_end->obj);
-        } /* if */
-        list_end = list_end->next;
-        temp_bits >>= 1;
-      } /* while */
-      if (list_end->obj != NULL && temp_bits & 1 && TEMP_OBJECT(list_end->obj)) {
-        dump_any_temp(list_end->obj);
+    list_elem = evaluated_act_params;
+    while (temp_bits != 0 && list_elem != NULL) {
+      if (list_elem->obj != NULL && temp_bits & 1 && TEMP_OBJECT(list_elem->obj)) {
+        dump_any_temp(list_elem->obj);
       } /* if */
-      free_list2(evaluated_act_params, list_end);
-    } /* if */
+      list_elem = list_elem->next;
+      temp_bits >>= 1;
+    } /* while */
+    free_frame(frame, param_count);
   } /* dump_arg_list */
 
 
@@ -584,8 +700,11 @@ static objectType exec_action (const_objectType act_object,
     listType act_param_list, objectType object)
 
   {
+    listRecord frame[FRAME_SIZE];
     listType evaluated_act_params;
+    listType backup_curr_argument_list;
     uint32Type temp_bits;
+    int param_count;
     objectType result;
 
   /* exec_action */
@@ -596,15 +715,20 @@ static objectType exec_action (const_objectType act_object,
       return raise_with_arguments(SYS_MEM_EXCEPTION, act_param_list);
     } /* if */
 #endif
-    evaluated_act_params = eval_arg_list(act_param_list, &temp_bits);
+    evaluated_act_params = eval_arg_list(act_param_list, frame, &temp_bits,
+                                          &param_count);
+    /* The evaluated parameters may reside in 'frame'. Therefore   */
+    /* curr_argument_list must not refer to them after returning. */
+    backup_curr_argument_list = curr_argument_list;
     if (interrupt_flag) {
       if (!fail_flag) {
         curr_exec_object = object;
         curr_argument_list = evaluated_act_params;
         show_signal();
+        curr_argument_list = backup_curr_argument_list;
       } /* if */
       if (fail_flag) {
-        dump_arg_list(evaluated_act_params, temp_bits);
+        dump_arg_list(evaluated_act_params, frame, temp_bits, param_count);
         result = fail_value;
         logFunction(printf("exec_action fail_flag=%d -->\n", fail_flag););
         return result;
@@ -686,7 +810,8 @@ static objectType exec_action (const_objectType act_object,
 #ifdef WITH_PROTOCOL
     } /* if */
 #endif
-    dump_arg_list(evaluated_act_params, temp_bits);
+    curr_argument_list = backup_curr_argument_list;
+    dump_arg_list(evaluated_act_params, frame, temp_bits, param_count);
     logFunction(printf("exec_action fail_flag=%d -->\n", fail_flag););
     return result;
   } /* exec_action */
@@ -969,6 +1094,95 @@ objectType eval_expression (objectType object)
 
 
 
+/**
+ *  Search the function of a DYNAMIC call in a line of the inline cache.
+ *  An entry is only valid if it was created for the current program
+ *  and no declaration was added or removed since it was created.
+ *  @param symbol_matched Bitset of the parameters which were matched
+ *         with their symbol instead of their type.
+ *  @return the function which was found for the parameters or
+ *          NULL if the cache line has no valid entry for them.
+ */
+static objectType find_in_dynamic_cache (dynamicCacheLineType *cache_line,
+    const dynamicParamType *param, unsigned int length,
+    unsigned int *symbol_matched)
+
+  {
+    dynamicCacheEntryType *entry;
+    unsigned int way;
+    unsigned int pos;
+
+  /* find_in_dynamic_cache */
+    for (way = 0; way < DYNAMIC_CACHE_WAYS; way++) {
+      entry = &cache_line->entry[way];
+      if (entry->function != NULL && entry->length == length &&
+          entry->prog == prog &&
+          entry->declaration_change_count == declaration_change_count) {
+        pos = 0;
+        while (pos < length &&
+               entry->param[pos].type_of == param[pos].type_of &&
+               entry->param[pos].symbol == param[pos].symbol &&
+               entry->param[pos].is_var == param[pos].is_var) {
+          pos++;
+        } /* while */
+        if (pos == length) {
+          *symbol_matched = entry->symbol_matched;
+          return entry->function;
+        } /* if */
+      } /* if */
+    } /* for */
+    return NULL;
+  } /* find_in_dynamic_cache */
+
+
+
+/**
+ *  Remember the function found by match_prog_expression for a DYNAMIC call.
+ *  The matched expression consists of the function followed by the
+ *  elements of the call. An element is either unchanged or replaced by
+ *  its symbol. If the match did anything else (e.g. wrapping an element
+ *  into a call) the result is not cached.
+ */
+static void enter_dynamic_cache (dynamicCacheLineType *cache_line,
+    const dynamicParamType *param, unsigned int length,
+    const objectType *element_value, const_listType matched_list)
+
+  {
+    objectType function;
+    unsigned int symbol_matched = 0;
+    unsigned int pos;
+    dynamicCacheEntryType *entry;
+
+  /* enter_dynamic_cache */
+    function = matched_list->obj;
+    matched_list = matched_list->next;
+    for (pos = 0; pos < length; pos++) {
+      if (matched_list == NULL) {
+        return;
+      } else if (matched_list->obj != element_value[pos]) {
+        if (param[pos].symbol != NULL &&
+            matched_list->obj == param[pos].symbol) {
+          symbol_matched |= 1U << pos;
+        } else {
+          return;
+        } /* if */
+      } /* if */
+      matched_list = matched_list->next;
+    } /* for */
+    if (matched_list == NULL) {
+      entry = &cache_line->entry[cache_line->next_replace];
+      cache_line->next_replace = (cache_line->next_replace + 1) % DYNAMIC_CACHE_WAYS;
+      entry->prog = prog;
+      entry->declaration_change_count = declaration_change_count;
+      entry->function = function;
+      entry->length = length;
+      entry->symbol_matched = symbol_matched;
+      memcpy(entry->param, param, length * sizeof(dynamicParamType));
+    } /* if */
+  } /* enter_dynamic_cache */
+
+
+
 objectType exec_dynamic (listType expr_list)
 
   {
@@ -978,6 +1192,13 @@ objectType exec_dynamic (listType expr_list)
     listType *list_insert_place;
     objectType element_value;
     objectType match_result;
+    dynamicCacheLineType *cache_line;
+    dynamicParamType param[DYNAMIC_CACHE_PARAMS];
+    objectType param_value[DYNAMIC_CACHE_PARAMS];
+    unsigned int length = 0;
+    boolType cacheable = TRUE;
+    objectType function;
+    unsigned int symbol_matched;
     objectType result = NULL;
     errInfoType err_info = OKAY_NO_ERROR;
 
@@ -1035,6 +1256,39 @@ printf("\n"); */
           CLEAR_TEMP_FLAG(element_value);
         } /* if */
 #endif
+        if (cacheable) {
+          if (length >= DYNAMIC_CACHE_PARAMS || element_value == NULL) {
+            cacheable = FALSE;
+          } else {
+            switch (CATEGORY_OF_OBJ(element_value)) {
+              case TYPEOBJECT:
+              case EXPROBJECT:
+              case CALLOBJECT:
+              case MATCHOBJECT:
+              case BLOCKOBJECT:
+              case ACTOBJECT:
+              case VALUEPARAMOBJECT:
+              case REFPARAMOBJECT:
+              case RESULTOBJECT:
+              case LOCALVOBJECT:
+                /* The match of these objects depends on more */
+                /* than their symbol and their type.          */
+                cacheable = FALSE;
+                break;
+              default:
+                if (HAS_ENTITY(element_value)) {
+                  param[length].symbol = GET_ENTITY(element_value)->syobject;
+                } else {
+                  param[length].symbol = NULL;
+                } /* if */
+                param[length].type_of = element_value->type_of;
+                param[length].is_var = VAR_OBJECT(element_value) != 0;
+                param_value[length] = element_value;
+                length++;
+                break;
+            } /* switch */
+          } /* if */
+        } /* if */
         /* err_info is not checked after append! */
         list_insert_place = append_element_to_list(list_insert_place,
             element_value, &err_info);
@@ -1054,8 +1308,34 @@ printf("\n"); */
       /* printf("match_expr ");
       trace1(match_expr);
       printf("\n"); */
-      if (match_prog_expression(prog->declaration_root, match_expr) != NULL &&
+      cache_line = &dynamic_cache[((memSizeType) dynamic_call_obj >> 4) &
+                                  (DYNAMIC_CACHE_SIZE - 1)];
+      if (cacheable && !trace.match &&
+          (function = find_in_dynamic_cache(cache_line, param, length,
+                                            &symbol_matched)) != NULL) {
+        actual_element = match_expr->value.listValue;
+        while (symbol_matched != 0) {
+          if (symbol_matched & 1) {
+            actual_element->obj = GET_ENTITY(actual_element->obj)->syobject;
+          } /* if */
+          actual_element = actual_element->next;
+          symbol_matched >>= 1;
+        } /* while */
+        /* err_info is not checked after incl_list! */
+        incl_list(&match_expr->value.listValue, function, &err_info);
+        match_expr->type_of = function->type_of;
+        SET_CATEGORY_OF_OBJ(match_expr, CALLOBJECT);
+        match_result = match_expr;
+      } else if (match_prog_expression(prog->declaration_root, match_expr) != NULL &&
           (match_result = match_object(match_expr)) != NULL) {
+        if (cacheable && match_result == match_expr) {
+          enter_dynamic_cache(cache_line, param, length, param_value,
+                              match_expr->value.listValue);
+        } /* if */
+      } else {
+        match_result = NULL;
+      } /* if */
+      if (match_result != NULL) {
 #ifdef WITH_PROTOCOL
         if (trace.dynamic) {
           prot_cstri("matched ==> ");
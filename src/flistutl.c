@@ -207,8 +207,9 @@ static unsigned long stri_flist_count (unsigned long *stri_chars)
           num_elems++;
         } /* while */
         num_stris += num_elems;
-        *stri_chars += index * num_elems;
-        /* printf("sflist[%d]=%lu %lu\n", index, num_elems, index * num_elems); */
+        *stri_chars += STRI_FREELIST_INDEX_CAPACITY(index) * num_elems;
+        /* printf("sflist[%d]=%lu %lu\n", index, num_elems,
+            STRI_FREELIST_INDEX_CAPACITY(index) * num_elems); */
       } /* for */
       /* printf("num_stris=%lu\n", num_stris);
          printf("stri_chars=%lu\n", *stri_chars);
@@ -304,10 +305,10 @@ void heapStatistic (void)
     } /* if */
     if (count.hash != 0) {
       printf(F_U_MEM(9) " bytes in %8lu hashtables of          %4u bytes\n",
-          count.hash * SIZ_HSH(0),
+          count.hash * SIZ_HSH,
           count.hash,
-          (unsigned int) SIZ_HSH(0));
-      bytes_used += count.hash * SIZ_HSH(0);
+          (unsigned int) SIZ_HSH);
+      bytes_used += count.hash * SIZ_HSH;
     } /* if */
     if (count.hsh_elems != 0) {
       printf(F_U_MEM(9) " bytes in " F_U_MEM(8) " hashtable elems of     %4u bytes\n",
@@ -619,6 +620,9 @@ void heapStatistic (void)
           (memSizeType) (chunk.beyond - chunk.freemem) + chunk.lost_bytes);
     } /* if */
 #endif
+#if WITH_STRI_FREELIST
+    freelistStatistic();
+#endif
 #if DO_HEAP_CHECK
     /* check_heap(0, __FILE__, __LINE__); */
 #endif
@@ -643,7 +647,7 @@ static memSizeType compute_hs (void)
     bytes_total += count.bstri_elems * sizeof(ucharType);
     bytes_total += count.array * SIZ_ARR(0);
     bytes_total += count.arr_elems * SIZ_REC(objectRecord);
-    bytes_total += count.hash * SIZ_HSH(0);
+    bytes_total += count.hash * SIZ_HSH;
     bytes_total += count.hsh_elems * SIZ_REC(hashElemType);
     bytes_total += count.hsh_elems * SIZ_REC(hashElemRecord);
     bytes_total += count.set * SIZ_SET(0);
@@ -852,7 +856,7 @@ void check_heap (long sizediff, const char *file_name, unsigned int line_num)
         ((memSizeType) count.array) * SIZ_ARR(0) +
         count.arr_elems * SIZ_REC(objectRecord) +
         count.rtl_arr_elems * SIZ_REC(rtlObjectType) +
-        ((memSizeType) count.hash) * SIZ_HSH(0) +
+        ((memSizeType) count.hash) * SIZ_HSH +
         count.hsh_elems * SIZ_REC(hashElemType) +
         ((memSizeType) count.helem) * SIZ_REC(hashElemRecord) +
         ((memSizeType) count.rtl_helem) * SIZ_REC(rtlHashElemRecord) +
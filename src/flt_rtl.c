@@ -57,6 +57,20 @@
 
 #define USE_STRTOD 1
 #define MAX_CSTRI_BUFFER_LEN 25
+#ifdef INT128TYPE
+#define EXACT_DECIMAL_CONVERSION 1
+#else
+#define EXACT_DECIMAL_CONVERSION 0
+#endif
+#if USE_STRTOD && defined FLT_EVAL_METHOD && FLT_EVAL_METHOD == 0
+#define FAST_FLOAT_PARSE 1
+#else
+#define FAST_FLOAT_PARSE 0
+#endif
+/* Precision up to which the exact conversion is used for %e. */
+#define MAX_EXACT_SCI_PRECISION 16
+/* Up to 10 ** 22 powers of ten are exactly representable as double. */
+#define MAX_EXACT_DOUBLE_POWER_OF_TEN 22
 #define IPOW_EXPONENTIATION_BY_SQUARING 1
 #define PRECISION_BUFFER_LEN 1000
 /* The 3 additional chars below are for: "-1.". */
@@ -221,6 +235,291 @@ double setMantissaAndExponent (int64Type intMantissa, int binaryExponent)
 
 
 
+#if EXACT_DECIMAL_CONVERSION
+static const uint64Type powerOfTen[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000, 10000000000, 100000000000, 1000000000000,
+    10000000000000, 100000000000000, 1000000000000000,
+    10000000000000000, 100000000000000000, 1000000000000000000,
+    10000000000000000000U};
+
+
+
+/**
+ *  Round intMantissa * 2 ** binaryExponent * 10 ** decimalScale.
+ *  The value is computed exactly with 128-bit integers and rounded
+ *  to the nearest integer. Halfway cases are not rounded, because
+ *  the rounding of printf() for them depends on the C library.
+ *  @param intMantissa Mantissa with at most 53 bits.
+ *  @param decimalScale Power of ten between -19 and 22.
+ *  @param digits Destination for the rounded value.
+ *  @return TRUE if the rounded value has been computed, or
+ *          FALSE if the value is a halfway case, if it does not fit
+ *          into 64 bits or if 128 bits are not enough to compute it.
+ */
+static boolType roundScaledMantissa (uint64Type intMantissa,
+    int binaryExponent, int decimalScale, uint64Type *digits)
+
+  {
+    uint128Type numerator;
+    uint128Type denominator;
+    uint128Type quotient;
+    uint128Type remainder;
+    boolType okay = FALSE;
+
+  /* roundScaledMantissa */
+    if (decimalScale >= 0 && decimalScale <= MAX_EXACT_DOUBLE_POWER_OF_TEN &&
+        binaryExponent < 64) {
+      /* The numerator has at most 53 + 74 bits. */
+      numerator = (uint128Type) intMantissa *
+          powerOfTen[decimalScale <= 19 ? decimalScale : 19];
+      if (decimalScale > 19) {
+        numerator *= powerOfTen[decimalScale - 19];
+      } /* if */
+      if (binaryExponent >= 0) {
+        if (numerator <= (uint128Type) (UINT64TYPE_MAX >> binaryExponent)) {
+          *digits = (uint64Type) numerator << binaryExponent;
+          okay = TRUE;
+        } /* if */
+      } else if (binaryExponent > -128) {
+        quotient = numerator >> -binaryExponent;
+        remainder = numerator - (quotient << -binaryExponent);
+        denominator = (uint128Type) 1 << -binaryExponent;
+        okay = 2 * remainder != denominator;
+        quotient += 2 * remainder > denominator;
+        okay = okay && quotient <= UINT64TYPE_MAX;
+        *digits = (uint64Type) quotient;
+      } /* if */
+    } else if (decimalScale < 0 && decimalScale >= -19 &&
+               binaryExponent > -64 && binaryExponent < 64) {
+      numerator = intMantissa;
+      denominator = powerOfTen[-decimalScale];
+      if (binaryExponent >= 0) {
+        numerator <<= binaryExponent;
+      } else {
+        denominator <<= -binaryExponent;
+      } /* if */
+      quotient = numerator / denominator;
+      remainder = numerator - quotient * denominator;
+      okay = 2 * remainder != denominator;
+      quotient += 2 * remainder > denominator;
+      okay = okay && quotient <= UINT64TYPE_MAX;
+      *digits = (uint64Type) quotient;
+    } /* if */
+    return okay;
+  } /* roundScaledMantissa */
+
+
+
+/**
+ *  Write the decimal digits of 'number' to 'buffer'.
+ *  @param minDigits Minimum number of digits (leading zeros are added).
+ *  @return the number of digits written.
+ */
+static memSizeType uint64ToDigits (uint64Type number, memSizeType minDigits,
+    char *buffer)
+
+  {
+    char digits[STRLEN("18446744073709551615")];
+    memSizeType numDigits = 0;
+
+  /* uint64ToDigits */
+    do {
+      digits[numDigits] = (char) ('0' + number % 10);
+      number /= 10;
+      numDigits++;
+    } while (number != 0);
+    while (numDigits < minDigits) {
+      digits[numDigits] = '0';
+      numDigits++;
+    } /* while */
+    minDigits = numDigits;
+    while (numDigits != 0) {
+      numDigits--;
+      *buffer = digits[numDigits];
+      buffer++;
+    } /* while */
+    return minDigits;
+  } /* uint64ToDigits */
+
+
+
+/**
+ *  Write 'number' to 'buffer' like sprintf(buffer, "%1.*e", precision, number).
+ *  The digits are computed exactly, so the result is identical to
+ *  the one of a correctly rounding printf(). Numbers which cannot be
+ *  converted this way are left to sprintf().
+ *  @param number Finite number to be converted.
+ *  @return the length of the result, or 0 if the number could
+ *          not be converted.
+ */
+static memSizeType exactSciToCharBuffer (double number, intType precision,
+    char *buffer)
+
+  {
+    int binaryExponent;
+    uint64Type intMantissa;
+    int decimalExponent;
+    uint64Type digits = 0;
+    boolType okay;
+    char *pos;
+    char digitBuffer[MAX_EXACT_SCI_PRECISION + 1];
+    char exponentDigits[STRLEN("1024")];
+    int numExponentDigits;
+    memSizeType len = 0;
+
+  /* exactSciToCharBuffer */
+    if (precision <= MAX_EXACT_SCI_PRECISION) {
+      if (number == 0.0) {
+        decimalExponent = 0;
+        okay = TRUE;
+      } else {
+        intMantissa = (uint64Type) getMantissaAndExponent(fabs(number),
+                                                          &binaryExponent);
+        /* The estimated decimal exponent is too small by at most one. */
+        decimalExponent = (int) floor((double) (binaryExponent +
+            DOUBLE_MANTISSA_SHIFT - 1) * 0.30102999566398119521);
+        okay = roundScaledMantissa(intMantissa, binaryExponent,
+                                   (int) precision - decimalExponent, &digits);
+        if (okay && digits >= powerOfTen[precision + 1]) {
+          decimalExponent++;
+          okay = roundScaledMantissa(intMantissa, binaryExponent,
+                                     (int) precision - decimalExponent, &digits);
+        } /* if */
+      } /* if */
+      if (okay) {
+        pos = buffer;
+        if (number < 0.0 || (number == 0.0 && fltIsNegativeZero((floatType) number))) {
+          *pos = '-';
+          pos++;
+        } /* if */
+        uint64ToDigits(digits, (memSizeType) precision + 1, digitBuffer);
+        *pos = digitBuffer[0];
+        pos++;
+        if (precision != 0) {
+          *pos = '.';
+          pos++;
+          memcpy(pos, &digitBuffer[1], (size_t) precision);
+          pos += precision;
+        } /* if */
+        *pos = 'e';
+        pos++;
+        if (decimalExponent < 0) {
+          *pos = '-';
+          decimalExponent = -decimalExponent;
+        } else {
+          *pos = '+';
+        } /* if */
+        pos++;
+        numExponentDigits = 0;
+        do {
+          exponentDigits[numExponentDigits] = (char) ('0' + decimalExponent % 10);
+          decimalExponent /= 10;
+          numExponentDigits++;
+        } while (decimalExponent != 0);
+        while (numExponentDigits < MIN_PRINTED_EXPONENT_DIGITS) {
+          exponentDigits[numExponentDigits] = '0';
+          numExponentDigits++;
+        } /* while */
+        while (numExponentDigits != 0) {
+          numExponentDigits--;
+          *pos = exponentDigits[numExponentDigits];
+          pos++;
+        } /* while */
+        *pos = '\0';
+        len = (memSizeType) (pos - buffer);
+      } /* if */
+    } /* if */
+    return len;
+  } /* exactSciToCharBuffer */
+
+
+
+/**
+ *  Write 'number' to 'buffer' like sprintf(buffer, "%1.*f", precision, number).
+ *  The digits are computed exactly, so the result is identical to
+ *  the one of a correctly rounding printf(). Numbers which cannot be
+ *  converted this way are left to sprintf().
+ *  @param number Finite number to be converted.
+ *  @return the length of the result, or 0 if the number could
+ *          not be converted.
+ */
+static memSizeType exactFixToCharBuffer (double number, intType precision,
+    char *buffer)
+
+  {
+    int binaryExponent;
+    uint64Type intMantissa;
+    uint64Type digits = 0;
+    boolType okay;
+    char *pos;
+    memSizeType len = 0;
+
+  /* exactFixToCharBuffer */
+    if (precision <= MAX_EXACT_DOUBLE_POWER_OF_TEN) {
+      if (number == 0.0) {
+        okay = TRUE;
+      } else {
+        intMantissa = (uint64Type) getMantissaAndExponent(fabs(number),
+                                                          &binaryExponent);
+        okay = roundScaledMantissa(intMantissa, binaryExponent,
+                                   (int) precision, &digits);
+      } /* if */
+      if (okay) {
+        pos = buffer;
+        if (number < 0.0 || (number == 0.0 && fltIsNegativeZero((floatType) number))) {
+          *pos = '-';
+          pos++;
+        } /* if */
+        if (precision == 0) {
+          pos += uint64ToDigits(digits, 1, pos);
+        } else {
+          if (precision <= 19) {
+            pos += uint64ToDigits(digits / powerOfTen[precision], 1, pos);
+            digits %= powerOfTen[precision];
+          } else {
+            /* The digits are less than 10 ** 20. */
+            *pos = '0';
+            pos++;
+          } /* if */
+          *pos = '.';
+          pos++;
+          pos += uint64ToDigits(digits, (memSizeType) precision, pos);
+        } /* if */
+        *pos = '\0';
+        len = (memSizeType) (pos - buffer);
+      } /* if */
+    } /* if */
+    return len;
+  } /* exactFixToCharBuffer */
+
+
+
+/**
+ *  Get the precision of a printf format like "%1.14e".
+ *  @return the precision, or INTTYPE_MAX if the format has a different form.
+ */
+static intType formatPrecision (const char *format)
+
+  {
+    intType precision = INTTYPE_MAX;
+
+  /* formatPrecision */
+    if (format[0] == '%' && format[1] == '1' && format[2] == '.' &&
+        format[3] >= '0' && format[3] <= '9') {
+      if (format[4] == 'e' && format[5] == '\0') {
+        precision = format[3] - '0';
+      } else if (format[4] >= '0' && format[4] <= '9' &&
+                 format[5] == 'e' && format[6] == '\0') {
+        precision = 10 * (format[3] - '0') + format[4] - '0';
+      } /* if */
+    } /* if */
+    return precision;
+  } /* formatPrecision */
+#endif
+
+
+
 /**
  *  Write the decimal representation of a double to a buffer.
  *  The result in buffer uses the style [-]ddd.ddd where there is at least
@@ -261,8 +560,16 @@ memSizeType doubleToCharBuffer (const double doubleValue,
       memcpy(buffer, "0.0", 3);
       len = 3;
     } else if (doubleValue < -largeNumber || doubleValue > largeNumber) {
+#if EXACT_DECIMAL_CONVERSION
+      len = exactFixToCharBuffer(doubleValue, 1, buffer);
+      if (len == 0)
+#endif
       len = (memSizeType) sprintf(buffer, "%1.1f", doubleValue);
     } else {
+#if EXACT_DECIMAL_CONVERSION
+      len = exactSciToCharBuffer(doubleValue, formatPrecision(format), buffer);
+      if (len == 0)
+#endif
       len = (memSizeType) sprintf(buffer, format, doubleValue);
       /* printf("buffer: \"%s\"\n", buffer); */
       /* Subtract two more chars for sign and letter 'e': */
@@ -510,6 +817,11 @@ striType fltDgts (floatType number, intType precision)
         buffer_ptr = "-Infinity";
         len = STRLEN("-Infinity");
       } else {
+#if EXACT_DECIMAL_CONVERSION
+        if ((len = exactFixToCharBuffer(number, precision, buffer)) != 0) {
+          /* The exact conversion did not need sprintf(). */
+        } else
+#endif
 #ifdef LIMIT_FMT_F_MAXIMUM_FLOAT_PRECISION
         if (unlikely(precision > PRINTF_FMT_F_MAXIMUM_FLOAT_PRECISION)) {
           len = (memSizeType) sprintf(buffer, "%1."
@@ -1255,6 +1567,123 @@ floatType fltMod (floatType dividend, floatType divisor)
 
 
 
+#if FAST_FLOAT_PARSE
+static const double doublePowerOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+
+
+/**
+ *  Convert a simple decimal float literal without calling strtod().
+ *  The characters of 'stri' are processed directly. Literals with
+ *  at most 19 significant digits, whose mantissa fits into 53 bits
+ *  and whose decimal exponent is between -22 and 22 are converted.
+ *  For them a single multiplication or division of two exact double
+ *  values gives the correctly rounded result (Clinger's fast path).
+ *  This is the same result as the one of strtod().
+ *  @param result Destination for the converted value.
+ *  @return TRUE if 'stri' was converted, or FALSE if strtod()
+ *          must be used.
+ */
+static boolType fastFltParse (const const_striType stri, floatType *const result)
+
+  {
+    const strElemType *pos;
+    const strElemType *beyond;
+    boolType negative = FALSE;
+    uint64Type mantissa = 0;
+    int numDigits = 0;
+    int numSignificantDigits = 0;
+    int fractionDigits = 0;
+    boolType negativeExponent = FALSE;
+    int exponent = 0;
+    int numExponentDigits = 0;
+    double doubleValue;
+    boolType okay = FALSE;
+
+  /* fastFltParse */
+    pos = stri->mem;
+    beyond = &stri->mem[stri->size];
+    if (pos != beyond && (*pos == '-' || *pos == '+')) {
+      negative = *pos == '-';
+      pos++;
+    } /* if */
+    while (pos != beyond && *pos >= '0' && *pos <= '9') {
+      if (mantissa != 0 || *pos != '0') {
+        mantissa = 10 * mantissa + (*pos - '0');
+        numSignificantDigits++;
+      } /* if */
+      numDigits++;
+      pos++;
+      if (numSignificantDigits > 19) {
+        beyond = pos;
+      } /* if */
+    } /* while */
+    if (pos != beyond && *pos == '.') {
+      pos++;
+      while (pos != beyond && *pos >= '0' && *pos <= '9') {
+        if (mantissa != 0 || *pos != '0') {
+          mantissa = 10 * mantissa + (*pos - '0');
+          numSignificantDigits++;
+        } /* if */
+        numDigits++;
+        fractionDigits++;
+        pos++;
+        if (numSignificantDigits > 19 || fractionDigits > 1000) {
+          beyond = pos;
+        } /* if */
+      } /* while */
+    } /* if */
+    if (numDigits != 0 && numSignificantDigits <= 19) {
+      if (pos != beyond && (*pos == 'e' || *pos == 'E')) {
+        pos++;
+        if (pos != beyond && (*pos == '-' || *pos == '+')) {
+          negativeExponent = *pos == '-';
+          pos++;
+        } /* if */
+        while (pos != beyond && *pos >= '0' && *pos <= '9' &&
+               numExponentDigits < 5) {
+          exponent = 10 * exponent + (int) (*pos - '0');
+          numExponentDigits++;
+          pos++;
+        } /* while */
+        if (negativeExponent) {
+          exponent = -exponent;
+        } /* if */
+        okay = numExponentDigits != 0;
+      } else {
+        okay = TRUE;
+      } /* if */
+      if (okay && pos == &stri->mem[stri->size]) {
+        exponent -= fractionDigits;
+        if (mantissa == 0) {
+          doubleValue = 0.0;
+        } else if (mantissa <= (uint64Type) 1 << DOUBLE_MANTISSA_SHIFT &&
+                   exponent >= -MAX_EXACT_DOUBLE_POWER_OF_TEN &&
+                   exponent <= MAX_EXACT_DOUBLE_POWER_OF_TEN) {
+          doubleValue = (double) mantissa;
+          if (exponent >= 0) {
+            doubleValue *= doublePowerOfTen[exponent];
+          } else {
+            doubleValue /= doublePowerOfTen[-exponent];
+          } /* if */
+        } else {
+          okay = FALSE;
+        } /* if */
+        if (okay) {
+          *result = (floatType) (negative ? -doubleValue : doubleValue);
+        } /* if */
+      } else {
+        okay = FALSE;
+      } /* if */
+    } /* if */
+    return okay;
+  } /* fastFltParse */
+#endif
+
+
+
 /**
  *  Convert a string to a float number.
  *  @return the float result of the conversion.
@@ -1278,6 +1707,11 @@ floatType fltParse (const const_striType stri)
   /* fltParse */
     logFunction(printf("fltParse(\"%s\")\n", striAsUnquotedCStri(stri)););
 #if USE_STRTOD
+#if FAST_FLOAT_PARSE
+    if (fastFltParse(stri, &result)) {
+      buffer_ptr = NULL;
+    } else
+#endif
     if (likely(stri->size <= MAX_CSTRI_BUFFER_LEN)) {
       cstri = NULL;
       buffer_ptr = conv_to_cstri(buffer, stri);
@@ -1290,6 +1724,9 @@ floatType fltParse (const const_striType stri)
     } else {
       cstri = stri_to_cstri(stri, &err_info);
       buffer_ptr = cstri;
+      if (unlikely(buffer_ptr == NULL)) {
+        result = 0.0;
+      } /* if */
     } /* if */
     if (likely(buffer_ptr != NULL)) {
       if (isspace(buffer_ptr[0])) {
@@ -1664,6 +2101,11 @@ striType fltSci (floatType number, intType precision)
         buffer_ptr = "-Infinity";
         len = STRLEN("-Infinity");
       } else {
+#if EXACT_DECIMAL_CONVERSION
+        if ((len = exactSciToCharBuffer(number, precision, buffer)) != 0) {
+          /* The exact conversion did not need sprintf(). */
+        } else
+#endif
 #ifdef LIMIT_FMT_E_MAXIMUM_FLOAT_PRECISION
         if (unlikely(precision > PRINTF_FMT_E_MAXIMUM_FLOAT_PRECISION)) {
           len = (memSizeType) sprintf(buffer, "%1."
@@ -199,6 +199,11 @@ striType growStri (striType stri, memSizeType len)
         newCapacity = MIN_GROW_SHRINK_CAPACITY;
       } else if (unlikely(newCapacity > MAX_STRI_LEN)) {
         newCapacity = MAX_STRI_LEN;
+#if WITH_STRI_FREELIST
+      } else if (newCapacity <= MAX_STRI_CAPACITY_IN_FREELIST) {
+        /* The string can be reused via the free list of its size class. */
+        newCapacity = STRI_FREELIST_CAPACITY(newCapacity);
+#endif
       } /* if */
       /* printf("growStri(" FMT_X_MEM ", " FMT_U_MEM
              ") size=" FMT_U_MEM ", capacity=" FMT_U_MEM ", newCapacity="
@@ -253,6 +258,11 @@ striType shrinkStri (striType stri, memSizeType len)
 
   /* shrinkStri */
     newCapacity = 2 * len;
+#if WITH_STRI_FREELIST
+    if (newCapacity <= MAX_STRI_CAPACITY_IN_FREELIST) {
+      newCapacity = STRI_FREELIST_CAPACITY(newCapacity);
+    } /* if */
+#endif
     /* printf("shrinkStri(%lX, %lu) size=%u, capacity=%u, newCapacity=%u, siz_stri=%u, sizeof=%u\n",
          stri, len, stri->size, stri->capacity, newCapacity, SIZ_STRI(newCapacity), sizeof(striRecord));
     fflush(stdout); */
@@ -290,6 +300,7 @@ void freeStriFreelist (void)
       } /* while */
       sflist[capacity] = NULL;
     } /* for */
+    sflist_bytes = 0;
 #else
     elem = sflist;
     while (elem != NULL) {
@@ -301,31 +312,48 @@ void freeStriFreelist (void)
     sflist = NULL;
 #endif
   } /* freeStriFreelist */
+#endif
 
 
 
+#if WITH_STRI_FREELIST
+/**
+ *  Write the state of the string free lists to stdout.
+ *  For every free list the capacity, the number of strings in the
+ *  list, the maximum number of strings in the list and the number
+ *  of allocations that have been served from the list (hits) or
+ *  from the heap (misses) are written. At the end the number of
+ *  bytes, which are kept in all lists together, is written.
+ */
 void freelistStatistic (void)
 
   {
     freeListElemType elem;
 #if WITH_STRI_CAPACITY
-    memSizeType capacity;
-    unsigned int sflist_size[STRI_FREELIST_ARRAY_SIZE];
-#else
-    unsigned int sflist_size;
+    memSizeType index;
 #endif
+    unsigned int sflist_size;
 
   /* freelistStatistic */
 #if WITH_STRI_CAPACITY
-    for (capacity = 0; capacity < STRI_FREELIST_ARRAY_SIZE; capacity++) {
-      sflist_size[capacity] = sflist_allowed[capacity];
-      elem = sflist[capacity];
+    printf("capacity     size    limit          hits        misses\n");
+    for (index = 0; index < STRI_FREELIST_ARRAY_SIZE; index++) {
+      sflist_size = 0;
+      elem = sflist[index];
       while (elem != NULL) {
         elem = elem->next;
-        sflist_size[capacity]++;
+        sflist_size++;
       } /* while */
-      printf("sflist_size[" FMT_U_MEM "]: %u\n", capacity, sflist_size[capacity]);
+      if (sflist_size != 0 || sflist_hits[index] != 0 ||
+          sflist_misses[index] != 0) {
+        printf(F_U_MEM(8) " %8u %8u %13lu %13lu\n",
+               STRI_FREELIST_INDEX_CAPACITY(index), sflist_size,
+               sflist_size + sflist_allowed[index], sflist_hits[index],
+               sflist_misses[index]);
+      } /* if */
     } /* for */
+    printf("bytes in free lists: " FMT_U_MEM " (limit %u)\n",
+           sflist_bytes, MAX_SFLIST_BYTES);
 #else
     sflist_size = sflist_allowed;
     elem = sflist;
@@ -345,5 +373,8 @@ void heapStatistic (void)
 
   { /* heapStatistic */
     printf("heap statistic not supported - Set DO_HEAP_STATISTIC in config.h, when you compile Seed7.\n");
+#if WITH_STRI_FREELIST
+    freelistStatistic();
+#endif
   } /* heapStatistic */
 #endif
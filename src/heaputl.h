@@ -172,8 +172,10 @@ EXTERN memSizeType hs;
 #define BSTRI_SUB(len)         count.bstri--, count.bstri_elems -= (memSizeType) (len)
 #define ARR_ADD(len)           count.array++, count.arr_elems += (memSizeType) (len)
 #define ARR_SUB(len)           count.array--, count.arr_elems -= (memSizeType) (len)
-#define HSH_ADD(len)           count.hash++,  count.hsh_elems += (memSizeType) (len)
-#define HSH_SUB(len)           count.hash--,  count.hsh_elems -= (memSizeType) (len)
+#define HSH_ADD                count.hash++
+#define HSH_SUB                count.hash--
+#define HSH_TAB_ADD(len)       count.hsh_elems += (memSizeType) (len)
+#define HSH_TAB_SUB(len)       count.hsh_elems -= (memSizeType) (len)
 #define SET_ADD(len)           count.set++,   count.set_elems += (memSizeType) (len)
 #define SET_SUB(len)           count.set--,   count.set_elems -= (memSizeType) (len)
 #define SCT_ADD(len)           count.stru++,  count.sct_elems += (memSizeType) (len)
@@ -190,8 +192,10 @@ EXTERN memSizeType hs;
 #define RTL_L_ELEM_SUB
 #define RTL_ARR_ADD(len)       count.array++, count.rtl_arr_elems += (memSizeType) (len)
 #define RTL_ARR_SUB(len)       count.array--, count.rtl_arr_elems -= (memSizeType) (len)
-#define RTL_HSH_ADD(len)       count.hash++,  count.hsh_elems += (memSizeType) (len)
-#define RTL_HSH_SUB(len)       count.hash--,  count.hsh_elems -= (memSizeType) (len)
+#define RTL_HSH_ADD            count.hash++
+#define RTL_HSH_SUB            count.hash--
+#define RTL_HSH_TAB_ADD(len)   count.hsh_elems += (memSizeType) (len)
+#define RTL_HSH_TAB_SUB(len)   count.hsh_elems -= (memSizeType) (len)
 #else
 #define USTRI_ADD(len,cnt,byt)
 #define USTRI_SUB(len,cnt,byt)
@@ -201,8 +205,10 @@ EXTERN memSizeType hs;
 #define BSTRI_SUB(len)
 #define ARR_ADD(len)
 #define ARR_SUB(len)
-#define HSH_ADD(len)
-#define HSH_SUB(len)
+#define HSH_ADD
+#define HSH_SUB
+#define HSH_TAB_ADD(len)
+#define HSH_TAB_SUB(len)
 #define SET_ADD(len)
 #define SET_SUB(len)
 #define SCT_ADD(len)
@@ -219,8 +225,10 @@ EXTERN memSizeType hs;
 #define RTL_L_ELEM_SUB
 #define RTL_ARR_ADD(len)
 #define RTL_ARR_SUB(len)
-#define RTL_HSH_ADD(len)
-#define RTL_HSH_SUB(len)
+#define RTL_HSH_ADD
+#define RTL_HSH_SUB
+#define RTL_HSH_TAB_ADD(len)
+#define RTL_HSH_TAB_SUB(len)
 #endif
 
 
@@ -249,7 +257,8 @@ EXTERN memSizeType hs;
 #define SIZ_STRI(len)    ((sizeof(striRecord)     - sizeof(strElemType))  + (len) * sizeof(strElemType))
 #define SIZ_BSTRI(len)   ((sizeof(bstriRecord)    - sizeof(ucharType))    + (len) * sizeof(ucharType))
 #define SIZ_ARR(len)     ((sizeof(arrayRecord)    - sizeof(objectRecord)) + (len) * sizeof(objectRecord))
-#define SIZ_HSH(len)     ((sizeof(hashRecord)     - sizeof(hashElemType)) + (len) * sizeof(hashElemType))
+#define SIZ_HSH          (sizeof(hashRecord))
+#define SIZ_HSH_TAB(len) ((len) * sizeof(hashElemType))
 #define SIZ_SET(len)     ((sizeof(setRecord)      - sizeof(bitSetType))   + (len) * sizeof(bitSetType))
 #define SIZ_SCT(len)     ((sizeof(structRecord)   - sizeof(objectRecord)) + (len) * sizeof(objectRecord))
 #define SIZ_BIG(len)     ((sizeof_bigIntRecord    - sizeof_bigDigitType)  + (len) * sizeof_bigDigitType)
@@ -257,7 +266,8 @@ EXTERN memSizeType hs;
 #define SIZ_TAB(tp, nr)  (sizeof(tp) * (nr))
 #define SIZ_RTL_L_ELEM   (sizeof(rtlListRecord))
 #define SIZ_RTL_ARR(len) ((sizeof(rtlArrayRecord) - sizeof(rtlObjectType))   + (len) * sizeof(rtlObjectType))
-#define SIZ_RTL_HSH(len) ((sizeof(rtlHashRecord)  - sizeof(rtlHashElemType)) + (len) * sizeof(rtlHashElemType))
+#define SIZ_RTL_HSH      (sizeof(rtlHashRecord))
+#define SIZ_RTL_HSH_TAB(len) ((len) * sizeof(rtlHashElemType))
 
 #define MAX_USTRI_LEN   (MAX_MEMSIZETYPE - NULL_TERMINATION_LEN)
 #define MAX_CSTRI_LEN   (MAX_MEMSIZETYPE - NULL_TERMINATION_LEN)
@@ -294,8 +304,10 @@ EXTERN memSizeType hs;
 #define CNT2_BSTRI(len,size)   CALC_HS(HS_SUB(size), BSTRI_SUB(len)   H_LOG2(size))
 #define CNT1_ARR(len,size)     CALC_HS(HS_ADD(size), ARR_ADD(len)     H_LOG1(size))
 #define CNT2_ARR(len,size)     CALC_HS(HS_SUB(size), ARR_SUB(len)     H_LOG2(size))
-#define CNT1_HSH(len,size)     CALC_HS(HS_ADD(size), HSH_ADD(len)     H_LOG1(size))
-#define CNT2_HSH(len,size)     CALC_HS(HS_SUB(size), HSH_SUB(len)     H_LOG2(size))
+#define CNT1_HSH(size)         CALC_HS(HS_ADD(size), HSH_ADD          H_LOG1(size))
+#define CNT2_HSH(size)         CALC_HS(HS_SUB(size), HSH_SUB          H_LOG2(size))
+#define CNT1_HSH_TAB(len,size) CALC_HS(HS_ADD(size), HSH_TAB_ADD(len) H_LOG1(size))
+#define CNT2_HSH_TAB(len,size) CALC_HS(HS_SUB(size), HSH_TAB_SUB(len) H_LOG2(size))
 #define CNT1_SET(len,size)     CALC_HS(HS_ADD(size), SET_ADD(len)     H_LOG1(size))
 #define CNT2_SET(len,size)     CALC_HS(HS_SUB(size), SET_SUB(len)     H_LOG2(size))
 #define CNT1_SCT(len,size)     CALC_HS(HS_ADD(size), SCT_ADD(len)     H_LOG1(size))
@@ -312,8 +324,10 @@ EXTERN memSizeType hs;
 #define CNT2_RTL_L_ELEM(size)  CALC_HS(HS_SUB(size), RTL_L_ELEM_SUB   H_LOG2(size))
 #define CNT1_RTL_ARR(len,size) CALC_HS(HS_ADD(size), RTL_ARR_ADD(len) H_LOG1(size))
 #define CNT2_RTL_ARR(len,size) CALC_HS(HS_SUB(size), RTL_ARR_SUB(len) H_LOG2(size))
-#define CNT1_RTL_HSH(len,size) CALC_HS(HS_ADD(size), RTL_HSH_ADD(len) H_LOG1(size))
-#define CNT2_RTL_HSH(len,size) CALC_HS(HS_SUB(size), RTL_HSH_SUB(len) H_LOG2(size))
+#define CNT1_RTL_HSH(size)     CALC_HS(HS_ADD(size), RTL_HSH_ADD      H_LOG1(size))
+#define CNT2_RTL_HSH(size)     CALC_HS(HS_SUB(size), RTL_HSH_SUB      H_LOG2(size))
+#define CNT1_RTL_HSH_TAB(len,size) CALC_HS(HS_ADD(size), RTL_HSH_TAB_ADD(len) H_LOG1(size))
+#define CNT2_RTL_HSH_TAB(len,size) CALC_HS(HS_SUB(size), RTL_HSH_TAB_SUB(len) H_LOG2(size))
 
 
 #define ALLOC_HEAP(var,tp,byt)     ((var = (tp) MALLOC(byt)) != NULL)
@@ -371,57 +385,90 @@ EXTERN memSizeType hs;
 #if WITH_STRI_FREELIST
 #if WITH_STRI_CAPACITY
 
+/* Strings with a capacity up to MAX_STRI_LEN_IN_FREELIST have a   */
+/* free list for every capacity. Up to MAX_STRI_CAPACITY_IN_FREELIST */
+/* the capacity is rounded up to a multiple of 8 (size class) and  */
+/* every size class has a free list.                                */
 #define MAX_STRI_LEN_IN_FREELIST 19
-#define STRI_FREELIST_ARRAY_SIZE MAX_STRI_LEN_IN_FREELIST + 1
+#define MAX_STRI_CAPACITY_IN_FREELIST 256
+#define STRI_FREELIST_ARRAY_SIZE ((MAX_STRI_CAPACITY_IN_FREELIST >> 3) + MAX_STRI_LEN_IN_FREELIST - 1)
+
+#define STRI_FREELIST_CAPACITY(len)         ((len) <= MAX_STRI_LEN_IN_FREELIST ? (len) : ((len) + 7) & ~(memSizeType) 7)
+#define STRI_FREELIST_INDEX(len)            ((len) <= MAX_STRI_LEN_IN_FREELIST ? (len) : (((len) + 7) >> 3) + MAX_STRI_LEN_IN_FREELIST - 2)
+#define STRI_FREELIST_INDEX_CAPACITY(index) ((index) <= MAX_STRI_LEN_IN_FREELIST ? (index) : ((index) - MAX_STRI_LEN_IN_FREELIST + 2) << 3)
+#define STRI_FREELIST_CAPACITY_OK(cap)      ((cap) <= MAX_STRI_LEN_IN_FREELIST || ((cap) <= MAX_STRI_CAPACITY_IN_FREELIST && ((cap) & 7) == 0))
 
 #ifdef DO_INIT
 freeListElemType sflist[STRI_FREELIST_ARRAY_SIZE] = {
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
     NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
     NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
 #if WITH_ADJUSTED_STRI_FREELIST
 unsigned int sflist_allowed[STRI_FREELIST_ARRAY_SIZE] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
     1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
     1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
 boolType sflist_was_full[STRI_FREELIST_ARRAY_SIZE] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 #else
 unsigned int sflist_allowed[STRI_FREELIST_ARRAY_SIZE] = {
     160, 40, 40, 40, 40, 40, 40, 40, 40, 40,
-    40, 40, 40, 40, 40, 40, 40, 40, 40, 40};
-#endif
+    40, 40, 40, 40, 40, 40, 40, 40, 40, 40,
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20};
+#endif
+unsigned long sflist_hits[STRI_FREELIST_ARRAY_SIZE];
+unsigned long sflist_misses[STRI_FREELIST_ARRAY_SIZE];
+memSizeType sflist_bytes = 0;
 #else
 EXTERN freeListElemType sflist[STRI_FREELIST_ARRAY_SIZE];
 EXTERN unsigned int sflist_allowed[STRI_FREELIST_ARRAY_SIZE];
 EXTERN boolType sflist_was_full[STRI_FREELIST_ARRAY_SIZE];
+EXTERN unsigned long sflist_hits[STRI_FREELIST_ARRAY_SIZE];
+EXTERN unsigned long sflist_misses[STRI_FREELIST_ARRAY_SIZE];
+EXTERN memSizeType sflist_bytes;
 #endif
 
-#define POP_STRI_OK(len)    (len) < STRI_FREELIST_ARRAY_SIZE && sflist[len] != NULL
-#define PUSH_STRI_OK(var)   (var)->capacity < STRI_FREELIST_ARRAY_SIZE && sflist_allowed[(var)->capacity] > 0
+/* The strings in all free lists together use at most MAX_SFLIST_BYTES. */
+/* This bounds the memory, which is kept by the free lists, independent */
+/* of the limits of the single lists.                                   */
+#define MAX_SFLIST_BYTES 4194304
 
-#define POP_STRI(var,len)   (var = (striType) sflist[len], sflist[len] = sflist[len]->next, sflist_allowed[len]++, TRUE)
-#define PUSH_STRI(var,len)  { ((freeListElemType) var)->next = sflist[len]; sflist[len] = (freeListElemType) var; sflist_allowed[len]--; }
+#define POP_STRI(var,index)  (var = (striType) sflist[index], sflist[index] = sflist[index]->next, sflist_allowed[index]++, sflist_bytes -= SIZ_STRI(STRI_FREELIST_INDEX_CAPACITY(index)), sflist_hits[index]++, TRUE)
+#define PUSH_STRI(var,index) { ((freeListElemType) var)->next = sflist[index]; sflist[index] = (freeListElemType) var; sflist_allowed[index]--; sflist_bytes += SIZ_STRI(STRI_FREELIST_INDEX_CAPACITY(index)); }
 
 #if WITH_ADJUSTED_STRI_FREELIST
-#define ADJUST_ALLOWED_LEN(len)  (sflist_was_full[len] ? (sflist_was_full[len]=0, sflist_allowed[len] < 65536 ? sflist_allowed[len]<<=1 : 0) : 0)
-
-#define ALLOC_SFLIST_STRI(var,len)     (ADJUST_ALLOWED_LEN(len), HEAP_ALLOC_STRI(var, len))
-#define FREE_SFLIST_STRI(var,len)      { sflist_was_full[len]=1; HEAP_FREE_STRI(var, len); }
-
-#define POP_OR_ALLOC_STRI(var,len)     (sflist[len] != NULL ? POP_STRI(var, len) : ALLOC_SFLIST_STRI(var,len))
-#define PUSH_OR_FREE_STRI(var,len)     { if (sflist_allowed[len] > 0) PUSH_STRI(var, len) else FREE_SFLIST_STRI(var, len) }
-
-#define ALLOC_STRI_SIZE_OK(var,len)    ((len) < STRI_FREELIST_ARRAY_SIZE ? POP_OR_ALLOC_STRI(var,len) : HEAP_ALLOC_STRI(var, len))
-#define ALLOC_STRI_CHECK_SIZE(var,len) ((len) < STRI_FREELIST_ARRAY_SIZE ? POP_OR_ALLOC_STRI(var,len) : ((len)<=MAX_STRI_LEN?HEAP_ALLOC_STRI(var, len):(var=NULL, FALSE)))
-#define FREE_STRI(var,len)  if ((var)->capacity < STRI_FREELIST_ARRAY_SIZE) PUSH_OR_FREE_STRI(var, (var)->capacity) else HEAP_FREE_STRI(var, len);
-
+/* A size class, which missed strings after strings have been freed */
+/* because it was full, doubles its limit. The size classes used by */
+/* a program grow until they satisfy its allocation mix. Big size   */
+/* classes have a lower maximum limit. The total memory is bounded */
+/* by MAX_SFLIST_BYTES.                                             */
+#define MAX_ALLOWED_IN_SFLIST(index)   ((index) <= MAX_STRI_LEN_IN_FREELIST ? 65536 : 8192)
+#define ADJUST_ALLOWED_LEN(index)      (sflist_was_full[index] ? (sflist_was_full[index]=0, sflist_allowed[index] < MAX_ALLOWED_IN_SFLIST(index) ? sflist_allowed[index]<<=1 : 0) : 0)
+
+#define ALLOC_SFLIST_STRI(var,index,cap) (sflist_misses[index]++, ADJUST_ALLOWED_LEN(index), HEAP_ALLOC_STRI(var, cap))
+#define FREE_SFLIST_STRI(var,len)        { if (sflist_bytes < MAX_SFLIST_BYTES) sflist_was_full[STRI_FREELIST_INDEX((var)->capacity)]=1; HEAP_FREE_STRI(var, len); }
 #else
-
-#define ALLOC_STRI_SIZE_OK(var,len)    (POP_STRI_OK(len) ? POP_STRI(var, len) : HEAP_ALLOC_STRI(var, len))
-#define ALLOC_STRI_CHECK_SIZE(var,len) (POP_STRI_OK(len) ? POP_STRI(var, len) : ((len)<=MAX_STRI_LEN?HEAP_ALLOC_STRI(var, len):(var=NULL, FALSE)))
-#define FREE_STRI(var,len)  if (PUSH_STRI_OK(var)) PUSH_STRI(var, (var)->capacity) else HEAP_FREE_STRI(var, len);
+#define ALLOC_SFLIST_STRI(var,index,cap) (sflist_misses[index]++, HEAP_ALLOC_STRI(var, cap))
+#define FREE_SFLIST_STRI(var,len)        HEAP_FREE_STRI(var, len);
 #endif
 
+#define POP_OR_ALLOC_STRI(var,index,cap) (sflist[index] != NULL ? POP_STRI(var, index) : ALLOC_SFLIST_STRI(var, index, cap))
+#define PUSH_OR_FREE_STRI(var,len)       { if (sflist_allowed[STRI_FREELIST_INDEX((var)->capacity)] > 0 && sflist_bytes < MAX_SFLIST_BYTES) PUSH_STRI(var, STRI_FREELIST_INDEX((var)->capacity)) else FREE_SFLIST_STRI(var, len) }
+
+#define ALLOC_STRI_SIZE_OK(var,len)    ((len) <= MAX_STRI_CAPACITY_IN_FREELIST ? POP_OR_ALLOC_STRI(var, STRI_FREELIST_INDEX(len), STRI_FREELIST_CAPACITY(len)) : HEAP_ALLOC_STRI(var, len))
+#define ALLOC_STRI_CHECK_SIZE(var,len) ((len) <= MAX_STRI_CAPACITY_IN_FREELIST ? POP_OR_ALLOC_STRI(var, STRI_FREELIST_INDEX(len), STRI_FREELIST_CAPACITY(len)) : ((len)<=MAX_STRI_LEN?HEAP_ALLOC_STRI(var, len):(var=NULL, FALSE)))
+#define FREE_STRI(var,len)  if (STRI_FREELIST_CAPACITY_OK((var)->capacity)) PUSH_OR_FREE_STRI(var, len) else HEAP_FREE_STRI(var, len);
+
 #else
 
 #define MAX_STRI_LEN_IN_FREELIST 1
@@ -501,28 +548,42 @@ EXTERN unsigned int sflist_allowed;
 #define FREE_RTL_L_ELEM(var)       (CNT(CNT2_RTL_L_ELEM(SIZ_RTL_L_ELEM)) FREE_HEAP(var, SIZ_RTL_L_ELEM))
 
 
-#define ALLOC_ARRAY(var,len)       (ALLOC_HEAP(var, arrayType, SIZ_ARR(len))?CNT(CNT1_ARR(len, SIZ_ARR(len))) TRUE:FALSE)
-#define FREE_ARRAY(var,len)        (CNT(CNT2_ARR(len, SIZ_ARR(len))) FREE_HEAP(var, SIZ_ARR(len)))
-#define REALLOC_ARRAY(var,ln1,ln2) REALLOC_HEAP(var, arrayType, SIZ_ARR(ln2))
-#define COUNT3_ARRAY(len1,len2)    CNT3(CNT2_ARR(len1, SIZ_ARR(len1)), CNT1_ARR(len2, SIZ_ARR(len2)))
+#define MIN_GROW_SHRINK_ARRAY_CAPACITY 8
+
+#define ALLOC_ARRAY(var,len)           (ALLOC_HEAP(var, arrayType, SIZ_ARR(len))?((var)->capacity=(len), CNT(CNT1_ARR(len, SIZ_ARR(len))) TRUE):FALSE)
+#define FREE_ARRAY(var,len)            (CNT(CNT2_ARR((var)->capacity, SIZ_ARR((var)->capacity))) FREE_HEAP(var, SIZ_ARR((var)->capacity)))
+#define REALLOC_ARRAY(v1,v2,cap1,cap2) ((v2)->capacity=(cap2),(v1=REALLOC_HEAP(v2, arrayType, SIZ_ARR((v2)->capacity)))==NULL?((v2)->capacity=(cap1),0):0)
+#define COUNT3_ARRAY(cap1,cap2)        CNT3(CNT2_ARR(cap1, SIZ_ARR(cap1)), CNT1_ARR(cap2, SIZ_ARR(cap2)))
+#define GROW_ARRAY(v1,v2,len)          ((len)>(v2)->capacity?(v1=growArray(v2,len)):(v1=(v2)))
+#define SHRINK_ARRAY(v1,v2,len)        ((v2)->capacity>MIN_GROW_SHRINK_ARRAY_CAPACITY&&(len)<(v2)->capacity>>2?(v1=shrinkArray(v2,len)):(v1=(v2)))
 
 
-#define ALLOC_RTL_ARRAY(var,len)       (ALLOC_HEAP(var, rtlArrayType, SIZ_RTL_ARR(len))?CNT(CNT1_RTL_ARR(len, SIZ_RTL_ARR(len))) TRUE:FALSE)
-#define FREE_RTL_ARRAY(var,len)        (CNT(CNT2_RTL_ARR(len, SIZ_RTL_ARR(len))) FREE_HEAP(var, SIZ_RTL_ARR(len)))
-#define REALLOC_RTL_ARRAY(var,ln1,ln2) REALLOC_HEAP(var, rtlArrayType, SIZ_RTL_ARR(ln2))
-#define COUNT3_RTL_ARRAY(len1,len2)    CNT3(CNT2_RTL_ARR(len1, SIZ_RTL_ARR(len1)), CNT1_RTL_ARR(len2, SIZ_RTL_ARR(len2)))
+#define ALLOC_RTL_ARRAY(var,len)           (ALLOC_HEAP(var, rtlArrayType, SIZ_RTL_ARR(len))?((var)->capacity=(len), CNT(CNT1_RTL_ARR(len, SIZ_RTL_ARR(len))) TRUE):FALSE)
+#define FREE_RTL_ARRAY(var,len)            (CNT(CNT2_RTL_ARR((var)->capacity, SIZ_RTL_ARR((var)->capacity))) FREE_HEAP(var, SIZ_RTL_ARR((var)->capacity)))
+#define REALLOC_RTL_ARRAY(v1,v2,cap1,cap2) ((v2)->capacity=(cap2),(v1=REALLOC_HEAP(v2, rtlArrayType, SIZ_RTL_ARR((v2)->capacity)))==NULL?((v2)->capacity=(cap1),0):0)
+#define COUNT3_RTL_ARRAY(cap1,cap2)        CNT3(CNT2_RTL_ARR(cap1, SIZ_RTL_ARR(cap1)), CNT1_RTL_ARR(cap2, SIZ_RTL_ARR(cap2)))
+#define GROW_RTL_ARRAY(v1,v2,len)          ((len)>(v2)->capacity?(v1=growRtlArray(v2,len)):(v1=(v2)))
+#define SHRINK_RTL_ARRAY(v1,v2,len)        ((v2)->capacity>MIN_GROW_SHRINK_ARRAY_CAPACITY&&(len)<(v2)->capacity>>2?(v1=shrinkRtlArray(v2,len)):(v1=(v2)))
 
 
-#define ALLOC_HASH(var,len)        (ALLOC_HEAP(var, hashType, SIZ_HSH(len))?CNT(CNT1_HSH(len, SIZ_HSH(len))) TRUE:FALSE)
-#define FREE_HASH(var,len)         (CNT(CNT2_HSH(len, SIZ_HSH(len))) FREE_HEAP(var, SIZ_HSH(len)))
-#define REALLOC_HASH(var,ln1,ln2)  REALLOC_HEAP(var, hashType, SIZ_HSH(ln2))
-#define COUNT3_HASH(len1,len2)     CNT3(CNT2_HSH(len1, SIZ_HSH(len1)), CNT1_HSH(len2, SIZ_HSH(len2)))
+#define ALLOC_HASH(var)            (ALLOC_HEAP(var, hashType, SIZ_HSH)?CNT(CNT1_HSH(SIZ_HSH)) TRUE:FALSE)
+#define FREE_HASH(var)             (CNT(CNT2_HSH(SIZ_HSH)) FREE_HEAP(var, SIZ_HSH))
 
 
-#define ALLOC_RTL_HASH(var,len)       (ALLOC_HEAP(var, rtlHashType, SIZ_RTL_HSH(len))?CNT(CNT1_RTL_HSH(len, SIZ_RTL_HSH(len))) TRUE:FALSE)
-#define FREE_RTL_HASH(var,len)        (CNT(CNT2_RTL_HSH(len, SIZ_RTL_HSH(len))) FREE_HEAP(var, SIZ_RTL_HSH(len)))
-#define REALLOC_RTL_HASH(var,ln1,ln2) REALLOC_HEAP(var, rtlHashType, SIZ_RTL_HSH(ln2))
-#define COUNT3_RTL_HASH(len1,len2)    CNT3(CNT2_RTL_HSH(len1, SIZ_RTL_HSH(len1)), CNT1_RTL_HSH(len2, SIZ_RTL_HSH(len2)))
+#define ALLOC_HASH_TABLE(var,len)        (ALLOC_HEAP(var, hashElemType *, SIZ_HSH_TAB(len))?CNT(CNT1_HSH_TAB(len, SIZ_HSH_TAB(len))) TRUE:FALSE)
+#define FREE_HASH_TABLE(var,len)         (CNT(CNT2_HSH_TAB(len, SIZ_HSH_TAB(len))) FREE_HEAP(var, SIZ_HSH_TAB(len)))
+#define REALLOC_HASH_TABLE(var,ln1,ln2)  REALLOC_HEAP(var, hashElemType *, SIZ_HSH_TAB(ln2))
+#define COUNT3_HASH_TABLE(len1,len2)     CNT3(CNT2_HSH_TAB(len1, SIZ_HSH_TAB(len1)), CNT1_HSH_TAB(len2, SIZ_HSH_TAB(len2)))
+
+
+#define ALLOC_RTL_HASH(var)           (ALLOC_HEAP(var, rtlHashType, SIZ_RTL_HSH)?CNT(CNT1_RTL_HSH(SIZ_RTL_HSH)) TRUE:FALSE)
+#define FREE_RTL_HASH(var)            (CNT(CNT2_RTL_HSH(SIZ_RTL_HSH)) FREE_HEAP(var, SIZ_RTL_HSH))
+
+
+#define ALLOC_RTL_HASH_TABLE(var,len)       (ALLOC_HEAP(var, rtlHashElemType *, SIZ_RTL_HSH_TAB(len))?CNT(CNT1_RTL_HSH_TAB(len, SIZ_RTL_HSH_TAB(len))) TRUE:FALSE)
+#define FREE_RTL_HASH_TABLE(var,len)        (CNT(CNT2_RTL_HSH_TAB(len, SIZ_RTL_HSH_TAB(len))) FREE_HEAP(var, SIZ_RTL_HSH_TAB(len)))
+#define REALLOC_RTL_HASH_TABLE(var,ln1,ln2) REALLOC_HEAP(var, rtlHashElemType *, SIZ_RTL_HSH_TAB(ln2))
+#define COUNT3_RTL_HASH_TABLE(len1,len2)    CNT3(CNT2_RTL_HSH_TAB(len1, SIZ_RTL_HSH_TAB(len1)), CNT1_RTL_HSH_TAB(len2, SIZ_RTL_HSH_TAB(len2)))
 
 
 #define ALLOC_SET(var,len)         (ALLOC_HEAP(var, setType, SIZ_SET(len))?CNT(CNT1_SET(len, SIZ_SET(len))) TRUE:FALSE)
@@ -574,6 +635,9 @@ striType shrinkStri (striType stri, memSizeType len);
 #if DO_HEAP_CHECK
 void check_heap (long, const char *, unsigned int);
 #endif
+#if WITH_STRI_FREELIST
+void freelistStatistic (void);
+#endif
 #if !DO_HEAP_STATISTIC
 void heapStatistic (void);
 #endif
@@ -59,9 +59,15 @@
 #include "hsh_rtl.h"
 
 
-#define TABLE_BITS 10
+/* The hash table grows and shrinks with linear hashing. The  */
+/* buckets below the split position use bits + 1 bits of the   */
+/* hashcode. The table has space for TABLE_SIZE(bits + 1)      */
+/* buckets and table_size of them are in use.                  */
+#define TABLE_BITS 4
+#define MAX_TABLE_BITS 30
 #define TABLE_SIZE(bits) ((unsigned int) 1 << (bits))
 #define TABLE_MASK(bits) (TABLE_SIZE(bits)-1)
+#define TABLE_CAPACITY(hash) TABLE_SIZE((hash)->bits + 1)
 
 
 
@@ -109,15 +115,16 @@ static void free_hash (const const_rtlHashType old_hash,
           to_free -= free_helem(table[number], key_destr_func, data_destr_func);
         } while (to_free != 0);
       } /* if */
-      FREE_RTL_HASH(old_hash, old_hash->table_size);
+      FREE_RTL_HASH_TABLE(old_hash->table, TABLE_CAPACITY(old_hash));
+      FREE_RTL_HASH(old_hash);
     } /* if */
   } /* free_hash */
 
 
 
 static rtlHashElemType new_helem (genericType key, genericType data,
-    const createFuncType key_create_func, const createFuncType data_create_func,
-    errInfoType *err_info)
+    intType hashcode, const createFuncType key_create_func,
+    const createFuncType data_create_func, errInfoType *err_info)
 
   {
     rtlHashElemType helem;
@@ -131,6 +138,7 @@ static rtlHashElemType new_helem (genericType key, genericType data,
       helem->data.value.genericValue = data_create_func(data);
       helem->next_less = NULL;
       helem->next_greater = NULL;
+      helem->hashcode = hashcode;
       /* printf("new_helem(" FMT_U_GEN ", " FMT_U_GEN ")\n",
           helem->key.value.genericValue,
           helem->data.value.genericValue); */
@@ -146,12 +154,17 @@ static rtlHashType new_hash (unsigned int bits)
     rtlHashType hash;
 
   /* new_hash */
-    if (likely(ALLOC_RTL_HASH(hash, TABLE_SIZE(bits)))) {
-      hash->bits = bits;
-      hash->mask = TABLE_MASK(bits);
-      hash->table_size = TABLE_SIZE(bits);
-      hash->size = 0;
-      memset(hash->table, 0, hash->table_size * sizeof(rtlHashElemType));
+    if (likely(ALLOC_RTL_HASH(hash))) {
+      if (unlikely(!ALLOC_RTL_HASH_TABLE(hash->table, TABLE_SIZE(bits + 1)))) {
+        FREE_RTL_HASH(hash);
+        hash = NULL;
+      } else {
+        hash->bits = bits;
+        hash->mask = TABLE_MASK(bits);
+        hash->table_size = TABLE_SIZE(bits);
+        hash->size = 0;
+        memset(hash->table, 0, TABLE_SIZE(bits + 1) * sizeof(rtlHashElemType));
+      } /* if */
     } /* if */
     return hash;
   } /* new_hash */
@@ -173,6 +186,7 @@ static rtlHashElemType create_helem (const const_rtlHashElemType source_helem,
           key_create_func(source_helem->key.value.genericValue);
       dest_helem->data.value.genericValue =
           data_create_func(source_helem->data.value.genericValue);
+      dest_helem->hashcode = source_helem->hashcode;
       if (source_helem->next_less != NULL) {
         dest_helem->next_less = create_helem(source_helem->next_less,
             key_create_func, data_create_func, err_info);
@@ -204,13 +218,20 @@ static rtlHashType create_hash (const const_rtlHashType source_hash,
 
   /* create_hash */
     table_size = source_hash->table_size;
-    if (unlikely(!ALLOC_RTL_HASH(dest_hash, table_size))) {
+    if (unlikely(!ALLOC_RTL_HASH(dest_hash))) {
+      *err_info = MEMORY_ERROR;
+    } else if (unlikely(!ALLOC_RTL_HASH_TABLE(dest_hash->table,
+                                              TABLE_CAPACITY(source_hash)))) {
+      FREE_RTL_HASH(dest_hash);
+      dest_hash = NULL;
       *err_info = MEMORY_ERROR;
     } else {
       dest_hash->bits = source_hash->bits;
       dest_hash->mask = source_hash->mask;
       dest_hash->table_size = table_size;
       dest_hash->size = source_hash->size;
+      memset(&dest_hash->table[table_size], 0,
+             (TABLE_CAPACITY(source_hash) - table_size) * sizeof(rtlHashElemType));
       if (source_hash->size == 0) {
         memset(dest_hash->table, 0, table_size * sizeof(rtlHashElemType));
       } else {
@@ -277,6 +298,212 @@ static void copy_hash (const rtlHashType dest_hash, const const_rtlHashType sour
 
 
 
+/**
+ *  Determine the bucket of 'hashcode' in the table of 'aHashMap'.
+ *  Buckets below the split position have already been split.
+ *  They use one more bit of the hashcode.
+ */
+static inline unsigned int table_pos (const const_rtlHashType aHashMap,
+    const intType hashcode)
+
+  {
+    unsigned int pos;
+
+  /* table_pos */
+    pos = (unsigned int) hashcode & aHashMap->mask;
+    if (pos < aHashMap->table_size - TABLE_SIZE(aHashMap->bits)) {
+      pos = (unsigned int) hashcode & (aHashMap->mask << 1 | 1);
+    } /* if */
+    return pos;
+  } /* table_pos */
+
+
+
+/**
+ *  Convert the tree 'curr_helem' to a list linked with next_greater.
+ *  The list is in tree order and it is prepended to 'list'.
+ *  @return the head of the list.
+ */
+static rtlHashElemType helem_tree_to_list (rtlHashElemType curr_helem,
+    rtlHashElemType list)
+
+  {
+    rtlHashElemType next_helem;
+
+  /* helem_tree_to_list */
+    while (curr_helem != NULL) {
+      if (curr_helem->next_greater != NULL) {
+        list = helem_tree_to_list(curr_helem->next_greater, list);
+      } /* if */
+      next_helem = curr_helem->next_less;
+      curr_helem->next_less = NULL;
+      curr_helem->next_greater = list;
+      list = curr_helem;
+      curr_helem = next_helem;
+    } /* while */
+    return list;
+  } /* helem_tree_to_list */
+
+
+
+/**
+ *  Build a balanced tree from the first 'length' elements of '*list'.
+ *  The list must be in tree order. No comparisons are necessary.
+ *  Afterwards '*list' refers to the element after the tree elements.
+ *  @return the root of the tree.
+ */
+static rtlHashElemType helem_list_to_tree (rtlHashElemType *list,
+    memSizeType length)
+
+  {
+    rtlHashElemType less_helems;
+    rtlHashElemType root;
+
+  /* helem_list_to_tree */
+    if (length == 0) {
+      root = NULL;
+    } else {
+      less_helems = helem_list_to_tree(list, length >> 1);
+      root = *list;
+      *list = root->next_greater;
+      root->next_less = less_helems;
+      root->next_greater = helem_list_to_tree(list, length - (length >> 1) - 1);
+    } /* if */
+    return root;
+  } /* helem_list_to_tree */
+
+
+
+/**
+ *  Grow the table of 'aHashMap' by splitting one bucket.
+ *  The elements of the bucket are relinked, which takes time
+ *  proportional to the size of the bucket. Doubling the table
+ *  memory is done with a realloc() of the bucket pointers.
+ *  If there is not enough memory the table is left unchanged.
+ */
+static void grow_hash (const rtlHashType aHashMap)
+
+  {
+    rtlHashElemType *resized_table;
+    unsigned int split_pos;
+    unsigned int split_bit;
+    rtlHashElemType helem;
+    rtlHashElemType lower_list;
+    rtlHashElemType upper_list;
+    rtlHashElemType *lower_tail;
+    rtlHashElemType *upper_tail;
+    memSizeType lower_length = 0;
+    memSizeType upper_length = 0;
+
+  /* grow_hash */
+    if (aHashMap->table_size == TABLE_CAPACITY(aHashMap) &&
+        aHashMap->bits < MAX_TABLE_BITS) {
+      resized_table = REALLOC_RTL_HASH_TABLE(aHashMap->table,
+          TABLE_SIZE(aHashMap->bits + 1), TABLE_SIZE(aHashMap->bits + 2));
+      if (resized_table != NULL) {
+        COUNT3_RTL_HASH_TABLE(TABLE_SIZE(aHashMap->bits + 1),
+                              TABLE_SIZE(aHashMap->bits + 2));
+        aHashMap->table = resized_table;
+        aHashMap->bits++;
+        aHashMap->mask = TABLE_MASK(aHashMap->bits);
+        memset(&aHashMap->table[aHashMap->table_size], 0,
+               TABLE_SIZE(aHashMap->bits) * sizeof(rtlHashElemType));
+      } /* if */
+    } /* if */
+    if (aHashMap->table_size < TABLE_CAPACITY(aHashMap)) {
+      split_bit = TABLE_SIZE(aHashMap->bits);
+      split_pos = aHashMap->table_size - split_bit;
+      helem = helem_tree_to_list(aHashMap->table[split_pos], NULL);
+      lower_tail = &lower_list;
+      upper_tail = &upper_list;
+      while (helem != NULL) {
+        if (((unsigned int) helem->hashcode & split_bit) != 0) {
+          *upper_tail = helem;
+          upper_tail = &helem->next_greater;
+          upper_length++;
+        } else {
+          *lower_tail = helem;
+          lower_tail = &helem->next_greater;
+          lower_length++;
+        } /* if */
+        helem = helem->next_greater;
+      } /* while */
+      *lower_tail = NULL;
+      *upper_tail = NULL;
+      aHashMap->table[split_pos] =
+          helem_list_to_tree(&lower_list, lower_length);
+      aHashMap->table[split_pos + split_bit] =
+          helem_list_to_tree(&upper_list, upper_length);
+      aHashMap->table_size++;
+    } /* if */
+  } /* grow_hash */
+
+
+
+/**
+ *  Shrink the table of 'aHashMap' by merging the last bucket
+ *  into its buddy bucket. This reverses one split of grow_hash().
+ *  If there is not enough memory the table is left unchanged.
+ */
+static void shrink_hash (const rtlHashType aHashMap, compareType cmp_func)
+
+  {
+    rtlHashElemType *resized_table;
+    unsigned int last_pos;
+    rtlHashElemType list1;
+    rtlHashElemType list2;
+    rtlHashElemType merged_list;
+    rtlHashElemType *merged_tail;
+    memSizeType merged_length = 0;
+
+  /* shrink_hash */
+    if (aHashMap->table_size == TABLE_SIZE(aHashMap->bits)) {
+      resized_table = REALLOC_RTL_HASH_TABLE(aHashMap->table,
+          TABLE_SIZE(aHashMap->bits + 1), TABLE_SIZE(aHashMap->bits));
+      if (resized_table != NULL) {
+        COUNT3_RTL_HASH_TABLE(TABLE_SIZE(aHashMap->bits + 1),
+                              TABLE_SIZE(aHashMap->bits));
+        aHashMap->table = resized_table;
+        aHashMap->bits--;
+        aHashMap->mask = TABLE_MASK(aHashMap->bits);
+      } /* if */
+    } /* if */
+    if (aHashMap->table_size > TABLE_SIZE(aHashMap->bits)) {
+      last_pos = aHashMap->table_size - 1;
+      list1 = helem_tree_to_list(aHashMap->table[last_pos - TABLE_SIZE(aHashMap->bits)], NULL);
+      list2 = helem_tree_to_list(aHashMap->table[last_pos], NULL);
+      merged_tail = &merged_list;
+      while (list1 != NULL && list2 != NULL) {
+        /* In tree order an element comes before all elements, */
+        /* which are found in its next_greater subtree. */
+        if (cmp_func(list2->key.value.genericValue,
+                     list1->key.value.genericValue) < 0) {
+          *merged_tail = list1;
+          list1 = list1->next_greater;
+        } else {
+          *merged_tail = list2;
+          list2 = list2->next_greater;
+        } /* if */
+        merged_tail = &(*merged_tail)->next_greater;
+        merged_length++;
+      } /* while */
+      if (list1 == NULL) {
+        list1 = list2;
+      } /* if */
+      *merged_tail = list1;
+      while (list1 != NULL) {
+        merged_length++;
+        list1 = list1->next_greater;
+      } /* while */
+      aHashMap->table[last_pos - TABLE_SIZE(aHashMap->bits)] =
+          helem_list_to_tree(&merged_list, merged_length);
+      aHashMap->table[last_pos] = NULL;
+      aHashMap->table_size--;
+    } /* if */
+  } /* shrink_hash */
+
+
+
 static memSizeType keys_helem (const rtlArrayType key_array,
     memSizeType arr_pos, const_rtlHashElemType curr_helem,
     const createFuncType key_create_func)
@@ -490,7 +717,7 @@ boolType hshContains (const const_rtlHashType aHashMap, const genericType aKey,
   /* hshContains */
     logFunction(printf("hshContains(" FMT_X_MEM ", " FMT_U_GEN ", " FMT_U ")\n",
                        (memSizeType) aHashMap, aKey, hashcode););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
 /*
 printf("sizeof(hashelem->key.value.genericValue)=%lu\n",
@@ -533,7 +760,8 @@ void hshCpy (rtlHashType *const dest, const const_rtlHashType source,
   /* hshCpy */
     logFunction(printf("hshCpy(" FMT_X_MEM ", " FMT_X_MEM ")\n",
                        (memSizeType) *dest, (memSizeType) source););
-    if ((*dest)->table_size == source->table_size) {
+    if ((*dest)->table_size == source->table_size &&
+        (*dest)->bits == source->bits) {
       /* The following check avoids an error for: aHash := aHash; */
       if (*dest != source) {
         copy_hash(*dest, source,
@@ -637,8 +865,8 @@ void hshExcl (const rtlHashType aHashMap, const genericType aKey,
     logFunction(printf("hshExcl(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U ") size=" FMT_U_MEM "\n",
                        (memSizeType) aHashMap, aKey, hashcode, aHashMap->size););
-    delete_pos = &aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    delete_pos = &aHashMap->table[table_pos(aHashMap, hashcode)];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp = cmp_func(hashelem->key.value.genericValue, aKey);
       if (cmp < 0) {
@@ -663,6 +891,10 @@ void hshExcl (const rtlHashType aHashMap, const genericType aKey,
         old_hashelem->next_greater = NULL;
         free_helem(old_hashelem, key_destr_func, data_destr_func);
         aHashMap->size--;
+        if (aHashMap->size < aHashMap->table_size >> 1 &&
+            aHashMap->table_size > TABLE_SIZE(TABLE_BITS)) {
+          shrink_hash(aHashMap, cmp_func);
+        } /* if */
         hashelem = NULL;
       } else {
         delete_pos = &hashelem->next_greater;
@@ -694,7 +926,7 @@ genericType hshIdx (const const_rtlHashType aHashMap, const genericType aKey,
   /* hshIdx */
     logFunction(printf("hshIdx(" FMT_X_MEM ", " FMT_U_GEN ", " FMT_U ")\n",
                        (memSizeType) aHashMap, aKey, hashcode););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp = cmp_func(hashelem->key.value.genericValue, aKey);
       if (cmp < 0) {
@@ -744,7 +976,7 @@ rtlObjectType *hshIdxAddr (const const_rtlHashType aHashMap,
   /* hshIdxAddr */
     logFunction(printf("hshIdxAddr(" FMT_X_MEM ", " FMT_U_GEN ", " FMT_U ")\n",
                        (memSizeType) aHashMap, aKey, hashcode););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp = cmp_func(hashelem->key.value.genericValue, aKey);
       /* printf(". %llu %llu cmp=%d\n",
@@ -795,7 +1027,7 @@ rtlObjectType *hshIdxAddr2 (const const_rtlHashType aHashMap,
   /* hshIdxAddr2 */
     logFunction(printf("hshIdxAddr2(" FMT_X_MEM ", " FMT_U_GEN ", " FMT_U ")\n",
                        (memSizeType) aHashMap, aKey, hashcode););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp = cmp_func(hashelem->key.value.genericValue, aKey);
       /* printf(". %llu %llu cmp=%d\n",
@@ -846,19 +1078,19 @@ genericType hshIdxEnterDefault (const rtlHashType aHashMap,
     logFunction(printf("hshIdxEnterDefault(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U_GEN ", " FMT_U ")\n",
                        (memSizeType) aHashMap, aKey, defaultData, hashcode););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     if (hashelem == NULL) {
-      result_hashelem = new_helem(aKey, defaultData,
+      result_hashelem = new_helem(aKey, defaultData, hashcode,
           (createFuncType) &genericCreate,
           (createFuncType) &genericCreate, &err_info);
-      aHashMap->table[(unsigned int) hashcode & aHashMap->mask] = result_hashelem;
+      aHashMap->table[table_pos(aHashMap, hashcode)] = result_hashelem;
       aHashMap->size++;
     } else {
       do {
         /* printf("key=%llX\n", hashelem->key.value.genericValue); */
         if (hashelem->key.value.genericValue < aKey) {
           if (hashelem->next_less == NULL) {
-            result_hashelem = new_helem(aKey, defaultData,
+            result_hashelem = new_helem(aKey, defaultData, hashcode,
                 (createFuncType) &genericCreate,
                 (createFuncType) &genericCreate, &err_info);
             hashelem->next_less = result_hashelem;
@@ -872,7 +1104,7 @@ genericType hshIdxEnterDefault (const rtlHashType aHashMap,
           hashelem = NULL;
         } else {
           if (hashelem->next_greater == NULL) {
-            result_hashelem = new_helem(aKey, defaultData,
+            result_hashelem = new_helem(aKey, defaultData, hashcode,
                 (createFuncType) &genericCreate,
                 (createFuncType) &genericCreate, &err_info);
             hashelem->next_greater = result_hashelem;
@@ -890,6 +1122,9 @@ genericType hshIdxEnterDefault (const rtlHashType aHashMap,
       result = 0;
     } else {
       result = result_hashelem->data.value.genericValue;
+      if (aHashMap->size > aHashMap->table_size) {
+        grow_hash(aHashMap);
+      } /* if */
     } /* if */
     logFunction(printf("hshIdxEnterDefault(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U_GEN ", " FMT_U ") --> " FMT_U_GEN "\n",
@@ -920,7 +1155,7 @@ genericType hshIdxWithDefault (const const_rtlHashType aHashMap, const genericTy
     logFunction(printf("hshIdxWithDefault(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U_GEN ", " FMT_U ")\n",
                        (memSizeType) aHashMap, aKey, defaultData, hashcode););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp = cmp_func(hashelem->key.value.genericValue, aKey);
       if (cmp < 0) {
@@ -964,7 +1199,7 @@ genericType hshIdxDefault0 (const const_rtlHashType aHashMap, const genericType
   /* hshIdxDefault0 */
     logFunction(printf("hshIdxDefault0(" FMT_X_MEM ", " FMT_U_GEN ", " FMT_U ")\n",
                        (memSizeType) aHashMap, aKey, hashcode););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp = cmp_func(hashelem->key.value.genericValue, aKey);
       if (cmp < 0) {
@@ -1007,12 +1242,12 @@ void hshIncl (const rtlHashType aHashMap, const genericType aKey,
     logFunction(printf("hshIncl(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U_GEN ", " FMT_U ") size=" FMT_U_MEM "\n",
                        (memSizeType) aHashMap, aKey, data, hashcode, aHashMap->size););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     if (hashelem == NULL) {
-      aHashMap->table[(unsigned int) hashcode & aHashMap->mask] = new_helem(aKey, data,
-          key_create_func, data_create_func, &err_info);
+      aHashMap->table[table_pos(aHashMap, hashcode)] = new_helem(aKey, data,
+          hashcode, key_create_func, data_create_func, &err_info);
       /*
-      hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+      hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
       printf("aKey=%llX\n", (unsigned long long) aKey);
       printf("new hashelem: aKey=%llX, data=%llX\n",
           hashelem->key.value.intValue, hashelem->data.value.intValue);
@@ -1025,7 +1260,7 @@ void hshIncl (const rtlHashType aHashMap, const genericType aKey,
         if (cmp < 0) {
           if (hashelem->next_less == NULL) {
             hashelem->next_less = new_helem(aKey, data,
-                key_create_func, data_create_func, &err_info);
+                hashcode, key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             hashelem = NULL;
           } else {
@@ -1037,7 +1272,7 @@ void hshIncl (const rtlHashType aHashMap, const genericType aKey,
         } else {
           if (hashelem->next_greater == NULL) {
             hashelem->next_greater = new_helem(aKey, data,
-                key_create_func, data_create_func, &err_info);
+                hashcode, key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             hashelem = NULL;
           } else {
@@ -1049,6 +1284,8 @@ void hshIncl (const rtlHashType aHashMap, const genericType aKey,
     if (unlikely(err_info != OKAY_NO_ERROR)) {
       aHashMap->size--;
       raise_error(MEMORY_ERROR);
+    } else if (aHashMap->size > aHashMap->table_size) {
+      grow_hash(aHashMap);
     } /* if */
     logFunction(printf("hshIncl(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U_GEN ", " FMT_U ") size=" FMT_U_MEM " -->\n",
@@ -1132,10 +1369,10 @@ genericType hshUpdate (const rtlHashType aHashMap, const genericType aKey,
     logFunction(printf("hshUpdate(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U_GEN ", " FMT_U ") size=" FMT_U_MEM "\n",
                        (memSizeType) aHashMap, aKey, data, hashcode, aHashMap->size););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     if (hashelem == NULL) {
-      aHashMap->table[(unsigned int) hashcode & aHashMap->mask] = new_helem(aKey, data,
-          key_create_func, data_create_func, &err_info);
+      aHashMap->table[table_pos(aHashMap, hashcode)] = new_helem(aKey, data,
+          hashcode, key_create_func, data_create_func, &err_info);
       aHashMap->size++;
       result = data;
     } else {
@@ -1144,7 +1381,7 @@ genericType hshUpdate (const rtlHashType aHashMap, const genericType aKey,
         if (cmp < 0) {
           if (hashelem->next_less == NULL) {
             hashelem->next_less = new_helem(aKey, data,
-                key_create_func, data_create_func, &err_info);
+                hashcode, key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             result = data;
             hashelem = NULL;
@@ -1158,7 +1395,7 @@ genericType hshUpdate (const rtlHashType aHashMap, const genericType aKey,
         } else {
           if (hashelem->next_greater == NULL) {
             hashelem->next_greater = new_helem(aKey, data,
-                key_create_func, data_create_func, &err_info);
+                hashcode, key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             result = data;
             hashelem = NULL;
@@ -1171,6 +1408,8 @@ genericType hshUpdate (const rtlHashType aHashMap, const genericType aKey,
     if (unlikely(err_info != OKAY_NO_ERROR)) {
       aHashMap->size--;
       raise_error(MEMORY_ERROR);
+    } else if (aHashMap->size > aHashMap->table_size) {
+      grow_hash(aHashMap);
     } /* if */
     logFunction(printf("hshUpdate(" FMT_X_MEM ", " FMT_U_GEN ", "
                        FMT_U_GEN ", " FMT_U ") size=" FMT_U_MEM " -->\n",
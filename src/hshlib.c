@@ -53,9 +53,15 @@
 #include "hshlib.h"
 
 
-#define TABLE_BITS 10
+/* The hash table grows and shrinks with linear hashing. The  */
+/* buckets below the split position use bits + 1 bits of the   */
+/* hashcode. The table has space for TABLE_SIZE(bits + 1)      */
+/* buckets and table_size of them are in use.                  */
+#define TABLE_BITS 4
+#define MAX_TABLE_BITS 30
 #define TABLE_SIZE(bits) ((unsigned int) 1 << (bits))
 #define TABLE_MASK(bits) (TABLE_SIZE(bits)-1)
+#define TABLE_CAPACITY(hash) TABLE_SIZE((hash)->bits + 1)
 
 
 
@@ -109,13 +115,14 @@ static void free_hash (hashType old_hash, objectType key_destr_func,
           to_free -= free_helem(table[number], key_destr_func, data_destr_func);
         } while (to_free != 0);
       } /* if */
-      FREE_HASH(old_hash, old_hash->table_size);
+      FREE_HASH_TABLE(old_hash->table, TABLE_CAPACITY(old_hash));
+      FREE_HASH(old_hash);
     } /* if */
   } /* free_hash */
 
 
 
-static hashElemType new_helem (objectType key, objectType data,
+static hashElemType new_helem (objectType key, objectType data, intType hashcode,
     objectType key_create_func, objectType data_create_func, errInfoType *err_info)
 
   {
@@ -135,6 +142,7 @@ static hashElemType new_helem (objectType key, objectType data,
       param3_call(data_create_func, &helem->data, SYS_CREA_OBJECT, data);
       helem->next_less = NULL;
       helem->next_greater = NULL;
+      helem->hashcode = hashcode;
     } /* if */
     return helem;
   } /* new_helem */
@@ -147,12 +155,17 @@ static hashType new_hash (unsigned int bits)
     hashType hash;
 
   /* new_hash */
-    if (likely(ALLOC_HASH(hash, TABLE_SIZE(bits)))) {
-      hash->bits = bits;
-      hash->mask = TABLE_MASK(bits);
-      hash->table_size = TABLE_SIZE(bits);
-      hash->size = 0;
-      memset(hash->table, 0, hash->table_size * sizeof(hashElemType));
+    if (likely(ALLOC_HASH(hash))) {
+      if (unlikely(!ALLOC_HASH_TABLE(hash->table, TABLE_SIZE(bits + 1)))) {
+        FREE_HASH(hash);
+        hash = NULL;
+      } else {
+        hash->bits = bits;
+        hash->mask = TABLE_MASK(bits);
+        hash->table_size = TABLE_SIZE(bits);
+        hash->size = 0;
+        memset(hash->table, 0, TABLE_SIZE(bits + 1) * sizeof(hashElemType));
+      } /* if */
     } /* if */
     return hash;
   } /* new_hash */
@@ -182,6 +195,7 @@ static hashElemType create_helem (hashElemType source_helem,
       SET_ANY_FLAG(&dest_helem->data, HAS_POSINFO(&source_helem->data));
       dest_helem->data.type_of = source_helem->data.type_of;
       param3_call(data_create_func, &dest_helem->data, SYS_CREA_OBJECT, &source_helem->data);
+      dest_helem->hashcode = source_helem->hashcode;
       if (source_helem->next_less != NULL) {
         dest_helem->next_less = create_helem(source_helem->next_less,
             key_create_func, data_create_func, err_info);
@@ -213,13 +227,20 @@ static hashType create_hash (hashType source_hash,
 
   /* create_hash */
     table_size = source_hash->table_size;
-    if (unlikely(!ALLOC_HASH(dest_hash, table_size))) {
+    if (unlikely(!ALLOC_HASH(dest_hash))) {
+      *err_info = MEMORY_ERROR;
+    } else if (unlikely(!ALLOC_HASH_TABLE(dest_hash->table,
+                                          TABLE_CAPACITY(source_hash)))) {
+      FREE_HASH(dest_hash);
+      dest_hash = NULL;
       *err_info = MEMORY_ERROR;
     } else {
       dest_hash->bits = source_hash->bits;
       dest_hash->mask = source_hash->mask;
       dest_hash->table_size = table_size;
       dest_hash->size = source_hash->size;
+      memset(&dest_hash->table[table_size], 0,
+             (TABLE_CAPACITY(source_hash) - table_size) * sizeof(hashElemType));
       if (source_hash->size == 0) {
         memset(dest_hash->table, 0, table_size * sizeof(hashElemType));
       } else {
@@ -248,6 +269,230 @@ static hashType create_hash (hashType source_hash,
 
 
 
+/**
+ *  Determine the bucket of 'hashcode' in the table of 'aHashMap'.
+ *  Buckets below the split position have already been split.
+ *  They use one more bit of the hashcode.
+ */
+static inline unsigned int table_pos (const const_hashType aHashMap,
+    const intType hashcode)
+
+  {
+    unsigned int pos;
+
+  /* table_pos */
+    pos = (unsigned int) hashcode & aHashMap->mask;
+    if (pos < aHashMap->table_size - TABLE_SIZE(aHashMap->bits)) {
+      pos = (unsigned int) hashcode & (aHashMap->mask << 1 | 1);
+    } /* if */
+    return pos;
+  } /* table_pos */
+
+
+
+/**
+ *  Convert the tree 'curr_helem' to a list linked with next_greater.
+ *  The list is in tree order and it is prepended to 'list'.
+ *  @return the head of the list.
+ */
+static hashElemType helem_tree_to_list (hashElemType curr_helem,
+    hashElemType list)
+
+  {
+    hashElemType next_helem;
+
+  /* helem_tree_to_list */
+    while (curr_helem != NULL) {
+      if (curr_helem->next_greater != NULL) {
+        list = helem_tree_to_list(curr_helem->next_greater, list);
+      } /* if */
+      next_helem = curr_helem->next_less;
+      curr_helem->next_less = NULL;
+      curr_helem->next_greater = list;
+      list = curr_helem;
+      curr_helem = next_helem;
+    } /* while */
+    return list;
+  } /* helem_tree_to_list */
+
+
+
+/**
+ *  Build a balanced tree from the first 'length' elements of '*list'.
+ *  The list must be in tree order. No comparisons are necessary.
+ *  Afterwards '*list' refers to the element after the tree elements.
+ *  @return the root of the tree.
+ */
+static hashElemType helem_list_to_tree (hashElemType *list,
+    memSizeType length)
+
+  {
+    hashElemType less_helems;
+    hashElemType root;
+
+  /* helem_list_to_tree */
+    if (length == 0) {
+      root = NULL;
+    } else {
+      less_helems = helem_list_to_tree(list, length >> 1);
+      root = *list;
+      *list = root->next_greater;
+      root->next_less = less_helems;
+      root->next_greater = helem_list_to_tree(list, length - (length >> 1) - 1);
+    } /* if */
+    return root;
+  } /* helem_list_to_tree */
+
+
+
+/**
+ *  Grow the table of 'aHashMap' by splitting one bucket.
+ *  The elements of the bucket are relinked, which takes time
+ *  proportional to the size of the bucket. Doubling the table
+ *  memory is done with a realloc() of the bucket pointers.
+ *  If there is not enough memory the table is left unchanged.
+ */
+static void grow_hash (const hashType aHashMap)
+
+  {
+    hashElemType *resized_table;
+    unsigned int split_pos;
+    unsigned int split_bit;
+    hashElemType helem;
+    hashElemType lower_list;
+    hashElemType upper_list;
+    hashElemType *lower_tail;
+    hashElemType *upper_tail;
+    memSizeType lower_length = 0;
+    memSizeType upper_length = 0;
+
+  /* grow_hash */
+    if (aHashMap->table_size == TABLE_CAPACITY(aHashMap) &&
+        aHashMap->bits < MAX_TABLE_BITS) {
+      resized_table = REALLOC_HASH_TABLE(aHashMap->table,
+          TABLE_SIZE(aHashMap->bits + 1), TABLE_SIZE(aHashMap->bits + 2));
+      if (resized_table != NULL) {
+        COUNT3_HASH_TABLE(TABLE_SIZE(aHashMap->bits + 1),
+                          TABLE_SIZE(aHashMap->bits + 2));
+        aHashMap->table = resized_table;
+        aHashMap->bits++;
+        aHashMap->mask = TABLE_MASK(aHashMap->bits);
+        memset(&aHashMap->table[aHashMap->table_size], 0,
+               TABLE_SIZE(aHashMap->bits) * sizeof(hashElemType));
+      } /* if */
+    } /* if */
+    if (aHashMap->table_size < TABLE_CAPACITY(aHashMap)) {
+      split_bit = TABLE_SIZE(aHashMap->bits);
+      split_pos = aHashMap->table_size - split_bit;
+      helem = helem_tree_to_list(aHashMap->table[split_pos], NULL);
+      lower_tail = &lower_list;
+      upper_tail = &upper_list;
+      while (helem != NULL) {
+        if (((unsigned int) helem->hashcode & split_bit) != 0) {
+          *upper_tail = helem;
+          upper_tail = &helem->next_greater;
+          upper_length++;
+        } else {
+          *lower_tail = helem;
+          lower_tail = &helem->next_greater;
+          lower_length++;
+        } /* if */
+        helem = helem->next_greater;
+      } /* while */
+      *lower_tail = NULL;
+      *upper_tail = NULL;
+      aHashMap->table[split_pos] =
+          helem_list_to_tree(&lower_list, lower_length);
+      aHashMap->table[split_pos + split_bit] =
+          helem_list_to_tree(&upper_list, upper_length);
+      aHashMap->table_size++;
+    } /* if */
+  } /* grow_hash */
+
+
+
+static intType compare_keys (objectType cmp_func, objectType key1,
+    objectType key2)
+
+  {
+    objectType cmp_obj;
+    intType cmp = 0;
+
+  /* compare_keys */
+    cmp_obj = param3_call(cmp_func, key1, key2, cmp_func);
+    if (likely(cmp_obj != NULL)) {
+      isit_int2(cmp_obj);
+      cmp = take_int(cmp_obj);
+      FREE_OBJECT(cmp_obj);
+    } /* if */
+    return cmp;
+  } /* compare_keys */
+
+
+
+/**
+ *  Shrink the table of 'aHashMap' by merging the last bucket
+ *  into its buddy bucket. This reverses one split of grow_hash().
+ *  If there is not enough memory the table is left unchanged.
+ */
+static void shrink_hash (const hashType aHashMap, objectType cmp_func)
+
+  {
+    hashElemType *resized_table;
+    unsigned int last_pos;
+    hashElemType list1;
+    hashElemType list2;
+    hashElemType merged_list;
+    hashElemType *merged_tail;
+    memSizeType merged_length = 0;
+
+  /* shrink_hash */
+    if (aHashMap->table_size == TABLE_SIZE(aHashMap->bits)) {
+      resized_table = REALLOC_HASH_TABLE(aHashMap->table,
+          TABLE_SIZE(aHashMap->bits + 1), TABLE_SIZE(aHashMap->bits));
+      if (resized_table != NULL) {
+        COUNT3_HASH_TABLE(TABLE_SIZE(aHashMap->bits + 1),
+                          TABLE_SIZE(aHashMap->bits));
+        aHashMap->table = resized_table;
+        aHashMap->bits--;
+        aHashMap->mask = TABLE_MASK(aHashMap->bits);
+      } /* if */
+    } /* if */
+    if (aHashMap->table_size > TABLE_SIZE(aHashMap->bits)) {
+      last_pos = aHashMap->table_size - 1;
+      list1 = helem_tree_to_list(aHashMap->table[last_pos - TABLE_SIZE(aHashMap->bits)], NULL);
+      list2 = helem_tree_to_list(aHashMap->table[last_pos], NULL);
+      merged_tail = &merged_list;
+      while (list1 != NULL && list2 != NULL) {
+        /* In tree order an element comes before all elements, */
+        /* which are found in its next_greater subtree. */
+        if (compare_keys(cmp_func, &list2->key, &list1->key) < 0) {
+          *merged_tail = list1;
+          list1 = list1->next_greater;
+        } else {
+          *merged_tail = list2;
+          list2 = list2->next_greater;
+        } /* if */
+        merged_tail = &(*merged_tail)->next_greater;
+        merged_length++;
+      } /* while */
+      if (list1 == NULL) {
+        list1 = list2;
+      } /* if */
+      *merged_tail = list1;
+      while (list1 != NULL) {
+        merged_length++;
+        list1 = list1->next_greater;
+      } /* while */
+      aHashMap->table[last_pos - TABLE_SIZE(aHashMap->bits)] =
+          helem_list_to_tree(&merged_list, merged_length);
+      aHashMap->table[last_pos] = NULL;
+      aHashMap->table_size--;
+    } /* if */
+  } /* shrink_hash */
+
+
+
 static memSizeType keys_helem (const arrayType key_array, memSizeType arr_pos,
     hashElemType curr_helem, objectType key_create_func)
 
@@ -449,17 +694,19 @@ static void for_hash (objectType for_variable, hashType curr_hash,
 
   {
     unsigned int number;
-    const hashElemType *table;
 
   /* for_hash */
     number = curr_hash->table_size;
-    table = curr_hash->table;
     while (number != 0) {
       do {
         number--;
-      } while (number != 0 && table[number] == NULL);
-      if (number != 0 || table[number] != NULL) {
-        for_helem(for_variable, table[number], statement, data_copy_func);
+      } while (number != 0 && curr_hash->table[number] == NULL);
+      if (number != 0 || curr_hash->table[number] != NULL) {
+        for_helem(for_variable, curr_hash->table[number], statement, data_copy_func);
+      } /* if */
+      /* The statement might have changed the size of the table. */
+      if (number > curr_hash->table_size) {
+        number = curr_hash->table_size;
       } /* if */
     } /* while */
   } /* for_hash */
@@ -487,17 +734,19 @@ static void for_key_hash (objectType key_variable, hashType curr_hash,
 
   {
     unsigned int number;
-    const hashElemType *table;
 
   /* for_key_hash */
     number = curr_hash->table_size;
-    table = curr_hash->table;
     while (number != 0) {
       do {
         number--;
-      } while (number != 0 && table[number] == NULL);
-      if (number != 0 || table[number] != NULL) {
-        for_key_helem(key_variable, table[number], statement, key_copy_func);
+      } while (number != 0 && curr_hash->table[number] == NULL);
+      if (number != 0 || curr_hash->table[number] != NULL) {
+        for_key_helem(key_variable, curr_hash->table[number], statement, key_copy_func);
+      } /* if */
+      /* The statement might have changed the size of the table. */
+      if (number > curr_hash->table_size) {
+        number = curr_hash->table_size;
       } /* if */
     } /* while */
   } /* for_key_hash */
@@ -530,19 +779,21 @@ static void for_data_key_hash (objectType for_variable, objectType key_variable,
 
   {
     unsigned int number;
-    const hashElemType *table;
 
   /* for_data_key_hash */
     number = curr_hash->table_size;
-    table = curr_hash->table;
     while (number != 0) {
       do {
         number--;
-      } while (number != 0 && table[number] == NULL);
-      if (number != 0 || table[number] != NULL) {
-        for_data_key_helem(for_variable, key_variable, table[number], statement,
+      } while (number != 0 && curr_hash->table[number] == NULL);
+      if (number != 0 || curr_hash->table[number] != NULL) {
+        for_data_key_helem(for_variable, key_variable, curr_hash->table[number], statement,
             data_copy_func, key_copy_func);
       } /* if */
+      /* The statement might have changed the size of the table. */
+      if (number > curr_hash->table_size) {
+        number = curr_hash->table_size;
+      } /* if */
     } /* while */
   } /* for_data_key_hash */
 
@@ -560,7 +811,7 @@ objectType hsh_contains_element (hashType aHashMap, objectType aKey,
 
   /* hsh_contains_element */
     result = SYS_FALSE_OBJECT;
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp_obj = param3_call(cmp_func, &hashelem->key, aKey, cmp_func);
       isit_not_null(cmp_obj);
@@ -610,7 +861,7 @@ objectType hsh_contains (listType arguments)
     cmp_func = take_reference(arg_4(arguments));
     isit_not_null(cmp_func);
     result = SYS_FALSE_OBJECT;
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp_obj = param3_call(cmp_func, &hashelem->key, aKey, cmp_func);
       isit_not_null(cmp_obj);
@@ -856,8 +1107,8 @@ objectType hsh_excl (listType arguments)
     isit_not_null(cmp_func);
     isit_not_null(key_destr_func);
     isit_not_null(data_destr_func);
-    delete_pos = &aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    delete_pos = &aHashMap->table[table_pos(aHashMap, hashcode)];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp_obj = param3_call(cmp_func, &hashelem->key, aKey, cmp_func);
       isit_not_null(cmp_obj);
@@ -886,6 +1137,10 @@ objectType hsh_excl (listType arguments)
         old_hashelem->next_greater = NULL;
         free_helem(old_hashelem, key_destr_func, data_destr_func);
         aHashMap->size--;
+        if (aHashMap->size < aHashMap->table_size >> 1 &&
+            aHashMap->table_size > TABLE_SIZE(TABLE_BITS)) {
+          shrink_hash(aHashMap, cmp_func);
+        } /* if */
         hashelem = NULL;
       } else {
         delete_pos = &hashelem->next_greater;
@@ -1007,7 +1262,7 @@ objectType hsh_idx (listType arguments)
                        (memSizeType) aHashMap, (memSizeType) aKey, hashcode,
                        (memSizeType) cmp_func););
     result_hashelem = NULL;
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp_obj = param3_call(cmp_func, &hashelem->key, aKey, cmp_func);
       isit_not_null(cmp_obj);
@@ -1096,7 +1351,7 @@ objectType hsh_idx2 (listType arguments)
                        (memSizeType) aHashMap, (memSizeType) aKey, hashcode,
                        (memSizeType) cmp_func););
     result_hashelem = NULL;
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp_obj = param3_call(cmp_func, &hashelem->key, aKey, cmp_func);
       isit_not_null(cmp_obj);
@@ -1192,7 +1447,7 @@ objectType hsh_idx2 (listType arguments)
     isit_not_null(key_create_func);
     isit_not_null(data_create_func);
     result_hashelem = NULL;
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp_obj = param3_call(cmp_func, &hashelem->key, aKey, cmp_func);
       isit_not_null(cmp_obj);
@@ -1201,7 +1456,7 @@ objectType hsh_idx2 (listType arguments)
       FREE_OBJECT(cmp_obj);
       if (cmp < 0) {
         if (hashelem->next_less == NULL) {
-          result_hashelem = new_helem(aKey, data,
+          result_hashelem = new_helem(aKey, data, hashcode,
               key_create_func, data_create_func, &err_info);
           aHashMap->size++;
           hashelem->next_less = result_hashelem;
@@ -1214,7 +1469,7 @@ objectType hsh_idx2 (listType arguments)
         hashelem = NULL;
       } else {
         if (hashelem->next_greater == NULL) {
-          result_hashelem = new_helem(aKey, data,
+          result_hashelem = new_helem(aKey, data, hashcode,
               key_create_func, data_create_func, &err_info);
           aHashMap->size++;
           hashelem->next_greater = result_hashelem;
@@ -1286,9 +1541,9 @@ objectType hsh_incl (listType arguments)
                        (memSizeType) aHashMap, (memSizeType) aKey, (memSizeType) data,
                        hashcode, (memSizeType) cmp_func, (memSizeType) key_create_func,
                        (memSizeType) data_create_func, (memSizeType) data_copy_func););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     if (hashelem == NULL) {
-      aHashMap->table[(unsigned int) hashcode & aHashMap->mask] = new_helem(aKey, data,
+      aHashMap->table[table_pos(aHashMap, hashcode)] = new_helem(aKey, data, hashcode,
           key_create_func, data_create_func, &err_info);
       aHashMap->size++;
     } else if (unlikely(cmp_func == NULL)) {
@@ -1303,7 +1558,7 @@ objectType hsh_incl (listType arguments)
         FREE_OBJECT(cmp_obj);
         if (cmp < 0) {
           if (hashelem->next_less == NULL) {
-            hashelem->next_less = new_helem(aKey, data,
+            hashelem->next_less = new_helem(aKey, data, hashcode,
                 key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             hashelem = NULL;
@@ -1315,7 +1570,7 @@ objectType hsh_incl (listType arguments)
           hashelem = NULL;
         } else {
           if (hashelem->next_greater == NULL) {
-            hashelem->next_greater = new_helem(aKey, data,
+            hashelem->next_greater = new_helem(aKey, data, hashcode,
                 key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             hashelem = NULL;
@@ -1329,6 +1584,9 @@ objectType hsh_incl (listType arguments)
       aHashMap->size--;
       return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
     } else {
+      if (aHashMap->size > aHashMap->table_size) {
+        grow_hash(aHashMap);
+      } /* if */
       return SYS_EMPTY_OBJECT;
     } /* if */
   } /* hsh_incl */
@@ -1455,7 +1713,7 @@ objectType hsh_refidx (listType arguments)
     cmp_func = take_reference(arg_4(arguments));
     isit_not_null(cmp_func);
     result_hashelem = NULL;
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     while (hashelem != NULL) {
       cmp_obj = param3_call(cmp_func, &hashelem->key, aKey, cmp_func);
       isit_not_null(cmp_obj);
@@ -1529,9 +1787,9 @@ objectType hsh_update (listType arguments)
                        (memSizeType) aHashMap, (memSizeType) aKey, (memSizeType) data,
                        hashcode, (memSizeType) cmp_func, (memSizeType) key_create_func,
                        (memSizeType) data_create_func););
-    hashelem = aHashMap->table[(unsigned int) hashcode & aHashMap->mask];
+    hashelem = aHashMap->table[table_pos(aHashMap, hashcode)];
     if (hashelem == NULL) {
-      aHashMap->table[(unsigned int) hashcode & aHashMap->mask] = new_helem(aKey, data,
+      aHashMap->table[table_pos(aHashMap, hashcode)] = new_helem(aKey, data, hashcode,
           key_create_func, data_create_func, &err_info);
       aHashMap->size++;
     } else if (unlikely(cmp_func == NULL)) {
@@ -1546,7 +1804,7 @@ objectType hsh_update (listType arguments)
         FREE_OBJECT(cmp_obj);
         if (cmp < 0) {
           if (hashelem->next_less == NULL) {
-            hashelem->next_less = new_helem(aKey, data,
+            hashelem->next_less = new_helem(aKey, data, hashcode,
                 key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             hashelem = NULL;
@@ -1560,7 +1818,7 @@ objectType hsh_update (listType arguments)
           hashelem = NULL;
         } else {
           if (hashelem->next_greater == NULL) {
-            hashelem->next_greater = new_helem(aKey, data,
+            hashelem->next_greater = new_helem(aKey, data, hashcode,
                 key_create_func, data_create_func, &err_info);
             aHashMap->size++;
             hashelem = NULL;
@@ -1573,6 +1831,8 @@ objectType hsh_update (listType arguments)
     if (unlikely(err_info != OKAY_NO_ERROR)) {
       aHashMap->size--;
       return raise_with_arguments(SYS_MEM_EXCEPTION, arguments);
+    } else if (aHashMap->size > aHashMap->table_size) {
+      grow_hash(aHashMap);
     } /* if */
     /* printf("hsh_update -> ");
     trace1(data);
@@ -1 +1 @@
-#define LEVEL 750
+#define LEVEL 753
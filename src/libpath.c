@@ -239,7 +239,7 @@ void appendToLibPath (const_striType path, errInfoType *err_info)
     if (!ALLOC_STRI_CHECK_SIZE(stri, stri_len)) {
       *err_info = MEMORY_ERROR;
     } else {
-      resized_lib_path = REALLOC_RTL_ARRAY(lib_path,
+      REALLOC_RTL_ARRAY(resized_lib_path, lib_path,
           (memSizeType) lib_path->max_position,
           (memSizeType) (lib_path->max_position + 1));
       if (resized_lib_path == NULL) {
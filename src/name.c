@@ -77,6 +77,7 @@ static void push_owner (ownerType *owner, objectType obj_to_push,
       created_owner->decl_level = decl_level;
       created_owner->next = *owner;
       *owner = created_owner;
+      declaration_change_count++;
     } else {
       *err_info = MEMORY_ERROR;
     } /* if */
@@ -98,6 +99,7 @@ static void pop_owner (ownerType *owner)
     old_owner = *owner;
     *owner = old_owner->next;
     FREE_RECORD(old_owner, ownerRecord, count.owner);
+    declaration_change_count++;
     logFunction(printf("pop_owner -->\n"););
   } /* pop_owner */
 
@@ -389,6 +391,7 @@ static void pop_object (progType currentProg, const_objectType obj_to_pop)
       if (owner != NULL) {
         entity->data.owner = owner->next;
         FREE_RECORD(owner, ownerRecord, count.owner);
+        declaration_change_count++;
         if (entity->data.owner == NULL && entity->fparam_list != NULL) {
           pop_entity(currentProg->declaration_root, entity);
           entity->data.next = currentProg->entity.inactive_list;
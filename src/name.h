@@ -25,6 +25,12 @@
 /*                                                                  */
 /********************************************************************/
 
+/* Incremented whenever the owner of an entity changes. Caches of   */
+/* match results use it to notice that a declaration was added or   */
+/* removed.                                                         */
+EXTERN unsigned long declaration_change_count;
+
+
 void disconnect_param_entities (const const_objectType objWithParams);
 void init_stack (progType currentProg, errInfoType *err_info);
 void close_stack (progType currentProg);
@@ -123,12 +123,10 @@ static void free_args (objectType arg_v)
 
   {
     arrayType arg_array;
-    memSizeType arg_array_size;
 
   /* free_args */
     arg_array = take_array(arg_v);
-    arg_array_size = arraySize(arg_array);
-    FREE_ARRAY(arg_array, arg_array_size);
+    FREE_ARRAY(arg_array, arraySize(arg_array));
     FREE_OBJECT(arg_v);
   } /* free_args */
 
@@ -109,7 +109,12 @@ static const actEntryRecord actEntryTable[] = {
     { "ARR_RANGE",                  arr_range,                  },
     { "ARR_REMOVE",                 arr_remove,                 },
     { "ARR_REMOVE_ARRAY",           arr_remove_array,           },
+    { "ARR_RESERVE",                arr_reserve,                },
     { "ARR_SORT",                   arr_sort,                   },
+    { "ARR_SORT_INT_KEYS",          arr_sort_int_keys,          },
+    { "ARR_SORT_PARALLEL",          arr_sort_parallel,          },
+    { "ARR_SORT_STABLE",            arr_sort_stable,            },
+    { "ARR_SORT_STRI_KEYS",         arr_sort_stri_keys,         },
     { "ARR_SUBARR",                 arr_subarr,                 },
     { "ARR_TAIL",                   arr_tail,                   },
     { "ARR_TIMES",                  arr_times,                  },
@@ -983,6 +988,7 @@ static const actEntryRecord actEntryTable[] = {
     { "STR_CHSPLIT",                str_chsplit,                },
     { "STR_CLIT",                   str_clit,                   },
     { "STR_CMP",                    str_cmp,                    },
+    { "STR_CMP_IGNORE_CASE",        str_cmp_ignore_case,        },
  /* { "STR_CNT",                    str_cnt,                    }, */
     { "STR_CPY",                    str_cpy,                    },
     { "STR_CREATE",                 str_create,                 },
@@ -995,6 +1001,7 @@ static const actEntryRecord actEntryTable[] = {
     { "STR_GE",                     str_ge,                     },
     { "STR_GT",                     str_gt,                     },
     { "STR_HASHCODE",               str_hashcode,               },
+    { "STR_HASHCODE_IGNORE_CASE",   str_hashcode_ignore_case,   },
     { "STR_HEAD",                   str_head,                   },
     { "STR_IDX",                    str_idx,                    },
     { "STR_IPOS",                   str_ipos,                   },
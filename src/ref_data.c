@@ -1383,7 +1383,7 @@ setType setValue (const const_objectType aReference)
       raise_error(RANGE_ERROR);
       result = NULL;
     } else {
-      set_size = bitsetSize(set1);
+      set_size = setAllocSize(set1);
       if (unlikely(!ALLOC_SET(result, set_size))) {
         raise_error(MEMORY_ERROR);
       } else {
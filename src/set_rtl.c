@@ -38,97 +38,1241 @@
 #include "stdio.h"
 #include "string.h"
 #include "limits.h"
+#if HAS_AVX2_TARGET_ATTRIBUTE
+#include "immintrin.h"
+#elif HAS_SSE2_INTRINSICS
+#include "emmintrin.h"
+#endif
+
+#include "common.h"
+#include "data_rtl.h"
+#include "heaputl.h"
+#include "rtl_err.h"
+#include "int_rtl.h"
+
+#undef EXTERN
+#define EXTERN
+#include "set_rtl.h"
+
+
+/* Sets spanning more than SPARSE_SET_LIMIT bitset words use the */
+/* sparse representation, if less than a quarter of the words   */
+/* is non-zero.                                                  */
+#define SPARSE_SET_LIMIT 64
+#define useSparseSet(span,count) ((span) > SPARSE_SET_LIMIT && (span) >> 2 > (count))
+
+/* Number of slots searched for an unused slot in sparseIncl. */
+#define SPARSE_SLOT_SEARCH 64
+
+
+
+/**
+ *  Determine the number of one bits in a bitset.
+ *  The function uses a combination of sideways additions and
+ *  a multiplication to count the bits set in a bitset element.
+ *  @return the number of one bits.
+ */
+static inline uintType bitsetPopulation (bitSetType bitset)
+
+  { /* bitsetPopulation */
+#if BITSETTYPE_SIZE == 32
+    bitset -= (bitset >> 1) & UINT32_SUFFIX(0x55555555);
+    bitset =  (bitset       & UINT32_SUFFIX(0x33333333)) +
+             ((bitset >> 2) & UINT32_SUFFIX(0x33333333));
+    bitset = (bitset + (bitset >> 4)) & UINT32_SUFFIX(0x0f0f0f0f);
+    return (uintType) ((bitset * UINT32_SUFFIX(0x01010101)) >> 24);
+#elif BITSETTYPE_SIZE == 64
+    bitset -= (bitset >> 1) & UINT64_SUFFIX(0x5555555555555555);
+    bitset =  (bitset       & UINT64_SUFFIX(0x3333333333333333)) +
+             ((bitset >> 2) & UINT64_SUFFIX(0x3333333333333333));
+    bitset = (bitset + (bitset >> 4)) & UINT64_SUFFIX(0x0f0f0f0f0f0f0f0f);
+    return (uintType) ((bitset * UINT64_SUFFIX(0x0101010101010101)) >> 56);
+#endif
+  } /* bitsetPopulation */
+
+
+
+/**
+ *  Find a a non-zero bitSet in an array of bitSets.
+ *  This function uses loop unrolling inspired by Duff's device.
+ *  @return a pointer to the non-zero bitSet or NULL if there was none.
+ */
+static inline const bitSetType *bitsetNonZero (register const bitSetType *bitset,
+    const memSizeType len)
+
+  {
+    register memSizeType blockCount;
+
+  /* bitsetNonZero */
+    if (len != 0) {
+      blockCount = (len + 31) >> 5;
+      switch (len & 31) {
+        case  0: do { if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 31:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 30:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 29:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 28:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 27:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 26:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 25:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 24:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 23:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 22:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 21:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 20:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 19:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 18:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 17:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 16:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 15:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 14:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 13:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 12:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 11:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case 10:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  9:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  8:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  7:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  6:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  5:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  4:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  3:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  2:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+        case  1:      if (unlikely(*bitset != 0)) return bitset; bitset++;
+                } while (--blockCount > 0);
+      } /* switch */
+    } /* if */
+    return NULL;
+  } /* bitsetNonZero */
+
+
+
+/* If the compiler supports the target attribute for POPCNT it also */
+/* provides builtins to count the bits and the trailing zero bits.  */
+#if HAS_POPCNT_TARGET_ATTRIBUTE
+#if BITSETTYPE_SIZE == 32
+#define bitsetTrailingZeros(bitset) __builtin_ctz(bitset)
+#define bitsetPopcnt(bitset)        __builtin_popcount(bitset)
+#elif BITSETTYPE_SIZE == 64
+#define bitsetTrailingZeros(bitset) __builtin_ctzll(bitset)
+#define bitsetPopcnt(bitset)        __builtin_popcountll(bitset)
+#endif
+#else
+#define bitsetTrailingZeros(bitset) bitsetLeastSignificantBit(bitset)
+#endif
+
+/* Word-wise operations of bitsetCombine. */
+#define BITSET_OR      0
+#define BITSET_AND     1
+#define BITSET_XOR     2
+#define BITSET_AND_NOT 3
+
+#define BITSETS_PER_M128 (16 / sizeof(bitSetType))
+#define BITSETS_PER_M256 (32 / sizeof(bitSetType))
+
+
+
+/**
+ *  Determine the number of one bits in an array of bitsets.
+ *  @return the number of one bits in bitset[0] .. bitset[len - 1].
+ */
+static uintType bitsetArrayPopulationScalar (const bitSetType *bitset,
+    memSizeType len)
+
+  {
+    uintType card = 0;
+
+  /* bitsetArrayPopulationScalar */
+    for (; len > 0; bitset++, len--) {
+      card += bitsetPopulation(*bitset);
+    } /* for */
+    return card;
+  } /* bitsetArrayPopulationScalar */
+
+
+
+/**
+ *  Combine the bitsets of src1 and src2 word by word.
+ *  The result is written to dest. Dest may overlap src1, as long
+ *  as dest does not start behind src1. This allows in-place
+ *  operations, which shift the bitsets towards the start.
+ *  @param operation One of BITSET_OR, BITSET_AND, BITSET_XOR and
+ *         BITSET_AND_NOT (src1 & ~ src2).
+ */
+static void bitsetCombineScalar (bitSetType *dest, const bitSetType *src1,
+    const bitSetType *src2, memSizeType len, int operation)
+
+  { /* bitsetCombineScalar */
+    switch (operation) {
+      case BITSET_OR:
+        for (; len > 0; dest++, src1++, src2++, len--) {
+          *dest = *src1 | *src2;
+        } /* for */
+        break;
+      case BITSET_AND:
+        for (; len > 0; dest++, src1++, src2++, len--) {
+          *dest = *src1 & *src2;
+        } /* for */
+        break;
+      case BITSET_XOR:
+        for (; len > 0; dest++, src1++, src2++, len--) {
+          *dest = *src1 ^ *src2;
+        } /* for */
+        break;
+      case BITSET_AND_NOT:
+        for (; len > 0; dest++, src1++, src2++, len--) {
+          *dest = *src1 & ~ *src2;
+        } /* for */
+        break;
+    } /* switch */
+  } /* bitsetCombineScalar */
+
+
+
+/**
+ *  Check if all bits of src1 are also set in src2.
+ *  @return TRUE if (src1[i] & ~ src2[i]) == 0 holds for all i,
+ *          FALSE otherwise.
+ */
+static boolType bitsetIsSubsetScalar (const bitSetType *src1,
+    const bitSetType *src2, memSizeType len)
+
+  { /* bitsetIsSubsetScalar */
+    for (; len > 0; src1++, src2++, len--) {
+      if ((*src1 & ~ *src2) != 0) {
+        return FALSE;
+      } /* if */
+    } /* for */
+    return TRUE;
+  } /* bitsetIsSubsetScalar */
+
+
+
+#if HAS_SSE2_INTRINSICS
+#define LOAD_SSE2(bitset) _mm_loadu_si128((const __m128i *) (bitset))
+#define STORE_SSE2(bitset, vector) _mm_storeu_si128((__m128i *) (bitset), vector)
+
+/**
+ *  Combine the bitsets of src1 and src2 with SSE2 (128 bits at once).
+ *  The remaining bitsets are combined with bitsetCombineScalar.
+ */
+static void bitsetCombineSse2 (bitSetType *dest, const bitSetType *src1,
+    const bitSetType *src2, memSizeType len, int operation)
+
+  {
+    memSizeType pos = 0;
+
+  /* bitsetCombineSse2 */
+    switch (operation) {
+      case BITSET_OR:
+        for (; pos + BITSETS_PER_M128 <= len; pos += BITSETS_PER_M128) {
+          STORE_SSE2(&dest[pos], _mm_or_si128(LOAD_SSE2(&src1[pos]),
+                                              LOAD_SSE2(&src2[pos])));
+        } /* for */
+        break;
+      case BITSET_AND:
+        for (; pos + BITSETS_PER_M128 <= len; pos += BITSETS_PER_M128) {
+          STORE_SSE2(&dest[pos], _mm_and_si128(LOAD_SSE2(&src1[pos]),
+                                               LOAD_SSE2(&src2[pos])));
+        } /* for */
+        break;
+      case BITSET_XOR:
+        for (; pos + BITSETS_PER_M128 <= len; pos += BITSETS_PER_M128) {
+          STORE_SSE2(&dest[pos], _mm_xor_si128(LOAD_SSE2(&src1[pos]),
+                                               LOAD_SSE2(&src2[pos])));
+        } /* for */
+        break;
+      case BITSET_AND_NOT:
+        for (; pos + BITSETS_PER_M128 <= len; pos += BITSETS_PER_M128) {
+          STORE_SSE2(&dest[pos], _mm_andnot_si128(LOAD_SSE2(&src2[pos]),
+                                                  LOAD_SSE2(&src1[pos])));
+        } /* for */
+        break;
+    } /* switch */
+    bitsetCombineScalar(&dest[pos], &src1[pos], &src2[pos], len - pos, operation);
+  } /* bitsetCombineSse2 */
+
+
+
+/**
+ *  Check with SSE2 if all bits of src1 are also set in src2.
+ */
+static boolType bitsetIsSubsetSse2 (const bitSetType *src1,
+    const bitSetType *src2, memSizeType len)
+
+  {
+    memSizeType pos;
+
+  /* bitsetIsSubsetSse2 */
+    for (pos = 0; pos + BITSETS_PER_M128 <= len; pos += BITSETS_PER_M128) {
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+          _mm_andnot_si128(LOAD_SSE2(&src2[pos]), LOAD_SSE2(&src1[pos])),
+          _mm_setzero_si128())) != 0xffff) {
+        return FALSE;
+      } /* if */
+    } /* for */
+    return bitsetIsSubsetScalar(&src1[pos], &src2[pos], len - pos);
+  } /* bitsetIsSubsetSse2 */
+
+#endif
+
+
+
+#if HAS_AVX2_TARGET_ATTRIBUTE
+#define LOAD_AVX2(bitset) _mm256_loadu_si256((const __m256i *) (bitset))
+#define STORE_AVX2(bitset, vector) _mm256_storeu_si256((__m256i *) (bitset), vector)
+
+/**
+ *  Combine the bitsets of src1 and src2 with AVX2 (256 bits at once).
+ *  This function is only called if the CPU supports AVX2.
+ */
+__attribute__((target("avx2")))
+static void bitsetCombineAvx2 (bitSetType *dest, const bitSetType *src1,
+    const bitSetType *src2, memSizeType len, int operation)
+
+  {
+    memSizeType pos = 0;
+
+  /* bitsetCombineAvx2 */
+    switch (operation) {
+      case BITSET_OR:
+        for (; pos + BITSETS_PER_M256 <= len; pos += BITSETS_PER_M256) {
+          STORE_AVX2(&dest[pos], _mm256_or_si256(LOAD_AVX2(&src1[pos]),
+                                                 LOAD_AVX2(&src2[pos])));
+        } /* for */
+        break;
+      case BITSET_AND:
+        for (; pos + BITSETS_PER_M256 <= len; pos += BITSETS_PER_M256) {
+          STORE_AVX2(&dest[pos], _mm256_and_si256(LOAD_AVX2(&src1[pos]),
+                                                  LOAD_AVX2(&src2[pos])));
+        } /* for */
+        break;
+      case BITSET_XOR:
+        for (; pos + BITSETS_PER_M256 <= len; pos += BITSETS_PER_M256) {
+          STORE_AVX2(&dest[pos], _mm256_xor_si256(LOAD_AVX2(&src1[pos]),
+                                                  LOAD_AVX2(&src2[pos])));
+        } /* for */
+        break;
+      case BITSET_AND_NOT:
+        for (; pos + BITSETS_PER_M256 <= len; pos += BITSETS_PER_M256) {
+          STORE_AVX2(&dest[pos], _mm256_andnot_si256(LOAD_AVX2(&src2[pos]),
+                                                     LOAD_AVX2(&src1[pos])));
+        } /* for */
+        break;
+    } /* switch */
+    bitsetCombineScalar(&dest[pos], &src1[pos], &src2[pos], len - pos, operation);
+  } /* bitsetCombineAvx2 */
+
+
+
+/**
+ *  Check with AVX2 if all bits of src1 are also set in src2.
+ *  This function is only called if the CPU supports AVX2.
+ */
+__attribute__((target("avx2")))
+static boolType bitsetIsSubsetAvx2 (const bitSetType *src1,
+    const bitSetType *src2, memSizeType len)
+
+  {
+    memSizeType pos;
+
+  /* bitsetIsSubsetAvx2 */
+    for (pos = 0; pos + BITSETS_PER_M256 <= len; pos += BITSETS_PER_M256) {
+      /* _mm256_testc_si256(a, b) is 1, if (~ a & b) == 0 holds. */
+      if (!_mm256_testc_si256(LOAD_AVX2(&src2[pos]), LOAD_AVX2(&src1[pos]))) {
+        return FALSE;
+      } /* if */
+    } /* for */
+    return bitsetIsSubsetScalar(&src1[pos], &src2[pos], len - pos);
+  } /* bitsetIsSubsetAvx2 */
+
+#endif
+
+
+
+#if HAS_POPCNT_TARGET_ATTRIBUTE
+/**
+ *  Determine the number of one bits in an array of bitsets with
+ *  the POPCNT instruction. Four counters are used to allow that
+ *  several POPCNT instructions are executed in parallel.
+ *  This function is only called if the CPU supports POPCNT.
+ */
+__attribute__((target("popcnt")))
+static uintType bitsetArrayPopulationPopcnt (const bitSetType *bitset,
+    memSizeType len)
+
+  {
+    uintType card0 = 0;
+    uintType card1 = 0;
+    uintType card2 = 0;
+    uintType card3 = 0;
+
+  /* bitsetArrayPopulationPopcnt */
+    for (; len >= 4; bitset += 4, len -= 4) {
+      card0 += (uintType) bitsetPopcnt(bitset[0]);
+      card1 += (uintType) bitsetPopcnt(bitset[1]);
+      card2 += (uintType) bitsetPopcnt(bitset[2]);
+      card3 += (uintType) bitsetPopcnt(bitset[3]);
+    } /* for */
+    for (; len > 0; bitset++, len--) {
+      card0 += (uintType) bitsetPopcnt(*bitset);
+    } /* for */
+    return card0 + card1 + card2 + card3;
+  } /* bitsetArrayPopulationPopcnt */
+
+#endif
+
+
+
+#if HAS_SSE2_INTRINSICS
+#define bitsetCombineDefault  bitsetCombineSse2
+#define bitsetIsSubsetDefault bitsetIsSubsetSse2
+#else
+#define bitsetCombineDefault  bitsetCombineScalar
+#define bitsetIsSubsetDefault bitsetIsSubsetScalar
+#endif
+
+/* Arrays with less bitsets are processed with the scalar functions. */
+#define BITSET_KERNEL_THRESHOLD 8
+
+
+
+#if HAS_AVX2_TARGET_ATTRIBUTE || HAS_POPCNT_TARGET_ATTRIBUTE
+static void bitsetCombineSelect (bitSetType *dest, const bitSetType *src1,
+    const bitSetType *src2, memSizeType len, int operation);
+static boolType bitsetIsSubsetSelect (const bitSetType *src1,
+    const bitSetType *src2, memSizeType len);
+static uintType bitsetArrayPopulationSelect (const bitSetType *bitset,
+    memSizeType len);
+
+static void (*bitsetCombineKernel) (bitSetType *dest, const bitSetType *src1,
+    const bitSetType *src2, memSizeType len, int operation) = bitsetCombineSelect;
+static boolType (*bitsetIsSubsetKernel) (const bitSetType *src1,
+    const bitSetType *src2, memSizeType len) = bitsetIsSubsetSelect;
+static uintType (*bitsetArrayPopulationKernel) (const bitSetType *bitset,
+    memSizeType len) = bitsetArrayPopulationSelect;
+
+
+
+/**
+ *  Select the bitset kernels with the features of the CPU.
+ *  The selection is done at the first call of a bitset kernel.
+ */
+static void selectBitsetKernels (void)
+
+  { /* selectBitsetKernels */
+    __builtin_cpu_init();
+    bitsetCombineKernel = bitsetCombineDefault;
+    bitsetIsSubsetKernel = bitsetIsSubsetDefault;
+    bitsetArrayPopulationKernel = bitsetArrayPopulationScalar;
+#if HAS_AVX2_TARGET_ATTRIBUTE
+    if (__builtin_cpu_supports("avx2")) {
+      bitsetCombineKernel = bitsetCombineAvx2;
+      bitsetIsSubsetKernel = bitsetIsSubsetAvx2;
+    } /* if */
+#endif
+#if HAS_POPCNT_TARGET_ATTRIBUTE
+    if (__builtin_cpu_supports("popcnt")) {
+      bitsetArrayPopulationKernel = bitsetArrayPopulationPopcnt;
+    } /* if */
+#endif
+  } /* selectBitsetKernels */
+
+
+
+static void bitsetCombineSelect (bitSetType *dest, const bitSetType *src1,
+    const bitSetType *src2, memSizeType len, int operation)
+
+  { /* bitsetCombineSelect */
+    selectBitsetKernels();
+    bitsetCombineKernel(dest, src1, src2, len, operation);
+  } /* bitsetCombineSelect */
+
+
+
+static boolType bitsetIsSubsetSelect (const bitSetType *src1,
+    const bitSetType *src2, memSizeType len)
+
+  { /* bitsetIsSubsetSelect */
+    selectBitsetKernels();
+    return bitsetIsSubsetKernel(src1, src2, len);
+  } /* bitsetIsSubsetSelect */
+
+
+
+static uintType bitsetArrayPopulationSelect (const bitSetType *bitset,
+    memSizeType len)
+
+  { /* bitsetArrayPopulationSelect */
+    selectBitsetKernels();
+    return bitsetArrayPopulationKernel(bitset, len);
+  } /* bitsetArrayPopulationSelect */
+
+#else
+#define bitsetCombineKernel         bitsetCombineDefault
+#define bitsetIsSubsetKernel        bitsetIsSubsetDefault
+#define bitsetArrayPopulationKernel bitsetArrayPopulationScalar
+#endif
+
+
+
+/**
+ *  Combine the bitsets of src1 and src2 word by word into dest.
+ *  Long arrays are processed with a vectorized kernel (AVX2 or SSE2)
+ *  if the CPU supports it. Dest may be identical to src1 or it may
+ *  overlap src1, as long as dest does not start behind src1.
+ *  @param operation One of BITSET_OR, BITSET_AND, BITSET_XOR and
+ *         BITSET_AND_NOT (src1 & ~ src2).
+ */
+static inline void bitsetCombine (bitSetType *dest, const bitSetType *src1,
+    const bitSetType *src2, memSizeType len, int operation)
+
+  { /* bitsetCombine */
+    if (len < BITSET_KERNEL_THRESHOLD) {
+      bitsetCombineScalar(dest, src1, src2, len, operation);
+    } else {
+      bitsetCombineKernel(dest, src1, src2, len, operation);
+    } /* if */
+  } /* bitsetCombine */
+
+
+
+/**
+ *  Check if all bits of src1[0] .. src1[len - 1] are also set in
+ *  src2[0] .. src2[len - 1]. Long arrays are checked with a
+ *  vectorized kernel (AVX2 or SSE2) if the CPU supports it.
+ *  @return TRUE if (src1[i] & ~ src2[i]) == 0 holds for all i,
+ *          FALSE otherwise.
+ */
+static inline boolType bitsetIsSubset (const bitSetType *src1,
+    const bitSetType *src2, memSizeType len)
+
+  { /* bitsetIsSubset */
+    if (len < BITSET_KERNEL_THRESHOLD) {
+      return bitsetIsSubsetScalar(src1, src2, len);
+    } else {
+      return bitsetIsSubsetKernel(src1, src2, len);
+    } /* if */
+  } /* bitsetIsSubset */
+
+
+
+/**
+ *  Determine the number of one bits in bitset[0] .. bitset[len - 1].
+ *  Long arrays are counted with the POPCNT instruction if the CPU
+ *  supports it.
+ *  @return the number of one bits.
+ */
+static inline uintType bitsetArrayPopulation (const bitSetType *bitset,
+    memSizeType len)
+
+  { /* bitsetArrayPopulation */
+    if (len < BITSET_KERNEL_THRESHOLD) {
+      return bitsetArrayPopulationScalar(bitset, len);
+    } else {
+      return bitsetArrayPopulationKernel(bitset, len);
+    } /* if */
+  } /* bitsetArrayPopulation */
+
+
+
+/**
+ *  Number of bitset words stored in 'aSet'.
+ *  For a sparse set this is the number of used slots. Some of
+ *  them may hold zero words.
+ *  @return the number of words in 'aSet'.
+ */
+static inline memSizeType wordCount (const const_setType aSet)
+
+  { /* wordCount */
+    if (setIsSparse(aSet)) {
+      return sparseUsed(aSet);
+    } else {
+      return bitsetSize(aSet);
+    } /* if */
+  } /* wordCount */
+
+
+
+/**
+ *  Get the array with the bitset words of 'aSet'.
+ *  @return a pointer to the first bitset word of 'aSet'.
+ */
+static inline const bitSetType *wordArray (const const_setType aSet)
+
+  { /* wordArray */
+    if (setIsSparse(aSet)) {
+      return &aSet->bitset[sparseSize(aSet)];
+    } else {
+      return aSet->bitset;
+    } /* if */
+  } /* wordArray */
+
+
+
+/**
+ *  Get the position of the bitset word with the given 'index'.
+ *  @return the position of the word 'index' of 'aSet'.
+ */
+static inline intType wordPosition (const const_setType aSet,
+    const memSizeType index)
+
+  { /* wordPosition */
+    if (setIsSparse(aSet)) {
+      return (intType) aSet->bitset[index];
+    } else {
+      return aSet->min_position + (intType) index;
+    } /* if */
+  } /* wordPosition */
+
+
+
+/**
+ *  Search the first bitset word with a position >= 'position'.
+ *  Sparse sets are searched with a binary search.
+ *  @return the index of the word found or wordCount(aSet)
+ *          if all words have a smaller position.
+ */
+static memSizeType wordSearch (const const_setType aSet, const intType position)
+
+  {
+    memSizeType low;
+    memSizeType high;
+    memSizeType middle;
+
+  /* wordSearch */
+    if (setIsSparse(aSet)) {
+      low = 0;
+      high = sparseUsed(aSet);
+      while (low < high) {
+        middle = low + ((high - low) >> 1);
+        if ((intType) aSet->bitset[middle] < position) {
+          low = middle + 1;
+        } else {
+          high = middle;
+        } /* if */
+      } /* while */
+    } else if (position <= aSet->min_position) {
+      low = 0;
+    } else if (position > aSet->max_position) {
+      low = bitsetSize(aSet);
+    } else {
+      low = bitsetIndex(aSet, position);
+    } /* if */
+    return low;
+  } /* wordSearch */
+
+
+
+/**
+ *  Get the bitset word of 'aSet' at 'position'.
+ *  @return the bitset word or 0 if 'aSet' has no word at 'position'.
+ */
+static bitSetType wordAt (const const_setType aSet, const intType position)
+
+  {
+    memSizeType index;
+
+  /* wordAt */
+    index = wordSearch(aSet, position);
+    if (index < wordCount(aSet) && wordPosition(aSet, index) == position) {
+      return wordArray(aSet)[index];
+    } else {
+      return 0;
+    } /* if */
+  } /* wordAt */
+
+
+
+/**
+ *  Turn a buffer with 'count' non-zero words into a set.
+ *  The buffer has room for 'capacity' ascending positions followed
+ *  by 'capacity' words. The result uses the sparse representation
+ *  if the words span a wide range. Otherwise it uses the dense
+ *  representation and the buffer is freed.
+ *  @return the set, which might be at a different address than 'buffer'.
+ */
+static setType sparseResult (setType buffer, const memSizeType capacity,
+    const memSizeType count)
+
+  {
+    intType min_position;
+    intType max_position;
+    memSizeType span;
+    memSizeType index;
+    setType result;
+
+  /* sparseResult */
+    if (count == 0) {
+      result = REALLOC_SET(buffer, 2 * capacity, 1);
+      if (unlikely(result == NULL)) {
+        /* Strange case if a 'realloc', which shrinks memory, fails. */
+        /* Deliver the result in the original buffer (that is too big). */
+        result = buffer;
+      } else {
+        COUNT3_SET(2 * capacity, 1);
+      } /* if */
+      result->min_position = 0;
+      result->max_position = 0;
+      result->bitset[0] = (bitSetType) 0;
+    } else {
+      min_position = (intType) buffer->bitset[0];
+      max_position = (intType) buffer->bitset[count - 1];
+      span = bitsetSize2(min_position, max_position);
+      if (!useSparseSet(span, count) && ALLOC_SET(result, span)) {
+        result->min_position = min_position;
+        result->max_position = max_position;
+        memset(result->bitset, 0, span * sizeof(bitSetType));
+        for (index = 0; index < count; index++) {
+          result->bitset[bitsetIndex(result, (intType) buffer->bitset[index])] =
+              buffer->bitset[capacity + index];
+        } /* for */
+        FREE_SET(buffer, 2 * capacity);
+      } else {
+        result = buffer;
+        if (count != capacity) {
+          memmove(&buffer->bitset[count], &buffer->bitset[capacity],
+                  count * sizeof(bitSetType));
+          result = REALLOC_SET(buffer, 2 * capacity, 2 * count);
+          if (unlikely(result == NULL)) {
+            /* Strange case if a 'realloc', which shrinks memory, fails. */
+            /* Deliver the result in the original buffer (that is too big). */
+            result = buffer;
+          } else {
+            COUNT3_SET(2 * capacity, 2 * count);
+          } /* if */
+        } /* if */
+        result->min_position = (intType) count;
+        result->max_position = 0;
+      } /* if */
+    } /* if */
+    return result;
+  } /* sparseResult */
+
+
+
+/**
+ *  Union or symmetric difference of two sets with at least one sparse set.
+ *  The bitset words of both sets are merged in ascending order.
+ *  @param symmetric TRUE for the symmetric difference and FALSE
+ *         for the union.
+ *  @return the union or symmetric difference of the two sets.
+ *  @exception MEMORY_ERROR Not enough memory for the result.
+ */
+static setType sparseUnion (const const_setType set1, const const_setType set2,
+    const boolType symmetric)
+
+  {
+    memSizeType size1;
+    memSizeType size2;
+    memSizeType index1 = 0;
+    memSizeType index2 = 0;
+    const bitSetType *words1;
+    const bitSetType *words2;
+    memSizeType capacity;
+    memSizeType count = 0;
+    intType position;
+    bitSetType word;
+    setType result;
+
+  /* sparseUnion */
+    size1 = wordCount(set1);
+    size2 = wordCount(set2);
+    words1 = wordArray(set1);
+    words2 = wordArray(set2);
+    capacity = size1 + size2;
+    if (unlikely(capacity > MAX_SET_LEN / 2 ||
+                 !ALLOC_SET(result, 2 * capacity))) {
+      raise_error(MEMORY_ERROR);
+      result = NULL;
+    } else {
+      while (index1 < size1 || index2 < size2) {
+        if (index1 < size1 && words1[index1] == 0) {
+          /* Unused slots are skipped. */
+          index1++;
+        } else if (index2 < size2 && words2[index2] == 0) {
+          index2++;
+        } else {
+          if (index2 >= size2 || (index1 < size1 &&
+              wordPosition(set1, index1) < wordPosition(set2, index2))) {
+            position = wordPosition(set1, index1);
+            word = words1[index1];
+            index1++;
+          } else if (index1 >= size1 ||
+              wordPosition(set2, index2) < wordPosition(set1, index1)) {
+            position = wordPosition(set2, index2);
+            word = words2[index2];
+            index2++;
+          } else {
+            position = wordPosition(set1, index1);
+            if (symmetric) {
+              word = words1[index1] ^ words2[index2];
+            } else {
+              word = words1[index1] | words2[index2];
+            } /* if */
+            index1++;
+            index2++;
+          } /* if */
+          if (word != 0) {
+            result->bitset[count] = (bitSetType) position;
+            result->bitset[capacity + count] = word;
+            count++;
+          } /* if */
+        } /* if */
+      } /* while */
+      result = sparseResult(result, capacity, count);
+    } /* if */
+    return result;
+  } /* sparseUnion */
+
+
+
+/**
+ *  Intersection or difference of two sets with at least one sparse set.
+ *  Every bitset word of 'source' is combined with the word of
+ *  'other' at the same position.
+ *  @param intersect TRUE for the intersection and FALSE for the
+ *         difference source - other.
+ *  @return the intersection or difference of the two sets.
+ *  @exception MEMORY_ERROR Not enough memory for the result.
+ */
+static setType sparseSelect (const const_setType source, const const_setType other,
+    const boolType intersect)
+
+  {
+    memSizeType capacity;
+    memSizeType index;
+    const bitSetType *words;
+    memSizeType count = 0;
+    intType position;
+    bitSetType word;
+    setType result;
+
+  /* sparseSelect */
+    capacity = wordCount(source);
+    words = wordArray(source);
+    if (unlikely(capacity > MAX_SET_LEN / 2 ||
+                 !ALLOC_SET(result, 2 * capacity))) {
+      raise_error(MEMORY_ERROR);
+      result = NULL;
+    } else {
+      for (index = 0; index < capacity; index++) {
+        if (words[index] != 0) {
+          position = wordPosition(source, index);
+          if (intersect) {
+            word = words[index] & wordAt(other, position);
+          } else {
+            word = words[index] & ~ wordAt(other, position);
+          } /* if */
+          if (word != 0) {
+            result->bitset[count] = (bitSetType) position;
+            result->bitset[capacity + count] = word;
+            count++;
+          } /* if */
+        } /* if */
+      } /* for */
+      result = sparseResult(result, capacity, count);
+    } /* if */
+    return result;
+  } /* sparseSelect */
+
+
+
+/**
+ *  Intersection of two sets with at least one sparse set.
+ *  The set with fewer words is used as source for sparseSelect.
+ *  @return the intersection of the two sets.
+ *  @exception MEMORY_ERROR Not enough memory for the result.
+ */
+static inline setType sparseIntersect (const const_setType set1,
+    const const_setType set2)
+
+  { /* sparseIntersect */
+    if (wordCount(set1) <= wordCount(set2)) {
+      return sparseSelect(set1, set2, TRUE);
+    } else {
+      return sparseSelect(set2, set1, TRUE);
+    } /* if */
+  } /* sparseIntersect */
+
+
+
+/**
+ *  Compare two sets with at least one sparse set.
+ *  The bitset words are merged in descending order until a
+ *  difference is found. This gives the same result as setCmp
+ *  for two dense sets.
+ *  @return -1, 0 or 1 if the first argument is considered to be
+ *          respectively less than, equal to, or greater than the
+ *          second.
+ */
+static intType sparseCmp (const const_setType set1, const const_setType set2)
+
+  {
+    memSizeType index1;
+    memSizeType index2;
+    const bitSetType *words1;
+    const bitSetType *words2;
+    bitSetType word1;
+    bitSetType word2;
+    intType signumValue = 0;
+
+  /* sparseCmp */
+    index1 = wordCount(set1);
+    index2 = wordCount(set2);
+    words1 = wordArray(set1);
+    words2 = wordArray(set2);
+    while (signumValue == 0 && (index1 > 0 || index2 > 0)) {
+      /* Unused slots are skipped. */
+      while (index1 > 0 && words1[index1 - 1] == 0) {
+        index1--;
+      } /* while */
+      while (index2 > 0 && words2[index2 - 1] == 0) {
+        index2--;
+      } /* while */
+      if (index1 == 0 && index2 == 0) {
+        word1 = 0;
+        word2 = 0;
+      } else if (index2 == 0 || (index1 > 0 &&
+          wordPosition(set1, index1 - 1) > wordPosition(set2, index2 - 1))) {
+        index1--;
+        word1 = words1[index1];
+        word2 = 0;
+      } else if (index1 == 0 ||
+          wordPosition(set2, index2 - 1) > wordPosition(set1, index1 - 1)) {
+        index2--;
+        word1 = 0;
+        word2 = words2[index2];
+      } else {
+        index1--;
+        index2--;
+        word1 = words1[index1];
+        word2 = words2[index2];
+      } /* if */
+      if (word1 > word2) {
+        signumValue = 1;
+      } else if (word1 < word2) {
+        signumValue = -1;
+      } /* if */
+    } /* while */
+    return signumValue;
+  } /* sparseCmp */
+
+
+
+/**
+ *  Determine if 'set1' is a subset of 'set2' (at least one set is sparse).
+ *  @return TRUE if 'set1' is a subset of 'set2',
+ *          FALSE otherwise.
+ */
+static boolType sparseIsSubset (const const_setType set1, const const_setType set2)
+
+  {
+    memSizeType size1;
+    memSizeType index;
+    const bitSetType *words1;
+    boolType isSubset = TRUE;
+
+  /* sparseIsSubset */
+    size1 = wordCount(set1);
+    words1 = wordArray(set1);
+    for (index = 0; index < size1 && isSubset; index++) {
+      if (words1[index] != 0 &&
+          (words1[index] & ~ wordAt(set2, wordPosition(set1, index))) != 0) {
+        isSubset = FALSE;
+      } /* if */
+    } /* for */
+    return isSubset;
+  } /* sparseIsSubset */
+
+
+
+/**
+ *  Rebuild the sparse set *set_to with room for further insertions.
+ *  The non-zero words of *set_to and the new word at 'position' are
+ *  copied to a new set. Every word is followed by an unused slot
+ *  and there are additional free slots at the end. Because the
+ *  capacity grows with the number of words, the cost of the
+ *  rebuild is amortized over the following insertions. If the
+ *  words do not span a wide range the new set is dense.
+ *  @exception MEMORY_ERROR If there is not enough memory.
+ */
+static void sparseSpread (setType *const set_to, const intType position,
+    const bitSetType bit)
+
+  {
+    setType set_dest;
+    memSizeType used;
+    const bitSetType *words;
+    memSizeType index;
+    memSizeType count = 1;
+    intType min_position;
+    intType max_position;
+    memSizeType capacity;
+    memSizeType slot = 0;
+    boolType inserted = FALSE;
+    setType new_set;
+
+  /* sparseSpread */
+    set_dest = *set_to;
+    used = sparseUsed(set_dest);
+    words = wordArray(set_dest);
+    min_position = position;
+    max_position = position;
+    for (index = 0; index < used; index++) {
+      if (words[index] != 0) {
+        count++;
+        if ((intType) set_dest->bitset[index] < min_position) {
+          min_position = (intType) set_dest->bitset[index];
+        } else if ((intType) set_dest->bitset[index] > max_position) {
+          max_position = (intType) set_dest->bitset[index];
+        } /* if */
+      } /* if */
+    } /* for */
+    if (!useSparseSet(bitsetSize2(min_position, max_position), count)) {
+      if (unlikely(!ALLOC_SET(new_set, bitsetSize2(min_position, max_position)))) {
+        raise_error(MEMORY_ERROR);
+      } else {
+        new_set->min_position = min_position;
+        new_set->max_position = max_position;
+        memset(new_set->bitset, 0,
+               bitsetSize2(min_position, max_position) * sizeof(bitSetType));
+        for (index = 0; index < used; index++) {
+          if (words[index] != 0) {
+            new_set->bitset[bitsetIndex(new_set, (intType) set_dest->bitset[index])] =
+                words[index];
+          } /* if */
+        } /* for */
+        new_set->bitset[bitsetIndex(new_set, position)] = bit;
+        FREE_SET(set_dest, setAllocSize(set_dest));
+        *set_to = new_set;
+      } /* if */
+    } else {
+      capacity = 2 * count + count / 2;
+      if (unlikely(capacity > MAX_SET_LEN / 2 ||
+                   !ALLOC_SET(new_set, 2 * capacity))) {
+        raise_error(MEMORY_ERROR);
+      } else {
+        for (index = 0; index <= used; index++) {
+          if (!inserted && (index == used ||
+              (intType) set_dest->bitset[index] > position)) {
+            new_set->bitset[slot] = (bitSetType) position;
+            new_set->bitset[capacity + slot] = bit;
+            new_set->bitset[slot + 1] = (bitSetType) position;
+            new_set->bitset[capacity + slot + 1] = 0;
+            slot += 2;
+            inserted = TRUE;
+          } /* if */
+          if (index < used && words[index] != 0) {
+            new_set->bitset[slot] = set_dest->bitset[index];
+            new_set->bitset[capacity + slot] = words[index];
+            new_set->bitset[slot + 1] = set_dest->bitset[index];
+            new_set->bitset[capacity + slot + 1] = 0;
+            slot += 2;
+          } /* if */
+        } /* for */
+        new_set->min_position = (intType) capacity;
+        new_set->max_position = (intType) slot - (intType) capacity;
+        FREE_SET(set_dest, setAllocSize(set_dest));
+        *set_to = new_set;
+      } /* if */
+    } /* if */
+  } /* sparseSpread */
 
-#include "common.h"
-#include "data_rtl.h"
-#include "heaputl.h"
-#include "rtl_err.h"
-#include "int_rtl.h"
 
-#undef EXTERN
-#define EXTERN
-#include "set_rtl.h"
+
+/**
+ *  Search the unused slot of a sparse set, which is nearest to 'index'.
+ *  Only SPARSE_SLOT_SEARCH slots in both directions are searched.
+ *  A free slot at the end counts as unused slot at sparseUsed(aSet).
+ *  @return the index of the unused slot found or
+ *          sparseUsed(aSet) + 1 if there is none.
+ */
+static memSizeType sparseUnusedSlot (const const_setType aSet,
+    const memSizeType index)
+
+  {
+    memSizeType used;
+    const bitSetType *words;
+    memSizeType distance;
+    memSizeType slot;
+
+  /* sparseUnusedSlot */
+    used = sparseUsed(aSet);
+    words = wordArray(aSet);
+    slot = used + 1;
+    for (distance = 0; distance < SPARSE_SLOT_SEARCH && slot > used; distance++) {
+      if (index + distance < used) {
+        if (words[index + distance] == 0) {
+          slot = index + distance;
+        } /* if */
+      } else if (index + distance == used && used < sparseSize(aSet)) {
+        slot = used;
+      } /* if */
+      if (slot > used && distance < index && words[index - distance - 1] == 0) {
+        slot = index - distance - 1;
+      } /* if */
+    } /* for */
+    return slot;
+  } /* sparseUnusedSlot */
 
 
 
 /**
- *  Determine the number of one bits in a bitset.
- *  The function uses a combination of sideways additions and
- *  a multiplication to count the bits set in a bitset element.
- *  @return the number of one bits.
+ *  Spread the used slots of a window around 'index' evenly.
+ *  The windows start with 2 * SPARSE_SLOT_SEARCH slots and double
+ *  their size until they cover all used slots. The smallest window,
+ *  whose density of non-zero words is below its limit, is spread.
+ *  The limit decreases from 15/16 for the smallest window to 1/2
+ *  for the window with all used slots. Because of that, a window
+ *  that has been spread can take many insertions before a larger
+ *  window must be spread (like in a packed memory array). Every
+ *  word is moved to its new slot and the slots up to the next word
+ *  become unused slots with the same position.
+ *  @return TRUE if a window was spread, or
+ *          FALSE if all used slots are too densely populated.
  */
-static inline uintType bitsetPopulation (bitSetType bitset)
+static boolType sparseRebalance (setType aSet, const memSizeType index)
 
-  { /* bitsetPopulation */
-#if BITSETTYPE_SIZE == 32
-    bitset -= (bitset >> 1) & UINT32_SUFFIX(0x55555555);
-    bitset =  (bitset       & UINT32_SUFFIX(0x33333333)) +
-             ((bitset >> 2) & UINT32_SUFFIX(0x33333333));
-    bitset = (bitset + (bitset >> 4)) & UINT32_SUFFIX(0x0f0f0f0f);
-    return (uintType) ((bitset * UINT32_SUFFIX(0x01010101)) >> 24);
-#elif BITSETTYPE_SIZE == 64
-    bitset -= (bitset >> 1) & UINT64_SUFFIX(0x5555555555555555);
-    bitset =  (bitset       & UINT64_SUFFIX(0x3333333333333333)) +
-             ((bitset >> 2) & UINT64_SUFFIX(0x3333333333333333));
-    bitset = (bitset + (bitset >> 4)) & UINT64_SUFFIX(0x0f0f0f0f0f0f0f0f);
-    return (uintType) ((bitset * UINT64_SUFFIX(0x0101010101010101)) >> 56);
-#endif
-  } /* bitsetPopulation */
+  {
+    memSizeType used;
+    bitSetType *positions;
+    bitSetType *words;
+    memSizeType window;
+    memSizeType levels = 1;
+    memSizeType level = 0;
+    memSizeType low;
+    memSizeType high;
+    memSizeType count;
+    memSizeType source;
+    memSizeType dest;
+    memSizeType slot;
+    memSizeType next;
+    boolType spread = FALSE;
+
+  /* sparseRebalance */
+    used = sparseUsed(aSet);
+    positions = aSet->bitset;
+    words = &aSet->bitset[sparseSize(aSet)];
+    window = 2 * SPARSE_SLOT_SEARCH;
+    while (window << levels < used) {
+      levels++;
+    } /* while */
+    do {
+      low = index / window * window;
+      high = low + window < used ? low + window : used;
+      count = 0;
+      for (slot = low; slot < high; slot++) {
+        if (words[slot] != 0) {
+          count++;
+        } /* if */
+      } /* for */
+      if (count != 0 &&
+          count * 16 * levels <= (15 * levels - 7 * level) * (high - low)) {
+        /* Move the words to the end of the window. */
+        dest = high;
+        for (source = high; source > low; source--) {
+          if (words[source - 1] != 0) {
+            dest--;
+            positions[dest] = positions[source - 1];
+            words[dest] = words[source - 1];
+          } /* if */
+        } /* for */
+        /* Spread the words, starting at the beginning of the window. */
+        for (source = 0; source < count; source++) {
+          slot = low + source * (high - low) / count;
+          next = low + (source + 1) * (high - low) / count;
+          positions[slot] = positions[dest + source];
+          words[slot] = words[dest + source];
+          for (slot++; slot < next; slot++) {
+            positions[slot] = positions[slot - 1];
+            words[slot] = 0;
+          } /* for */
+        } /* for */
+        spread = TRUE;
+      } /* if */
+      window <<= 1;
+      level++;
+    } while (!spread && window / 2 < used);
+    return spread;
+  } /* sparseRebalance */
 
 
 
 /**
- *  Find a a non-zero bitSet in an array of bitSets.
- *  This function uses loop unrolling inspired by Duff's device.
- *  @return a pointer to the non-zero bitSet or NULL if there was none.
+ *  Add 'number' to a set, which is sparse or becomes sparse.
+ *  A dense set becomes sparse if 'number' is far outside of the
+ *  range covered by it. A new word is stored in the nearest unused
+ *  slot and only the slots in between are moved. If there is no
+ *  unused slot nearby the slots of a window are spread with
+ *  sparseRebalance. If that is not possible the set is rebuilt
+ *  with sparseSpread.
+ *  @exception MEMORY_ERROR If there is not enough memory.
  */
-static inline const bitSetType *bitsetNonZero (register const bitSetType *bitset,
-    const memSizeType len)
+static void sparseIncl (setType *const set_to, const intType number)
 
   {
-    register memSizeType blockCount;
-
-  /* bitsetNonZero */
-    if (len != 0) {
-      blockCount = (len + 31) >> 5;
-      switch (len & 31) {
-        case  0: do { if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 31:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 30:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 29:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 28:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 27:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 26:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 25:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 24:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 23:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 22:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 21:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 20:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 19:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 18:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 17:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 16:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 15:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 14:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 13:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 12:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 11:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case 10:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  9:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  8:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  7:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  6:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  5:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  4:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  3:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  2:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-        case  1:      if (unlikely(*bitset != 0)) return bitset; bitset++;
-                } while (--blockCount > 0);
-      } /* switch */
+    setType set_dest;
+    intType position;
+    bitSetType bit;
+    memSizeType index;
+    memSizeType slot;
+    bitSetType *positions;
+    bitSetType *words;
+    setRecord single;
+    setType new_set;
+
+  /* sparseIncl */
+    set_dest = *set_to;
+    position = bitset_pos(number);
+    bit = (bitSetType) 1 << (((unsigned int) number) & bitset_mask);
+    if (!setIsSparse(set_dest)) {
+      single.min_position = position;
+      single.max_position = position;
+      single.bitset[0] = bit;
+      new_set = sparseUnion(set_dest, &single, FALSE);
+      if (new_set != NULL) {
+        FREE_SET(set_dest, bitsetSize(set_dest));
+        *set_to = new_set;
+      } /* if */
+    } else {
+      positions = set_dest->bitset;
+      words = &set_dest->bitset[sparseSize(set_dest)];
+      index = wordSearch(set_dest, position);
+      if (index < sparseUsed(set_dest) && (intType) positions[index] == position) {
+        words[index] |= bit;
+      } else {
+        slot = sparseUnusedSlot(set_dest, index);
+        /* At the end, the set grows instead of spreading the slots. */
+        if (slot > sparseUsed(set_dest) && index < sparseUsed(set_dest) &&
+            sparseRebalance(set_dest, index)) {
+          index = wordSearch(set_dest, position);
+          slot = sparseUnusedSlot(set_dest, index);
+        } /* if */
+        if (slot > sparseUsed(set_dest)) {
+          sparseSpread(set_to, position, bit);
+        } else {
+          if (slot == sparseUsed(set_dest)) {
+            set_dest->max_position++;
+          } /* if */
+          if (slot >= index) {
+            memmove(&positions[index + 1], &positions[index],
+                    (slot - index) * sizeof(bitSetType));
+            memmove(&words[index + 1], &words[index],
+                    (slot - index) * sizeof(bitSetType));
+          } else {
+            index--;
+            memmove(&positions[slot], &positions[slot + 1],
+                    (index - slot) * sizeof(bitSetType));
+            memmove(&words[slot], &words[slot + 1],
+                    (index - slot) * sizeof(bitSetType));
+          } /* if */
+          positions[index] = (bitSetType) position;
+          words[index] = bit;
+        } /* if */
+      } /* if */
     } /* if */
-    return NULL;
-  } /* bitsetNonZero */
+  } /* sparseIncl */
 
 
 
@@ -200,27 +1344,19 @@ setType setBaselit (const intType number)
 
 /**
  *  Compute the cardinality of a set.
- *  The function is based on the function bitsetPopulation, which
- *  uses a combination of sideways additions and a multiplication
- *  to count the bits set in a bitset element.
+ *  The function is based on the function bitsetArrayPopulation,
+ *  which uses the POPCNT instruction if the CPU supports it.
  *  @return the number of elements in 'aSet'.
  *  @exception RANGE_ERROR Result does not fit into an integer.
  */
 intType setCard (const const_setType aSet)
 
   {
-    memSizeType index_beyond;
-    memSizeType bitset_index;
-    bitSetType bitset;
-    uintType card = 0;
+    uintType card;
     intType cardinality;
 
   /* setCard */
-    index_beyond = bitsetSize(aSet);
-    for (bitset_index = index_beyond; bitset_index > 0; bitset_index--) {
-      bitset = aSet->bitset[bitset_index - 1];
-      card += bitsetPopulation(bitset);
-    } /* for */
+    card = bitsetArrayPopulation(wordArray(aSet), wordCount(aSet));
     if (unlikely(card > INTTYPE_MAX)) {
       logError(printf("setCard(): Result does not fit into an integer.\n"););
       raise_error(RANGE_ERROR);
@@ -258,6 +1394,9 @@ intType setCmp (const const_setType set1, const const_setType set2)
     const bitSetType *bitset2;
 
   /* setCmp */
+    if (setIsSparse(set1) || setIsSparse(set2)) {
+      return sparseCmp(set1, set2);
+    } /* if */
     if (set1->max_position >= set2->max_position) {
       if (set1->min_position > set2->max_position) {
         bitset_index = 0;
@@ -372,10 +1511,10 @@ void setCpy (setType *const dest, const const_setType source)
 
   /* setCpy */
     set_dest = *dest;
-    set_source_size = bitsetSize(source);
+    set_source_size = setAllocSize(source);
     if (set_dest->min_position != source->min_position ||
         set_dest->max_position != source->max_position) {
-      set_dest_size = bitsetSize(set_dest);
+      set_dest_size = setAllocSize(set_dest);
       if (set_dest_size != set_source_size) {
         if (unlikely(!ALLOC_SET(set_dest, set_source_size))) {
           raise_error(MEMORY_ERROR);
@@ -427,7 +1566,7 @@ setType setCreate (const const_setType source)
     setType result;
 
   /* setCreate */
-    new_size = bitsetSize(source);
+    new_size = setAllocSize(source);
     if (unlikely(!ALLOC_SET(result, new_size))) {
       raise_error(MEMORY_ERROR);
     } else {
@@ -470,7 +1609,7 @@ void setDestr (const const_setType old_set)
 
   { /* setDestr */
     if (old_set != NULL) {
-      FREE_SET(old_set, bitsetSize(old_set));
+      FREE_SET(old_set, setAllocSize(old_set));
     } /* if */
   } /* setDestr */
 
@@ -509,7 +1648,9 @@ setType setDiff (const const_setType set1, const const_setType set2)
                 printf(", ");
                 prot_set(set2);
                 printf(")\n"););
-    if (unlikely(!ALLOC_SET(difference, bitsetSize(set1)))) {
+    if (setIsSparse(set1) || setIsSparse(set2)) {
+      difference = sparseSelect(set1, set2, FALSE);
+    } else if (unlikely(!ALLOC_SET(difference, bitsetSize(set1)))) {
       raise_error(MEMORY_ERROR);
     } else {
       difference->min_position = set1->min_position;
@@ -534,10 +1675,11 @@ setType setDiff (const const_setType set1, const const_setType set2)
         } else {
           index_beyond = bitsetSize(set1);
         } /* if */
-        for (; bitset_index < index_beyond; bitset_index++, bitset_index2++) {
-          difference->bitset[bitset_index] = set1->bitset[bitset_index] &
-              ~ set2->bitset[bitset_index2];
-        } /* for */
+        if (bitset_index < index_beyond) {
+          bitsetCombine(&difference->bitset[bitset_index], &set1->bitset[bitset_index],
+                        &set2->bitset[bitset_index2], index_beyond - bitset_index,
+                        BITSET_AND_NOT);
+        } /* if */
       } /* if */
     } /* if */
     logFunction(printf("setDiff --> ");
@@ -558,7 +1700,8 @@ void setDiffAssign (setType *const dest, const const_setType delta)
     setType set1;
     intType min_position;
     intType max_position;
-    intType position;
+    intType start_position;
+    intType stop_position;
     setType new_set1;
 
   /* setDiffAssign */
@@ -568,80 +1711,105 @@ void setDiffAssign (setType *const dest, const const_setType delta)
                 prot_set(delta);
                 printf(")\n"););
     set1 = *dest;
-    min_position = set1->min_position;
-    max_position = set1->max_position;
-    while (min_position <= max_position &&
-           (set1->bitset[min_position - set1->min_position] == 0 ||
-            (min_position >= delta->min_position &&
-             min_position <= delta->max_position &&
-             (set1->bitset[min_position - set1->min_position] &
-              ~ delta->bitset[min_position - delta->min_position]) == 0))) {
-      min_position++;
-    } /* while */
-    while (min_position <= max_position &&
-           (set1->bitset[max_position - set1->min_position] == 0 ||
-            (max_position >= delta->min_position &&
-             max_position <= delta->max_position &&
-             (set1->bitset[max_position - set1->min_position] &
-              ~ delta->bitset[max_position - delta->min_position]) == 0))) {
-      max_position--;
-    } /* while */
-    if (min_position > max_position) {
-      new_set1 = REALLOC_SET(set1, bitsetSize(set1), 1);
-      if (unlikely(new_set1 == NULL)) {
-        /* Strange case if a 'realloc', which shrinks memory, fails. */
-        /* The destination set stays unchanged. */
-        raise_error(MEMORY_ERROR);
-      } else {
-        new_set1->min_position = 0;
-        new_set1->max_position = 0;
-        new_set1->bitset[0] = (bitSetType) 0;
+    if (setIsSparse(set1) || setIsSparse(delta)) {
+      new_set1 = sparseSelect(set1, delta, FALSE);
+      if (new_set1 != NULL) {
         *dest = new_set1;
+        FREE_SET(set1, setAllocSize(set1));
       } /* if */
-    } else if (min_position == set1->min_position) {
-      if (max_position != set1->max_position) {
-        new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
+    } else {
+      min_position = set1->min_position;
+      max_position = set1->max_position;
+      while (min_position <= max_position &&
+             (set1->bitset[min_position - set1->min_position] == 0 ||
+              (min_position >= delta->min_position &&
+               min_position <= delta->max_position &&
+               (set1->bitset[min_position - set1->min_position] &
+                ~ delta->bitset[min_position - delta->min_position]) == 0))) {
+        min_position++;
+      } /* while */
+      while (min_position <= max_position &&
+             (set1->bitset[max_position - set1->min_position] == 0 ||
+              (max_position >= delta->min_position &&
+               max_position <= delta->max_position &&
+               (set1->bitset[max_position - set1->min_position] &
+                ~ delta->bitset[max_position - delta->min_position]) == 0))) {
+        max_position--;
+      } /* while */
+      if (min_position > max_position) {
+        new_set1 = REALLOC_SET(set1, bitsetSize(set1), 1);
         if (unlikely(new_set1 == NULL)) {
           /* Strange case if a 'realloc', which shrinks memory, fails. */
           /* The destination set stays unchanged. */
           raise_error(MEMORY_ERROR);
-          return;
         } else {
-          set1 = new_set1;
-          set1->max_position = max_position;
-          *dest = set1;
+          new_set1->min_position = 0;
+          new_set1->max_position = 0;
+          new_set1->bitset[0] = (bitSetType) 0;
+          *dest = new_set1;
         } /* if */
-      } /* if */
-      for (position = min_position; position <= max_position; position++) {
-        if (position >= delta->min_position &&
-            position <= delta->max_position) {
-          set1->bitset[position - min_position] &=
-              ~ delta->bitset[position - delta->min_position];
+      } else if (min_position == set1->min_position) {
+        if (max_position != set1->max_position) {
+          new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
+          if (unlikely(new_set1 == NULL)) {
+            /* Strange case if a 'realloc', which shrinks memory, fails. */
+            /* The destination set stays unchanged. */
+            raise_error(MEMORY_ERROR);
+            return;
+          } else {
+            set1 = new_set1;
+            set1->max_position = max_position;
+            *dest = set1;
+          } /* if */
         } /* if */
-      } /* for */
-    } else {
-      for (position = min_position; position <= max_position; position++) {
-        if (position >= delta->min_position &&
-            position <= delta->max_position) {
-          set1->bitset[position - min_position] =
-              set1->bitset[position - set1->min_position] &
-              ~ delta->bitset[position - delta->min_position];
-        } else {
-          set1->bitset[position - min_position] =
-              set1->bitset[position - set1->min_position];
+        start_position = min_position > delta->min_position ?
+            min_position : delta->min_position;
+        stop_position = max_position < delta->max_position ?
+            max_position : delta->max_position;
+        if (start_position <= stop_position) {
+          bitsetCombine(&set1->bitset[start_position - min_position],
+                        &set1->bitset[start_position - min_position],
+                        &delta->bitset[start_position - delta->min_position],
+                        (memSizeType) (uintType) (stop_position - start_position + 1),
+                        BITSET_AND_NOT);
         } /* if */
-      } /* for */
-      new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
-      if (unlikely(new_set1 == NULL)) {
-        /* Strange case if a 'realloc', which shrinks memory, fails. */
-        /* Deliver the result in the original set (that is too big). */
-        set1->min_position = min_position;
-        set1->max_position = max_position;
-        raise_error(MEMORY_ERROR);
       } else {
-        new_set1->min_position = min_position;
-        new_set1->max_position = max_position;
-        *dest = new_set1;
+        /* The bitsets are moved towards the start of set1->bitset. */
+        /* Processing them in ascending order keeps the source intact. */
+        start_position = min_position > delta->min_position ?
+            min_position : delta->min_position;
+        stop_position = max_position < delta->max_position ?
+            max_position : delta->max_position;
+        if (start_position > stop_position) {
+          memmove(set1->bitset, &set1->bitset[min_position - set1->min_position],
+                  (size_t) (uintType) (max_position - min_position + 1) *
+                  sizeof(bitSetType));
+        } else {
+          memmove(set1->bitset, &set1->bitset[min_position - set1->min_position],
+                  (size_t) (uintType) (start_position - min_position) *
+                  sizeof(bitSetType));
+          bitsetCombine(&set1->bitset[start_position - min_position],
+                        &set1->bitset[start_position - set1->min_position],
+                        &delta->bitset[start_position - delta->min_position],
+                        (memSizeType) (uintType) (stop_position - start_position + 1),
+                        BITSET_AND_NOT);
+          memmove(&set1->bitset[stop_position - min_position + 1],
+                  &set1->bitset[stop_position - set1->min_position + 1],
+                  (size_t) (uintType) (max_position - stop_position) *
+                  sizeof(bitSetType));
+        } /* if */
+        new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
+        if (unlikely(new_set1 == NULL)) {
+          /* Strange case if a 'realloc', which shrinks memory, fails. */
+          /* Deliver the result in the original set (that is too big). */
+          set1->min_position = min_position;
+          set1->max_position = max_position;
+          raise_error(MEMORY_ERROR);
+        } else {
+          new_set1->min_position = min_position;
+          new_set1->max_position = max_position;
+          *dest = new_set1;
+        } /* if */
       } /* if */
     } /* if */
     logFunction(printf("setDiffAssign --> ");
@@ -674,6 +1842,13 @@ boolType setElem (const intType number, const const_setType aSet)
       } else {
         return FALSE;
       } /* if */
+    } else if (setIsSparse(aSet)) {
+      bit_index = ((unsigned int) number) & bitset_mask;
+      if (wordAt(aSet, position) & (bitSetType) 1 << bit_index) {
+        return TRUE;
+      } else {
+        return FALSE;
+      } /* if */
     } else {
       return FALSE;
     } /* if */
@@ -701,7 +1876,9 @@ boolType setEq (const const_setType set1, const const_setType set2)
                 printf(", ");
                 prot_set(set2);
                 printf(")\n"););
-    if (set1->min_position == set2->min_position &&
+    if (setIsSparse(set1) || setIsSparse(set2)) {
+      return sparseCmp(set1, set2) == 0;
+    } else if (set1->min_position == set2->min_position &&
         set1->max_position == set2->max_position) {
       return memcmp(set1->bitset, set2->bitset,
           bitsetSize(set1) * sizeof(bitSetType)) == 0;
@@ -806,6 +1983,15 @@ void setExcl (setType *const set_to, const intType number)
         if
       } /* if */
 #endif
+    } else if (setIsSparse(set_dest)) {
+      /* A word, which becomes zero, stays as unused slot. */
+      bitset_index = wordSearch(set_dest, position);
+      if (bitset_index < sparseUsed(set_dest) &&
+          (intType) set_dest->bitset[bitset_index] == position) {
+        bit_index = ((unsigned int) number) & bitset_mask;
+        set_dest->bitset[sparseSize(set_dest) + bitset_index] &=
+            ~((bitSetType) 1 << bit_index);
+      } /* if */
     } /* if */
   } /* setExcl */
 
@@ -820,13 +2006,15 @@ intType setHashCode (const const_setType set1)
   {
     memSizeType bitset_size;
     memSizeType bitset_index;
+    const bitSetType *words;
     intType hashCode;
 
   /* setHashCode */
     hashCode = 0;
-    bitset_size = bitsetSize(set1);
+    bitset_size = wordCount(set1);
+    words = wordArray(set1);
     for (bitset_index = 0; bitset_index < bitset_size; bitset_index++) {
-      hashCode ^= (intType) set1->bitset[bitset_index];
+      hashCode ^= (intType) words[bitset_index];
     } /* for */
     return hashCode;
   } /* setHashCode */
@@ -894,9 +2082,15 @@ void setIncl (setType *const set_to, const intType number)
   /* setIncl */
     set_dest = *set_to;
     position = bitset_pos(number);
-    if (position > set_dest->max_position) {
+    if (setIsSparse(set_dest)) {
+      sparseIncl(set_to, number);
+      return;
+    } else if (position > set_dest->max_position) {
       old_size = bitsetSize(set_dest);
-      if (unlikely((uintType) (position - set_dest->min_position + 1) > MAX_SET_LEN)) {
+      if (useSparseSet(bitsetSize2(set_dest->min_position, position), old_size + 1)) {
+        sparseIncl(set_to, number);
+        return;
+      } else if (unlikely((uintType) (position - set_dest->min_position + 1) > MAX_SET_LEN)) {
         raise_error(MEMORY_ERROR);
         return;
       } else {
@@ -914,7 +2108,10 @@ void setIncl (setType *const set_to, const intType number)
       } /* if */
     } else if (position < set_dest->min_position) {
       old_size = bitsetSize(set_dest);
-      if (unlikely((uintType) (set_dest->max_position - position + 1) > MAX_SET_LEN)) {
+      if (useSparseSet(bitsetSize2(position, set_dest->max_position), old_size + 1)) {
+        sparseIncl(set_to, number);
+        return;
+      } else if (unlikely((uintType) (set_dest->max_position - position + 1) > MAX_SET_LEN)) {
         raise_error(MEMORY_ERROR);
         return;
       } else {
@@ -951,7 +2148,6 @@ setType setIntersect (const const_setType set1, const const_setType set2)
   {
     intType min_position;
     intType max_position;
-    intType position;
     setType intersection;
 
   /* setIntersect */
@@ -960,45 +2156,49 @@ setType setIntersect (const const_setType set1, const const_setType set2)
                 printf(",\n");
                 prot_set(set2);
                 printf(")\n"););
-    if (set1->min_position > set2->min_position) {
-      min_position = set1->min_position;
-    } else {
-      min_position = set2->min_position;
-    } /* if */
-    if (set1->max_position < set2->max_position) {
-      max_position = set1->max_position;
+    if (setIsSparse(set1) || setIsSparse(set2)) {
+      intersection = sparseIntersect(set1, set2);
     } else {
-      max_position = set2->max_position;
-    } /* if */
-    while (min_position <= max_position &&
-           (set1->bitset[min_position - set1->min_position] &
-            set2->bitset[min_position - set2->min_position]) == 0) {
-      min_position++;
-    } /* while */
-    while (min_position <= max_position &&
-           (set1->bitset[max_position - set1->min_position] &
-            set2->bitset[max_position - set2->min_position]) == 0) {
-      max_position--;
-    } /* while */
-    if (min_position > max_position) {
-      if (unlikely(!ALLOC_SET(intersection, 1))) {
-        raise_error(MEMORY_ERROR);
+      if (set1->min_position > set2->min_position) {
+        min_position = set1->min_position;
       } else {
-        intersection->min_position = 0;
-        intersection->max_position = 0;
-        intersection->bitset[0] = (bitSetType) 0;
+        min_position = set2->min_position;
       } /* if */
-    } else {
-      if (unlikely(!ALLOC_SET(intersection, (uintType) (max_position - min_position + 1)))) {
-        raise_error(MEMORY_ERROR);
+      if (set1->max_position < set2->max_position) {
+        max_position = set1->max_position;
       } else {
-        intersection->min_position = min_position;
-        intersection->max_position = max_position;
-        for (position = min_position; position <= max_position; position++) {
-          intersection->bitset[position - min_position] =
-              set1->bitset[position - set1->min_position] &
-              set2->bitset[position - set2->min_position];
-        } /* for */
+        max_position = set2->max_position;
+      } /* if */
+      while (min_position <= max_position &&
+             (set1->bitset[min_position - set1->min_position] &
+              set2->bitset[min_position - set2->min_position]) == 0) {
+        min_position++;
+      } /* while */
+      while (min_position <= max_position &&
+             (set1->bitset[max_position - set1->min_position] &
+              set2->bitset[max_position - set2->min_position]) == 0) {
+        max_position--;
+      } /* while */
+      if (min_position > max_position) {
+        if (unlikely(!ALLOC_SET(intersection, 1))) {
+          raise_error(MEMORY_ERROR);
+        } else {
+          intersection->min_position = 0;
+          intersection->max_position = 0;
+          intersection->bitset[0] = (bitSetType) 0;
+        } /* if */
+      } else {
+        if (unlikely(!ALLOC_SET(intersection, (uintType) (max_position - min_position + 1)))) {
+          raise_error(MEMORY_ERROR);
+        } else {
+          intersection->min_position = min_position;
+          intersection->max_position = max_position;
+          bitsetCombine(intersection->bitset,
+                        &set1->bitset[min_position - set1->min_position],
+                        &set2->bitset[min_position - set2->min_position],
+                        (memSizeType) (uintType) (max_position - min_position + 1),
+                        BITSET_AND);
+        } /* if */
       } /* if */
     } /* if */
     logFunction(printf("setIntersect --> ");
@@ -1019,7 +2219,6 @@ void setIntersectAssign (setType *const dest, const const_setType delta)
     setType set1;
     intType min_position;
     intType max_position;
-    intType position;
     setType new_set1;
 
   /* setIntersectAssign */
@@ -1029,73 +2228,82 @@ void setIntersectAssign (setType *const dest, const const_setType delta)
                 prot_set(delta);
                 printf(")\n"););
     set1 = *dest;
-    if (set1->min_position > delta->min_position) {
-      min_position = set1->min_position;
-    } else {
-      min_position = delta->min_position;
-    } /* if */
-    if (set1->max_position < delta->max_position) {
-      max_position = set1->max_position;
+    if (setIsSparse(set1) || setIsSparse(delta)) {
+      new_set1 = sparseIntersect(set1, delta);
+      if (new_set1 != NULL) {
+        *dest = new_set1;
+        FREE_SET(set1, setAllocSize(set1));
+      } /* if */
     } else {
-      max_position = delta->max_position;
-    } /* if */
-    while (min_position <= max_position &&
-           (set1->bitset[min_position - set1->min_position] &
-            delta->bitset[min_position - delta->min_position]) == 0) {
-      min_position++;
-    } /* while */
-    while (min_position <= max_position &&
-           (set1->bitset[max_position - set1->min_position] &
-            delta->bitset[max_position - delta->min_position]) == 0) {
-      max_position--;
-    } /* while */
-    if (min_position > max_position) {
-      new_set1 = REALLOC_SET(set1, bitsetSize(set1), 1);
-      if (unlikely(new_set1 == NULL)) {
-        /* Strange case if a 'realloc', which shrinks memory, fails. */
-        /* The destination set stays unchanged. */
-        raise_error(MEMORY_ERROR);
+      if (set1->min_position > delta->min_position) {
+        min_position = set1->min_position;
       } else {
-        new_set1->min_position = 0;
-        new_set1->max_position = 0;
-        new_set1->bitset[0] = (bitSetType) 0;
-        *dest = new_set1;
+        min_position = delta->min_position;
       } /* if */
-    } else if (min_position == set1->min_position) {
-      if (max_position != set1->max_position) {
-        new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
+      if (set1->max_position < delta->max_position) {
+        max_position = set1->max_position;
+      } else {
+        max_position = delta->max_position;
+      } /* if */
+      while (min_position <= max_position &&
+             (set1->bitset[min_position - set1->min_position] &
+              delta->bitset[min_position - delta->min_position]) == 0) {
+        min_position++;
+      } /* while */
+      while (min_position <= max_position &&
+             (set1->bitset[max_position - set1->min_position] &
+              delta->bitset[max_position - delta->min_position]) == 0) {
+        max_position--;
+      } /* while */
+      if (min_position > max_position) {
+        new_set1 = REALLOC_SET(set1, bitsetSize(set1), 1);
         if (unlikely(new_set1 == NULL)) {
           /* Strange case if a 'realloc', which shrinks memory, fails. */
           /* The destination set stays unchanged. */
           raise_error(MEMORY_ERROR);
-          return;
         } else {
-          set1 = new_set1;
-          set1->max_position = max_position;
-          *dest = set1;
+          new_set1->min_position = 0;
+          new_set1->max_position = 0;
+          new_set1->bitset[0] = (bitSetType) 0;
+          *dest = new_set1;
         } /* if */
-      } /* if */
-      for (position = min_position; position <= max_position; position++) {
-        set1->bitset[position - min_position] &=
-            delta->bitset[position - delta->min_position];
-      } /* for */
-    } else {
-      for (position = min_position; position <= max_position; position++) {
-        set1->bitset[position - min_position] =
-            set1->bitset[position - set1->min_position] &
-            delta->bitset[position - delta->min_position];
-      } /* for */
-      new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
-      if (unlikely(new_set1 == NULL)) {
-        /* Strange case if a 'realloc', which shrinks memory, fails. */
-        /* Deliver the result in the original set (that is too big). */
-        set1->min_position = min_position;
-        set1->max_position = max_position;
-        raise_error(MEMORY_ERROR);
+      } else if (min_position == set1->min_position) {
+        if (max_position != set1->max_position) {
+          new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
+          if (unlikely(new_set1 == NULL)) {
+            /* Strange case if a 'realloc', which shrinks memory, fails. */
+            /* The destination set stays unchanged. */
+            raise_error(MEMORY_ERROR);
+            return;
+          } else {
+            set1 = new_set1;
+            set1->max_position = max_position;
+            *dest = set1;
+          } /* if */
+        } /* if */
+        bitsetCombine(set1->bitset, set1->bitset,
+                      &delta->bitset[min_position - delta->min_position],
+                      (memSizeType) (uintType) (max_position - min_position + 1),
+                      BITSET_AND);
       } else {
-        new_set1->min_position = min_position;
-        new_set1->max_position = max_position;
-        *dest = new_set1;
+        /* The bitsets are moved towards the start of set1->bitset. */
+        bitsetCombine(set1->bitset,
+                      &set1->bitset[min_position - set1->min_position],
+                      &delta->bitset[min_position - delta->min_position],
+                      (memSizeType) (uintType) (max_position - min_position + 1),
+                      BITSET_AND);
+        new_set1 = REALLOC_SET(set1, bitsetSize(set1), bitsetSize2(min_position, max_position));
+        if (unlikely(new_set1 == NULL)) {
+          /* Strange case if a 'realloc', which shrinks memory, fails. */
+          /* Deliver the result in the original set (that is too big). */
+          set1->min_position = min_position;
+          set1->max_position = max_position;
+          raise_error(MEMORY_ERROR);
+        } else {
+          new_set1->min_position = min_position;
+          new_set1->max_position = max_position;
+          *dest = new_set1;
+        } /* if */
       } /* if */
     } /* if */
     logFunction(printf("setIntersectAssign --> ");
@@ -1116,6 +2324,9 @@ boolType setIsEmpty (const const_setType set1)
     register memSizeType bitset_index;
 
   /* setIsEmpty */
+    if (setIsSparse(set1)) {
+      return bitsetNonZero(wordArray(set1), wordCount(set1)) == NULL;
+    } /* if */
     bitset_index = bitsetSize(set1);
     do {
       bitset_index--;
@@ -1152,6 +2363,9 @@ boolType setIsProperSubset (const const_setType set1, const const_setType set2)
                 printf(", ");
                 prot_set(set2);
                 printf(")\n"););
+    if (setIsSparse(set1) || setIsSparse(set2)) {
+      return sparseIsSubset(set1, set2) && sparseCmp(set1, set2) != 0;
+    } /* if */
     equal = TRUE;
     if (set1->min_position < set2->min_position) {
       if (set1->max_position < set2->min_position) {
@@ -1257,6 +2471,9 @@ boolType setIsSubset (const const_setType set1, const const_setType set2)
                 printf(", ");
                 prot_set(set2);
                 printf(")\n"););
+    if (setIsSparse(set1) || setIsSparse(set2)) {
+      return sparseIsSubset(set1, set2);
+    } /* if */
     if (set1->min_position < set2->min_position) {
       if (set1->max_position < set2->min_position) {
         size = 0;
@@ -1306,12 +2523,7 @@ boolType setIsSubset (const const_setType set1, const const_setType set2)
         } /* if */
       } /* for */
     } /* if */
-    for (bitset_index = 0; bitset_index < size; bitset_index++, bitset1++, bitset2++) {
-      if ((~ *bitset1 | *bitset2) != ~(bitSetType) 0) {
-        return FALSE;
-      } /* if */
-    } /* for */
-    return TRUE;
+    return bitsetIsSubset(bitset1, bitset2, size);
   } /* setIsSubset */
 
 
@@ -1328,17 +2540,19 @@ intType setMax (const const_setType aSet)
 
   {
     memSizeType bitset_index;
+    const bitSetType *words;
     bitSetType curr_bitset;
     intType result;
 
   /* setMax */
-    bitset_index = bitsetSize(aSet);
+    bitset_index = wordCount(aSet);
+    words = wordArray(aSet);
     while (bitset_index > 0) {
       bitset_index--;
-      curr_bitset = aSet->bitset[bitset_index];
+      curr_bitset = words[bitset_index];
       if (curr_bitset != 0) {
         result = bitsetMostSignificantBit(curr_bitset);
-        result += lowestBitsetPosAsInteger(aSet->min_position + (intType) bitset_index);
+        result += lowestBitsetPosAsInteger(wordPosition(aSet, bitset_index));
         return result;
       } /* if */
     } /* while */
@@ -1362,17 +2576,19 @@ intType setMin (const const_setType aSet)
   {
     memSizeType bitset_size;
     memSizeType bitset_index;
+    const bitSetType *words;
     bitSetType curr_bitset;
     intType result;
 
   /* setMin */
-    bitset_size = bitsetSize(aSet);
+    bitset_size = wordCount(aSet);
+    words = wordArray(aSet);
     bitset_index = 0;
     while (bitset_index < bitset_size) {
-      curr_bitset = aSet->bitset[bitset_index];
+      curr_bitset = words[bitset_index];
       if (curr_bitset != 0) {
-        result = bitsetLeastSignificantBit(curr_bitset);
-        result += lowestBitsetPosAsInteger(aSet->min_position + (intType) bitset_index);
+        result = bitsetTrailingZeros(curr_bitset);
+        result += lowestBitsetPosAsInteger(wordPosition(aSet, bitset_index));
         return result;
       } /* if */
       bitset_index++;
@@ -1396,6 +2612,7 @@ intType setNext (const const_setType aSet, const intType number)
     memSizeType bitset_size;
     memSizeType bitset_index;
     unsigned int bit_index;
+    const bitSetType *words;
     bitSetType curr_bitset;
     const bitSetType *bitset_ptr;
     intType nextNumber;
@@ -1412,14 +2629,13 @@ intType setNext (const const_setType aSet, const intType number)
       nextNumber = 0;
     } else {
       position = bitset_pos(number + 1);
-      if (position < aSet->min_position) {
-        position = aSet->min_position;
-        bit_index = 0;
-      } else {
+      bitset_size = wordCount(aSet);
+      bitset_index = wordSearch(aSet, position);
+      if (bitset_index < bitset_size && wordPosition(aSet, bitset_index) == position) {
         bit_index = ((unsigned int) (number + 1)) & bitset_mask;
+      } else {
+        bit_index = 0;
       } /* if */
-      bitset_size = bitsetSize(aSet);
-      bitset_index = bitsetIndex(aSet, position);
       if (unlikely(bitset_index >= bitset_size)) {
         logError(printf("setNext(aSet, " FMT_D "): "
                         "The number is beyond the maximum element of the set.\n",
@@ -1427,13 +2643,14 @@ intType setNext (const const_setType aSet, const intType number)
         raise_error(RANGE_ERROR);
         nextNumber = 0;
       } else {
-        curr_bitset = (aSet->bitset[bitset_index] >> bit_index) << bit_index;
+        words = wordArray(aSet);
+        curr_bitset = (words[bitset_index] >> bit_index) << bit_index;
         if (curr_bitset != 0) {
-          nextNumber = bitsetLeastSignificantBit(curr_bitset);
-          nextNumber += lowestBitsetPosAsInteger(aSet->min_position + (intType) bitset_index);
+          nextNumber = bitsetTrailingZeros(curr_bitset);
+          nextNumber += lowestBitsetPosAsInteger(wordPosition(aSet, bitset_index));
         } else {
           bitset_index++;
-          bitset_ptr = bitsetNonZero(&aSet->bitset[bitset_index], bitset_size - bitset_index);
+          bitset_ptr = bitsetNonZero(&words[bitset_index], bitset_size - bitset_index);
           if (unlikely(bitset_ptr == NULL)) {
             logError(printf("setNext(aSet, " FMT_D "): "
                             "The maximum element of a set has no next element.\n",
@@ -1441,9 +2658,9 @@ intType setNext (const const_setType aSet, const intType number)
             raise_error(RANGE_ERROR);
             nextNumber = 0;
           } else {
-            bitset_index = (memSizeType) (bitset_ptr - aSet->bitset);
-            nextNumber = bitsetLeastSignificantBit(*bitset_ptr);
-            nextNumber += lowestBitsetPosAsInteger(aSet->min_position + (intType) bitset_index);
+            bitset_index = (memSizeType) (bitset_ptr - words);
+            nextNumber = bitsetTrailingZeros(*bitset_ptr);
+            nextNumber += lowestBitsetPosAsInteger(wordPosition(aSet, bitset_index));
           } /* if */
         } /* if */
       } /* if */
@@ -1466,6 +2683,7 @@ intType setRand (const const_setType aSet)
     intType num_elements;
     intType elem_index;
     memSizeType bitset_index;
+    const bitSetType *words;
     bitSetType curr_bitset;
     intType result;
 
@@ -1477,20 +2695,21 @@ intType setRand (const const_setType aSet)
       return 0;
     } else {
       elem_index = intRand(1, num_elements);
-      for (bitset_index = bitsetSize(aSet);
+      words = wordArray(aSet);
+      for (bitset_index = wordCount(aSet);
            bitset_index > 0 && elem_index > BITSETTYPE_SIZE; bitset_index--) {
-        curr_bitset = aSet->bitset[bitset_index - 1];
+        curr_bitset = words[bitset_index - 1];
         /* If elem_index > BITSETTYPE_SIZE holds */
         /* the element cannot be in curr_bitset. */
         elem_index -= (intType) bitsetPopulation(curr_bitset);
       } /* for */
       for (; bitset_index > 0; bitset_index--) {
-        curr_bitset = aSet->bitset[bitset_index - 1];
+        curr_bitset = words[bitset_index - 1];
         while (curr_bitset != 0) {
           elem_index--;
           if (elem_index == 0) {
             result = bitsetLeastSignificantBit(curr_bitset) +
-                lowestBitsetPosAsInteger(aSet->min_position + (intType) (bitset_index - 1));
+                lowestBitsetPosAsInteger(wordPosition(aSet, bitset_index - 1));
             return result;
           } /* if */
           /* Turn off the rightmost one bit of curr_bitset: */
@@ -1611,7 +2830,6 @@ intType setSConv (const const_setType aSet)
 setType setSymdiff (const const_setType set1, const const_setType set2)
 
   {
-    intType position;
     intType min_position;
     intType max_position;
     intType start_position;
@@ -1638,7 +2856,11 @@ setType setSymdiff (const const_setType set1, const const_setType set2)
       max_position = set2->max_position;
       stop_position = set1->max_position;
     } /* if */
-    if (unlikely((uintType) (max_position - min_position + 1) > MAX_SET_LEN ||
+    if (setIsSparse(set1) || setIsSparse(set2) ||
+        useSparseSet(bitsetSize2(min_position, max_position),
+                     bitsetSize(set1) + bitsetSize(set2))) {
+      symDiff = sparseUnion(set1, set2, TRUE);
+    } else if (unlikely((uintType) (max_position - min_position + 1) > MAX_SET_LEN ||
         !ALLOC_SET(symDiff, (uintType) (max_position - min_position + 1)))) {
       raise_error(MEMORY_ERROR);
       symDiff = NULL;
@@ -1675,11 +2897,11 @@ setType setSymdiff (const const_setType set1, const const_setType set2)
                  (size_t) (uintType) (set1->max_position - set2->max_position) *
                  sizeof(bitSetType));
         } /* if */
-        for (position = start_position; position <= stop_position; position++) {
-          symDiff->bitset[position - min_position] =
-              set1->bitset[position - set1->min_position] ^
-              set2->bitset[position - set2->min_position];
-        } /* for */
+        bitsetCombine(&symDiff->bitset[start_position - min_position],
+                      &set1->bitset[start_position - set1->min_position],
+                      &set2->bitset[start_position - set2->min_position],
+                      (memSizeType) (uintType) (stop_position - start_position + 1),
+                      BITSET_XOR);
       } /* if */
     } /* if */
     logFunction(printf("setSymdiff --> ");
@@ -1708,7 +2930,14 @@ uintType setToUInt (const const_setType set1, const intType lowestBitNum)
                 prot_set(set1);
                 printf(", " FMT_D ")\n", lowestBitNum););
     position = bitset_pos(lowestBitNum);
-    if (position >= set1->min_position && position <= set1->max_position) {
+    if (setIsSparse(set1)) {
+      bit_index = ((unsigned int) lowestBitNum) & bitset_mask;
+      bitPattern = (uintType) (wordAt(set1, position) >> bit_index);
+      if (bit_index != 0) {
+        bitPattern |= (uintType) (wordAt(set1, position + 1) <<
+            (CHAR_BIT * sizeof(bitSetType) - bit_index));
+      } /* if */
+    } else if (position >= set1->min_position && position <= set1->max_position) {
       bitset_index = bitsetIndex(set1, position);
       bit_index = ((unsigned int) lowestBitNum) & bitset_mask;
       if (bit_index == 0) {
@@ -1745,7 +2974,6 @@ uintType setToUInt (const const_setType set1, const intType lowestBitNum)
 setType setUnion (const const_setType set1, const const_setType set2)
 
   {
-    intType position;
     intType min_position;
     intType max_position;
     intType start_position;
@@ -1772,7 +3000,11 @@ setType setUnion (const const_setType set1, const const_setType set2)
       max_position = set2->max_position;
       stop_position = set1->max_position;
     } /* if */
-    if (unlikely((uintType) (max_position - min_position + 1) > MAX_SET_LEN ||
+    if (setIsSparse(set1) || setIsSparse(set2) ||
+        useSparseSet(bitsetSize2(min_position, max_position),
+                     bitsetSize(set1) + bitsetSize(set2))) {
+      unionOfSets = sparseUnion(set1, set2, FALSE);
+    } else if (unlikely((uintType) (max_position - min_position + 1) > MAX_SET_LEN ||
         !ALLOC_SET(unionOfSets, (uintType) (max_position - min_position + 1)))) {
       raise_error(MEMORY_ERROR);
       unionOfSets = NULL;
@@ -1809,11 +3041,11 @@ setType setUnion (const const_setType set1, const const_setType set2)
                  (size_t) (uintType) (set1->max_position - set2->max_position) *
                  sizeof(bitSetType));
         } /* if */
-        for (position = start_position; position <= stop_position; position++) {
-          unionOfSets->bitset[position - min_position] =
-              set1->bitset[position - set1->min_position] |
-              set2->bitset[position - set2->min_position];
-        } /* for */
+        bitsetCombine(&unionOfSets->bitset[start_position - min_position],
+                      &set1->bitset[start_position - set1->min_position],
+                      &set2->bitset[start_position - set2->min_position],
+                      (memSizeType) (uintType) (stop_position - start_position + 1),
+                      BITSET_OR);
       } /* if */
     } /* if */
     logFunction(printf("setUnion --> ");
@@ -1832,7 +3064,6 @@ void setUnionAssign (setType *const dest, const const_setType delta)
 
   {
     setType set1;
-    intType position;
     intType min_position;
     intType max_position;
     intType start_position;
@@ -1860,12 +3091,21 @@ void setUnionAssign (setType *const dest, const const_setType delta)
       max_position = delta->max_position;
       stop_position = set1->max_position;
     } /* if */
-    if (set1->min_position == min_position &&
+    if (setIsSparse(set1) || setIsSparse(delta) ||
+        useSparseSet(bitsetSize2(min_position, max_position),
+                     bitsetSize(set1) + bitsetSize(delta))) {
+      new_dest = sparseUnion(set1, delta, FALSE);
+      if (new_dest != NULL) {
+        *dest = new_dest;
+        FREE_SET(set1, setAllocSize(set1));
+      } /* if */
+    } else if (set1->min_position == min_position &&
         set1->max_position == max_position) {
-      for (position = start_position; position <= stop_position; position++) {
-        set1->bitset[position - min_position] |=
-            delta->bitset[position - delta->min_position];
-      } /* for */
+      bitsetCombine(&set1->bitset[start_position - min_position],
+                    &set1->bitset[start_position - min_position],
+                    &delta->bitset[start_position - delta->min_position],
+                    (memSizeType) (uintType) (stop_position - start_position + 1),
+                    BITSET_OR);
     } else {
       if (unlikely((uintType) (max_position - min_position + 1) > MAX_SET_LEN ||
           !ALLOC_SET(new_dest, (uintType) (max_position - min_position + 1)))) {
@@ -1903,11 +3143,11 @@ void setUnionAssign (setType *const dest, const const_setType delta)
                    (size_t) (uintType) (set1->max_position - delta->max_position) *
                    sizeof(bitSetType));
           } /* if */
-          for (position = start_position; position <= stop_position; position++) {
-            new_dest->bitset[position - min_position] =
-                set1->bitset[position - set1->min_position] |
-                delta->bitset[position - delta->min_position];
-          } /* for */
+          bitsetCombine(&new_dest->bitset[start_position - min_position],
+                        &set1->bitset[start_position - set1->min_position],
+                        &delta->bitset[start_position - delta->min_position],
+                        (memSizeType) (uintType) (stop_position - start_position + 1),
+                        BITSET_OR);
         } /* if */
         *dest = new_dest;
         FREE_SET(set1, bitsetSize(set1));
@@ -82,7 +82,7 @@ objectType set_arrlit (listType arguments)
         for (array_index = 1; array_index < length; array_index++) {
           setIncl(&result, take_int(&arr1->arr[array_index]));
           if (fail_flag) {
-            FREE_SET(result, bitsetSize(result));
+            FREE_SET(result, setAllocSize(result));
             return fail_value;
           } /* if */
         } /* for */
@@ -221,15 +221,15 @@ objectType set_cpy (listType arguments)
     set_dest = take_set(dest);
     set_source = take_set(source);
     if (TEMP_OBJECT(source)) {
-      set_dest_size = bitsetSize(set_dest);
+      set_dest_size = setAllocSize(set_dest);
       FREE_SET(set_dest, set_dest_size);
       dest->value.setValue = set_source;
       source->value.setValue = NULL;
     } else {
-      set_source_size = bitsetSize(set_source);
+      set_source_size = setAllocSize(set_source);
       if (set_dest->min_position != set_source->min_position ||
           set_dest->max_position != set_source->max_position) {
-        set_dest_size = bitsetSize(set_dest);
+        set_dest_size = setAllocSize(set_dest);
         if (set_dest_size != set_source_size) {
           if (!ALLOC_SET(set_dest, set_source_size)) {
             return raise_exception(SYS_MEM_EXCEPTION);
@@ -278,7 +278,7 @@ objectType set_create (listType arguments)
       dest->value.setValue = set_source;
       source->value.setValue = NULL;
     } else {
-      new_size = bitsetSize(set_source);
+      new_size = setAllocSize(set_source);
       if (!ALLOC_SET(new_set, new_size)) {
         dest->value.setValue = NULL;
         return raise_exception(SYS_MEM_EXCEPTION);
@@ -310,7 +310,7 @@ objectType set_destr (listType arguments)
     isit_set(arg_1(arguments));
     old_set = take_set(arg_1(arguments));
     if (old_set != NULL) {
-      FREE_SET(old_set, bitsetSize(old_set));
+      FREE_SET(old_set, setAllocSize(old_set));
       arg_1(arguments)->value.setValue = NULL;
     } /* if */
     SET_UNUSED_FLAG(arg_1(arguments));
@@ -384,6 +384,8 @@ objectType set_elem (listType arguments)
       } else {
         return SYS_FALSE_OBJECT;
       } /* if */
+    } else if (setIsSparse(aSet) && setElem(number, aSet)) {
+      return SYS_TRUE_OBJECT;
     } else {
       return SYS_FALSE_OBJECT;
     } /* if */
@@ -464,6 +466,8 @@ objectType set_excl (listType arguments)
         if
       } /* if */
 #endif
+    } else if (setIsSparse(set_dest)) {
+      setExcl(&set_to->value.setValue, number);
     } /* if */
     return SYS_EMPTY_OBJECT;
   } /* set_excl */
@@ -583,6 +587,8 @@ objectType set_idx (listType arguments)
       } else {
         return SYS_FALSE_OBJECT;
       } /* if */
+    } else if (setIsSparse(aSet) && setElem(number, aSet)) {
+      return SYS_TRUE_OBJECT;
     } else {
       return SYS_FALSE_OBJECT;
     } /* if */
@@ -602,9 +608,6 @@ objectType set_incl (listType arguments)
     setType set_dest;
     intType number;
     intType position;
-    memSizeType old_size;
-    memSizeType new_size;
-    setType old_set;
     memSizeType bitset_index;
     unsigned int bit_index;
 
@@ -616,46 +619,15 @@ objectType set_incl (listType arguments)
     isit_int(arg_2(arguments));
     number = take_int(arg_2(arguments));
     position = bitset_pos(number);
-    if (position > set_dest->max_position) {
-      old_size = bitsetSize(set_dest);
-      if (unlikely((uintType) (position - set_dest->min_position + 1) > MAX_SET_LEN)) {
-        return raise_exception(SYS_MEM_EXCEPTION);
-      } else {
-        new_size = bitsetSize2(set_dest->min_position, position);
-        set_dest = REALLOC_SET(set_dest, old_size, new_size);
-        if (set_dest == NULL) {
-          return raise_exception(SYS_MEM_EXCEPTION);
-        } else {
-          COUNT3_SET(old_size, new_size);
-          set_to->value.setValue = set_dest;
-          set_dest->max_position = position;
-          memset(&set_dest->bitset[old_size], 0,
-                 (new_size - old_size) * sizeof(bitSetType));
-        } /* if */
-      } /* if */
-    } else if (position < set_dest->min_position) {
-      old_size = bitsetSize(set_dest);
-      if (unlikely((uintType) (set_dest->max_position - position + 1) > MAX_SET_LEN)) {
-        return raise_exception(SYS_MEM_EXCEPTION);
-      } else {
-        new_size = bitsetSize2(position, set_dest->max_position);
-        old_set = set_dest;
-        if (!ALLOC_SET(set_dest, new_size)) {
-          return raise_exception(SYS_MEM_EXCEPTION);
-        } else {
-          set_to->value.setValue = set_dest;
-          set_dest->min_position = position;
-          set_dest->max_position = old_set->max_position;
-          memset(set_dest->bitset, 0, (new_size - old_size) * sizeof(bitSetType));
-          memcpy(&set_dest->bitset[new_size - old_size], old_set->bitset,
-                 old_size * sizeof(bitSetType));
-          FREE_SET(old_set, old_size);
-        } /* if */
-      } /* if */
+    if (position >= set_dest->min_position && position <= set_dest->max_position) {
+      bitset_index = bitsetIndex(set_dest, position);
+      bit_index = ((unsigned int) number) & bitset_mask;
+      set_dest->bitset[bitset_index] |= (((bitSetType) 1) << bit_index);
+    } else {
+      /* Growing the set or switching to the sparse */
+      /* representation is done by setIncl().       */
+      setIncl(&set_to->value.setValue, number);
     } /* if */
-    bitset_index = bitsetIndex(set_dest, position);
-    bit_index = ((unsigned int) number) & bitset_mask;
-    set_dest->bitset[bitset_index] |= (((bitSetType) 1) << bit_index);
     return SYS_EMPTY_OBJECT;
   } /* set_incl */
 
@@ -841,6 +813,8 @@ objectType set_not_elem (listType arguments)
       } else {
         return SYS_TRUE_OBJECT;
       } /* if */
+    } else if (setIsSparse(aSet) && setElem(number, aSet)) {
+      return SYS_FALSE_OBJECT;
     } else {
       return SYS_TRUE_OBJECT;
     } /* if */
@@ -986,7 +960,7 @@ objectType set_value (listType arguments)
       return raise_exception(SYS_RNG_EXCEPTION);
     } else {
       aSet = take_set(obj_arg);
-      set_size = bitsetSize(aSet);
+      set_size = setAllocSize(aSet);
       if (!ALLOC_SET(result, set_size)) {
         return raise_exception(SYS_MEM_EXCEPTION);
       } else {
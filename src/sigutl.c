@@ -140,6 +140,38 @@ void triggerSigfpe (void)
 
 
 
+/**
+ *  Raise the exception 'exceptionNum' from within a signal handler.
+ *  Compiled programs enter exception handlers with a setjmp that does
+ *  not save the signal mask. If raise_error() leaves the signal handler
+ *  with a longjmp the signal would stay blocked afterwards. Therefore
+ *  the signal and SIGALRM, which is blocked by all handlers, are
+ *  unblocked here. This way the system call is only done if an
+ *  exception is raised and not every time a handler is entered.
+ */
+static void raiseFromSignalHandler (int signalNum, int exceptionNum)
+
+  {
+#if HAS_SIGACTION
+    sigset_t signalSet;
+#endif
+
+  /* raiseFromSignalHandler */
+    logSignalFunction(printf("raiseFromSignalHandler(%d, %d)\n",
+                             signalNum, exceptionNum););
+#if HAS_SIGACTION
+    sigemptyset(&signalSet);
+    sigaddset(&signalSet, signalNum);
+#ifdef SIGALRM
+    sigaddset(&signalSet, SIGALRM);
+#endif
+    sigprocmask(SIG_UNBLOCK, &signalSet, NULL);
+#endif
+    raise_error(exceptionNum);
+  } /* raiseFromSignalHandler */
+
+
+
 /**
  *  Dialog to decide how to continue after a signal has been received.
  *  This function might be called from a signal handler. Note that this
@@ -198,7 +230,11 @@ static boolType signalDecision (int signalNum, boolType inHandler)
       buffer[position] = '\0';
       if (position > 0 && buffer[0] >= '0' && buffer[0] <= '9') {
         exceptionNum = strtoul(buffer, NULL, 10);
-        raise_error((int) exceptionNum);
+        if (inHandler) {
+          raiseFromSignalHandler(signalNum, (int) exceptionNum);
+        } else {
+          raise_error((int) exceptionNum);
+        } /* if */
       } /* if */
     } else {
       resume = TRUE;
@@ -247,7 +283,7 @@ static void handleNumericError (int signalNum)
 #if SIGNAL_RESETS_HANDLER
     signal(signalNum, handleNumericError);
 #endif
-    raise_error(NUMERIC_ERROR);
+    raiseFromSignalHandler(signalNum, NUMERIC_ERROR);
   } /* handleNumericError */
 
 
@@ -262,7 +298,7 @@ static void handleOverflowError (int signalNum)
 #if SIGNAL_RESETS_HANDLER
     signal(signalNum, handleOverflowError);
 #endif
-    raise_error(OVERFLOW_ERROR);
+    raiseFromSignalHandler(signalNum, OVERFLOW_ERROR);
   }
 #endif
 
@@ -51,11 +51,28 @@
 #include "str_rtl.h"
 
 
-#define CHAR_DELTA_BEYOND  128
+#define TWO_WAY_SHIFT_TABLE_SIZE 256
 #define INITIAL_ARRAY_SIZE 256
 #define ARRAY_SIZE_FACTOR    2
-#define BOYER_MOORE_SEARCHED_STRI_THRESHOLD    2
-#define BOYER_MOORE_MAIN_STRI_THRESHOLD     1400
+#define TWO_WAY_MAIN_STRI_THRESHOLD 1400
+
+/* The vectorized memmem_strelem is faster than the Two-Way     */
+/* search for short searched strings. For long searched strings */
+/* it verifies every candidate with a comparison that can take  */
+/* O(length(searched)) steps, so Two-Way is used for them.      */
+#if HAS_SSE2_INTRINSICS || HAS_AVX2_TARGET_ATTRIBUTE
+#define TWO_WAY_FORWARD_SEARCHED_STRI_THRESHOLD 64
+#else
+#define TWO_WAY_FORWARD_SEARCHED_STRI_THRESHOLD  2
+#endif
+#define TWO_WAY_BACKWARD_SEARCHED_STRI_THRESHOLD 2
+
+typedef struct {
+    memSizeType critical_pos;
+    memSizeType period;
+    boolType periodic;
+    memSizeType shift[TWO_WAY_SHIFT_TABLE_SIZE];
+  } twoWaySearchType;
 
 /* memset_to_strelem is not used because it is */
 /* only better for lengths greater than 7.     */
@@ -67,6 +84,25 @@
 #define RESIZE_THRESHOLD 8
 #endif
 
+/* A build, which processes keys from untrusted sources, can   */
+/* define a secret STRI_HASH_SEED to make collisions unlikely. */
+#ifndef STRI_HASH_SEED
+#define STRI_HASH_SEED 0x2545f491
+#endif
+
+#if INTTYPE_SIZE == 64
+#define STRI_HASH_MULTIPLIER UINT_SUFFIX(0x9e3779b97f4a7c15)
+#define STRI_HASH_FINAL_MULTIPLIER UINT_SUFFIX(0xff51afd7ed558ccd)
+#else
+#define STRI_HASH_MULTIPLIER UINT_SUFFIX(0x9e3779b9)
+#define STRI_HASH_FINAL_MULTIPLIER UINT_SUFFIX(0x85ebca6b)
+#endif
+#define STRI_HASH_STEP(hash, value) \
+    ((((hash) << 5 | (hash) >> (INTTYPE_SIZE - 5)) ^ (value)) * STRI_HASH_MULTIPLIER)
+
+/* Size of the buffers used to compare and hash lower case strings. */
+#define CASE_FOLD_BUFFER_SIZE 64
+
 
 
 #if HAS_WMEMCMP && WCHAR_T_SIZE == 32
@@ -92,25 +128,6 @@ static inline int memcmp_strelem (register const strElemType *mem1,
 
 
 
-static inline const strElemType *search_strelem2 (const strElemType *mem,
-    const strElemType ch, const strElemType *const beyond,
-    const memSizeType charDelta[])
-
-  { /* search_strelem2 */
-    while (mem < beyond) {
-      if (*mem == ch) {
-        return mem;
-      } else if (*mem < CHAR_DELTA_BEYOND) {
-        mem += charDelta[*mem];
-      } else {
-        mem += charDelta[CHAR_DELTA_BEYOND];
-      } /* if */
-    } /* while */
-    return NULL;
-  } /* search_strelem2 */
-
-
-
 static inline const strElemType *rsearch_strelem (const strElemType *mem,
     const strElemType ch, size_t len)
 
@@ -125,22 +142,207 @@ static inline const strElemType *rsearch_strelem (const strElemType *mem,
 
 
 
-static inline const strElemType *rsearch_strelem2 (const strElemType *mem,
-    const strElemType ch, const strElemType *const beyond,
-    const memSizeType charDelta[])
+/**
+ *  Character 'pos' of a string, which is read from left to right.
+ *  If 'reverse' is TRUE the string is read from right to left and
+ *  'mem' points to its last character.
+ */
+#define STEP_ELEM(mem, reverse, pos) ((reverse) ? *((mem) - (pos)) : (mem)[pos])
 
-  { /* rsearch_strelem2 */
-    while (mem > beyond) {
-      if (*mem == ch) {
-        return mem;
-      } else if (*mem < CHAR_DELTA_BEYOND) {
-        mem -= charDelta[*mem];
+
+
+/**
+ *  Determine the critical factorization of 'searched' for Two-Way.
+ *  The critical position is the larger of the starting positions of
+ *  the maximal suffixes for the orderings <= and >= .
+ *  @param period Receives the period of the right half of the
+ *         factorization.
+ *  @return the critical position.
+ */
+static memSizeType critical_factorization (const strElemType *searched,
+    const memSizeType searched_size, const boolType reverse,
+    memSizeType *period)
+
+  {
+    memSizeType max_suffix;
+    memSizeType max_suffix_rev;
+    memSizeType index;
+    memSizeType offset;
+    memSizeType suffix_period;
+    strElemType ch_a;
+    strElemType ch_b;
+
+  /* critical_factorization */
+    /* The start value MAX_MEMSIZETYPE stands for -1. */
+    max_suffix = MAX_MEMSIZETYPE;
+    index = 0;
+    offset = 1;
+    suffix_period = 1;
+    while (index + offset < searched_size) {
+      ch_a = STEP_ELEM(searched, reverse, index + offset);
+      ch_b = STEP_ELEM(searched, reverse, max_suffix + offset);
+      if (ch_a < ch_b) {
+        index += offset;
+        offset = 1;
+        suffix_period = index - max_suffix;
+      } else if (ch_a == ch_b) {
+        if (offset != suffix_period) {
+          offset++;
+        } else {
+          index += suffix_period;
+          offset = 1;
+        } /* if */
       } else {
-        mem -= charDelta[CHAR_DELTA_BEYOND];
+        max_suffix = index;
+        index++;
+        offset = 1;
+        suffix_period = 1;
+      } /* if */
+    } /* while */
+    *period = suffix_period;
+    max_suffix_rev = MAX_MEMSIZETYPE;
+    index = 0;
+    offset = 1;
+    suffix_period = 1;
+    while (index + offset < searched_size) {
+      ch_a = STEP_ELEM(searched, reverse, index + offset);
+      ch_b = STEP_ELEM(searched, reverse, max_suffix_rev + offset);
+      if (ch_b < ch_a) {
+        index += offset;
+        offset = 1;
+        suffix_period = index - max_suffix_rev;
+      } else if (ch_a == ch_b) {
+        if (offset != suffix_period) {
+          offset++;
+        } else {
+          index += suffix_period;
+          offset = 1;
+        } /* if */
+      } else {
+        max_suffix_rev = index;
+        index++;
+        offset = 1;
+        suffix_period = 1;
+      } /* if */
+    } /* while */
+    if (max_suffix_rev + 1 < max_suffix + 1) {
+      return max_suffix + 1;
+    } else {
+      *period = suffix_period;
+      return max_suffix_rev + 1;
+    } /* if */
+  } /* critical_factorization */
+
+
+
+/**
+ *  Prepare the search of 'searched' with the Two-Way algorithm.
+ *  Besides the critical factorization a Horspool shift table is
+ *  computed. Since characters have 32 bits the table is indexed with
+ *  the lower bits of a character. Characters, which share an entry,
+ *  get the smallest shift of them.
+ */
+static void init_two_way (twoWaySearchType *twoWay,
+    const strElemType *searched, const memSizeType searched_size,
+    const boolType reverse)
+
+  {
+    memSizeType pos;
+
+  /* init_two_way */
+    twoWay->critical_pos = critical_factorization(searched, searched_size,
+                                                  reverse, &twoWay->period);
+    for (pos = 0; pos < TWO_WAY_SHIFT_TABLE_SIZE; pos++) {
+      twoWay->shift[pos] = searched_size;
+    } /* for */
+    for (pos = 0; pos < searched_size; pos++) {
+      twoWay->shift[STEP_ELEM(searched, reverse, pos) &
+                    (TWO_WAY_SHIFT_TABLE_SIZE - 1)] = searched_size - pos - 1;
+    } /* for */
+    pos = 0;
+    while (pos < twoWay->critical_pos &&
+           STEP_ELEM(searched, reverse, pos) ==
+           STEP_ELEM(searched, reverse, pos + twoWay->period)) {
+      pos++;
+    } /* while */
+    twoWay->periodic = pos == twoWay->critical_pos;
+    if (!twoWay->periodic) {
+      if (twoWay->critical_pos > searched_size - twoWay->critical_pos) {
+        twoWay->period = twoWay->critical_pos + 1;
+      } else {
+        twoWay->period = searched_size - twoWay->critical_pos + 1;
+      } /* if */
+    } /* if */
+  } /* init_two_way */
+
+
+
+/**
+ *  Search 'searched' in 'mem' with the Two-Way algorithm.
+ *  The number of character comparisons is linear in 'main_size'.
+ *  The Horspool shift table allows to skip parts of 'mem'.
+ *  If 'reverse' is TRUE 'mem' and 'searched' point to the last
+ *  character of their string and the search proceeds to the left.
+ *  @param twoWay Result of init_two_way for 'searched' and 'reverse'.
+ *  @return a pointer to the leftmost character of the match, or NULL
+ *          if 'searched' is not found.
+ */
+static const strElemType *search_two_way (const twoWaySearchType *twoWay,
+    const strElemType *mem, const memSizeType main_size,
+    const strElemType *searched, const memSizeType searched_size,
+    const boolType reverse)
+
+  {
+    memSizeType start = 0;
+    memSizeType pos;
+    memSizeType shift;
+    memSizeType memory = 0;
+
+  /* search_two_way */
+    while (start <= main_size - searched_size) {
+      shift = twoWay->shift[STEP_ELEM(mem, reverse, start + searched_size - 1) &
+                            (TWO_WAY_SHIFT_TABLE_SIZE - 1)];
+      if (shift != 0) {
+        if (memory != 0 && shift < twoWay->period) {
+          shift = searched_size - twoWay->period;
+        } /* if */
+        memory = 0;
+        start += shift;
+      } else {
+        pos = twoWay->critical_pos > memory ? twoWay->critical_pos : memory;
+        while (pos < searched_size &&
+               STEP_ELEM(searched, reverse, pos) ==
+               STEP_ELEM(mem, reverse, start + pos)) {
+          pos++;
+        } /* while */
+        if (pos < searched_size) {
+          start += pos - twoWay->critical_pos + 1;
+          memory = 0;
+        } else {
+          /* The start value of pos may be MAX_MEMSIZETYPE, */
+          /* which stands for -1.                           */
+          pos = twoWay->critical_pos - 1;
+          while (pos + 1 > memory &&
+                 STEP_ELEM(searched, reverse, pos) ==
+                 STEP_ELEM(mem, reverse, start + pos)) {
+            pos--;
+          } /* while */
+          if (pos + 1 <= memory) {
+            if (reverse) {
+              return mem - start - (searched_size - 1);
+            } else {
+              return &mem[start];
+            } /* if */
+          } /* if */
+          start += twoWay->period;
+          if (twoWay->periodic) {
+            memory = searched_size - twoWay->period;
+          } /* if */
+        } /* if */
       } /* if */
     } /* while */
     return NULL;
-  } /* rsearch_strelem2 */
+  } /* search_two_way */
 
 
 
@@ -164,7 +366,9 @@ void toLower (const strElemType *const source, memSizeType length,
     strElemType ch;
 
   /* toLower */
-    for (pos = 0; pos < length; pos++) {
+    /* A run of Latin-1 characters is converted at once. */
+    pos = lower_latin1_prefix_strelem(dest, source, length);
+    while (pos < length) {
       ch = source[pos];
       switch (ch >> 8) {
         case 0:
@@ -454,7 +658,12 @@ void toLower (const strElemType *const source, memSizeType length,
           break;
       } /* switch */
       dest[pos] = ch;
-    } /* for */
+      pos++;
+      if (length - pos >= 16 &&
+          (source[pos] | source[pos + 1] | source[pos + 2] | source[pos + 3]) <= 0xff) {
+        pos += lower_latin1_prefix_strelem(&dest[pos], &source[pos], length - pos);
+      } /* if */
+    } /* while */
   } /* toLower */
 
 
@@ -491,7 +700,9 @@ void toUpper (const strElemType *const source, memSizeType length,
     strElemType ch;
 
   /* toUpper */
-    for (pos = 0; pos < length; pos++) {
+    /* A run of Latin-1 characters is converted at once. */
+    pos = upper_latin1_prefix_strelem(dest, source, length);
+    while (pos < length) {
       ch = source[pos];
       switch (ch >> 8) {
         case 0:
@@ -779,7 +990,12 @@ void toUpper (const strElemType *const source, memSizeType length,
           break;
       } /* switch */
       dest[pos] = ch;
-    } /* for */
+      pos++;
+      if (length - pos >= 16 &&
+          (source[pos] | source[pos + 1] | source[pos + 2] | source[pos + 3]) <= 0xff) {
+        pos += upper_latin1_prefix_strelem(&dest[pos], &source[pos], length - pos);
+      } /* if */
+    } /* while */
   } /* toUpper */
 
 
@@ -797,9 +1013,9 @@ static rtlArrayType addCopiedStriToRtlArray (const strElemType *const stri_elems
       memcpy(new_stri->mem, stri_elems, length * sizeof(strElemType));
       if (used_max_position >= work_array->max_position) {
         if (unlikely(work_array->max_position > (intType) (MAX_RTL_ARR_INDEX / ARRAY_SIZE_FACTOR) ||
-            (resized_work_array = REALLOC_RTL_ARRAY(work_array,
+            (REALLOC_RTL_ARRAY(resized_work_array, work_array,
                 (uintType) work_array->max_position,
-                (uintType) work_array->max_position * ARRAY_SIZE_FACTOR)) == NULL)) {
+                (uintType) work_array->max_position * ARRAY_SIZE_FACTOR), resized_work_array == NULL))) {
           FREE_STRI(new_stri, new_stri->size);
           freeRtlStriArray(work_array, used_max_position);
           work_array = NULL;
@@ -830,7 +1046,7 @@ static inline rtlArrayType completeRtlStriArray (rtlArrayType work_array,
 
   /* completeRtlStriArray */
     if (likely(work_array != NULL)) {
-      resized_work_array = REALLOC_RTL_ARRAY(work_array,
+      REALLOC_RTL_ARRAY(resized_work_array, work_array,
           (uintType) work_array->max_position, (uintType) used_max_position);
       if (unlikely(resized_work_array == NULL)) {
         freeRtlStriArray(work_array, used_max_position);
@@ -2013,6 +2229,58 @@ intType strCompare (const const_striType stri1, const const_striType stri2)
 
 
 
+/**
+ *  Compare two strings without regard to case.
+ *  The result is the same as compare(lower(stri1), lower(stri2)),
+ *  but no lower case copies of the strings are created.
+ *  @return -1, 0 or 1 if the first argument is considered to be
+ *          respectively less than, equal to, or greater than the
+ *          second.
+ */
+intType strCompareIgnoreCase (const const_striType stri1,
+    const const_striType stri2)
+
+  {
+    strElemType buffer1[CASE_FOLD_BUFFER_SIZE];
+    strElemType buffer2[CASE_FOLD_BUFFER_SIZE];
+    memSizeType minSize;
+    memSizeType pos = 0;
+    memSizeType chunkSize;
+    int memcmpResult = 0;
+    intType signumValue;
+
+  /* strCompareIgnoreCase */
+    if (stri1->size < stri2->size) {
+      minSize = stri1->size;
+    } else {
+      minSize = stri2->size;
+    } /* if */
+    while (memcmpResult == 0 && pos < minSize) {
+      chunkSize = minSize - pos;
+      if (chunkSize > CASE_FOLD_BUFFER_SIZE) {
+        chunkSize = CASE_FOLD_BUFFER_SIZE;
+      } /* if */
+      toLower(&stri1->mem[pos], chunkSize, buffer1);
+      toLower(&stri2->mem[pos], chunkSize, buffer2);
+      memcmpResult = memcmp_strelem(buffer1, buffer2, chunkSize);
+      pos += chunkSize;
+    } /* while */
+    if (memcmpResult < 0) {
+      signumValue = -1;
+    } else if (memcmpResult > 0) {
+      signumValue = 1;
+    } else if (stri1->size < stri2->size) {
+      signumValue = -1;
+    } else if (stri1->size > stri2->size) {
+      signumValue = 1;
+    } else {
+      signumValue = 0;
+    } /* if */
+    return signumValue;
+  } /* strCompareIgnoreCase */
+
+
+
 /**
  *  Reinterpret the generic parameters as striType and call strCompare.
  *  Function pointers in C programs generated by the Seed7 compiler
@@ -2499,18 +2767,101 @@ boolType strGt (const const_striType stri1, const const_striType stri2)
 
 
 
+/**
+ *  Feed the characters 'mem' into the string hash value 'hash'.
+ *  On 64-bit systems two characters are processed in each step.
+ *  @return the updated hash value.
+ */
+static inline uintType hash_strelem (uintType hash, const strElemType *mem,
+    memSizeType len)
+
+  { /* hash_strelem */
+#if INTTYPE_SIZE == 64
+    for (; len >= 2; mem += 2, len -= 2) {
+      hash = STRI_HASH_STEP(hash, (uintType) mem[0] | (uintType) mem[1] << 32);
+    } /* for */
+    if (len != 0) {
+      hash = STRI_HASH_STEP(hash, (uintType) mem[0]);
+    } /* if */
+#else
+    for (; len > 0; mem++, len--) {
+      hash = STRI_HASH_STEP(hash, (uintType) *mem);
+    } /* for */
+#endif
+    return hash;
+  } /* hash_strelem */
+
+
+
+/**
+ *  Finish the computation of a string hash value.
+ *  @return the final hash value.
+ */
+static inline intType final_stri_hash (uintType hash)
+
+  { /* final_stri_hash */
+    /* Spread the upper bits, which are used by the multiplication, */
+    /* to the lower bits, which are used to select a hash bucket.   */
+    hash ^= hash >> (INTTYPE_SIZE / 2);
+    hash *= STRI_HASH_FINAL_MULTIPLIER;
+    hash ^= hash >> (INTTYPE_SIZE / 2 - 3);
+    return (intType) hash;
+  } /* final_stri_hash */
+
+
+
 /**
  *  Compute the hash value of a string.
+ *  All characters of the string contribute to the hash value.
+ *  On 64-bit systems two characters are processed in each step.
  *  @return the hash value.
  */
 intType strHashCode (const const_striType stri)
 
   { /* strHashCode */
-    return hashCode(stri);
+    return final_stri_hash(hash_strelem(
+        (uintType) STRI_HASH_SEED ^ (uintType) stri->size,
+        stri->mem, stri->size));
   } /* strHashCode */
 
 
 
+/**
+ *  Compute the hash value of a string without regard to case.
+ *  The result is the same as hashCode(lower(stri)), but no lower
+ *  case copy of the string is created.
+ *  @return the hash value.
+ */
+intType strHashCodeIgnoreCase (const const_striType stri)
+
+  {
+    strElemType buffer[CASE_FOLD_BUFFER_SIZE];
+    const strElemType *mem;
+    memSizeType len;
+    memSizeType chunkSize;
+    uintType hash;
+
+  /* strHashCodeIgnoreCase */
+    mem = stri->mem;
+    len = stri->size;
+    hash = (uintType) STRI_HASH_SEED ^ (uintType) len;
+    while (len > 0) {
+      /* The buffer size is even, so only the last chunk can */
+      /* contain an unpaired character (see hash_strelem).   */
+      chunkSize = len;
+      if (chunkSize > CASE_FOLD_BUFFER_SIZE) {
+        chunkSize = CASE_FOLD_BUFFER_SIZE;
+      } /* if */
+      toLower(mem, chunkSize, buffer);
+      hash = hash_strelem(hash, buffer, chunkSize);
+      mem += chunkSize;
+      len -= chunkSize;
+    } /* while */
+    return final_stri_hash(hash);
+  } /* strHashCodeIgnoreCase */
+
+
+
 #if ALLOW_STRITYPE_SLICES
 /**
  *  Get a substring ending at a stop position.
@@ -2674,7 +3025,7 @@ striType strHeadTemp (const striType stri, const intType stop)
  *  Search string 'searched' in 'mainStri' at or after 'fromIndex'.
  *  The search starts at 'fromIndex' and proceeds to the right.
  *  The first character in a string has the position 1.
- *  This function uses a modified Boyer–Moore string search algorithm.
+ *  This function uses the Two-Way string search algorithm.
  *  @return the position of 'searched' or 0 if 'mainStri'
  *          does not contain 'searched' at or after 'fromIndex'.
  */
@@ -2682,57 +3033,21 @@ static intType strIPos2 (const const_striType mainStri, const const_striType sea
     const intType fromIndex)
 
   {
-    memSizeType main_size;
-    memSizeType searched_size;
-    strElemType ch_n;
-    const strElemType *ch_n_pos;
-    memSizeType delta;
-    memSizeType charDelta[CHAR_DELTA_BEYOND + 1];
-    memSizeType pos;
+    twoWaySearchType twoWay;
     const strElemType *main_mem;
-    const strElemType *searched_mem;
-    const strElemType *search_start;
-    const strElemType *search_end;
+    const strElemType *found_pos;
 
   /* strIPos2 */
-    main_size = mainStri->size - ((memSizeType) fromIndex - 1);
-    searched_size = searched->size;
-    for (ch_n = 0; ch_n <= CHAR_DELTA_BEYOND; ch_n++) {
-      charDelta[ch_n] = searched_size;
-    } /* for */
-    searched_mem = searched->mem;
-    for (pos = 0; pos < searched_size - 1; pos++) {
-      ch_n = searched_mem[pos];
-      if (ch_n < CHAR_DELTA_BEYOND) {
-        charDelta[ch_n] = searched_size - pos - 1;
-      } else {
-        charDelta[CHAR_DELTA_BEYOND] = searched_size - pos - 1;
-      } /* if */
-    } /* for */
-    ch_n = searched_mem[searched_size - 1];
-    ch_n_pos = rsearch_strelem(&searched_mem[searched_size - 2], ch_n, searched_size - 1);
-    if (ch_n_pos == NULL) {
-      delta = searched_size;
+    init_two_way(&twoWay, searched->mem, searched->size, FALSE);
+    main_mem = &mainStri->mem[fromIndex - 1];
+    found_pos = search_two_way(&twoWay, main_mem,
+                               mainStri->size - ((memSizeType) fromIndex - 1),
+                               searched->mem, searched->size, FALSE);
+    if (found_pos != NULL) {
+      return ((intType) (found_pos - main_mem)) + fromIndex;
     } else {
-      delta = (memSizeType) (&searched_mem[searched_size - 1] - ch_n_pos);
+      return 0;
     } /* if */
-    main_mem = &mainStri->mem[fromIndex - 1];
-    search_start = &main_mem[searched_size - 1];
-    search_end = &main_mem[main_size];
-    while (search_start < search_end) {
-      search_start = search_strelem2(search_start, ch_n, search_end, charDelta);
-      if (search_start == NULL) {
-        return 0;
-      } else {
-        if (memcmp(search_start - searched_size + 1, searched_mem,
-            (searched_size - 1) * sizeof(strElemType)) == 0) {
-          return ((intType) (search_start - searched_size + 1 - main_mem)) + fromIndex;
-        } else {
-          search_start += delta;
-        } /* if */
-      } /* if */
-    } /* while */
-    return 0;
   } /* strIPos2 */
 
 
@@ -2741,7 +3056,8 @@ static intType strIPos2 (const const_striType mainStri, const const_striType sea
  *  Search string 'searched' in 'mainStri' at or after 'fromIndex'.
  *  The search starts at 'fromIndex' and proceeds to the right.
  *  The first character in a string has the position 1.
- *  This function calls strIPos2 if 'mainStri' is long.
+ *  This function uses memmem_strelem, or strIPos2 if 'searched' and
+ *  'mainStri' are long.
  *  @return the position of 'searched' or 0 if 'mainStri'
  *          does not contain 'searched' at or after 'fromIndex'.
  *  @exception RANGE_ERROR 'fromIndex' <= 0 holds.
@@ -2752,13 +3068,8 @@ intType strIPos (const const_striType mainStri, const const_striType searched,
   {
     memSizeType main_size;
     memSizeType searched_size;
-    strElemType ch_n;
-    const strElemType *ch_n_pos;
-    memSizeType delta;
     const strElemType *main_mem;
-    const strElemType *searched_mem;
-    const strElemType *search_start;
-    const strElemType *search_end;
+    const strElemType *found_pos;
 
   /* strIPos */
     logFunction(printf("strIPos(\"%s\", ",
@@ -2777,37 +3088,18 @@ intType strIPos (const const_striType mainStri, const const_striType searched,
       if (searched_size != 0 && main_size >= searched_size &&
           (uintType) fromIndex - 1 <= main_size - searched_size) {
         main_size -= (memSizeType) fromIndex - 1;
-        if (searched_size >= BOYER_MOORE_SEARCHED_STRI_THRESHOLD &&
-            main_size >= BOYER_MOORE_MAIN_STRI_THRESHOLD) {
+        if (searched_size >= TWO_WAY_FORWARD_SEARCHED_STRI_THRESHOLD &&
+            main_size >= TWO_WAY_MAIN_STRI_THRESHOLD) {
           return strIPos2(mainStri, searched, fromIndex);
         } else if (searched_size == 1) {
           return strChIPos(mainStri, searched->mem[0], fromIndex);
         } else {
-          searched_mem = searched->mem;
-          ch_n = searched_mem[searched_size - 1];
-          ch_n_pos = rsearch_strelem(&searched_mem[searched_size - 2], ch_n, searched_size - 1);
-          if (ch_n_pos == NULL) {
-            delta = searched_size;
-          } else {
-            delta = (memSizeType) (&searched_mem[searched_size - 1] - ch_n_pos);
-          } /* if */
           main_mem = &mainStri->mem[fromIndex - 1];
-          search_start = &main_mem[searched_size - 1];
-          search_end = &main_mem[main_size];
-          while (search_start < search_end) {
-            search_start = memchr_strelem(search_start, ch_n,
-                (memSizeType) (search_end - search_start));
-            if (search_start == NULL) {
-              return 0;
-            } else {
-              if (memcmp(search_start - searched_size + 1, searched_mem,
-                  (searched_size - 1) * sizeof(strElemType)) == 0) {
-                return ((intType) (search_start - searched_size + 1 - main_mem)) + fromIndex;
-              } else {
-                search_start += delta;
-              } /* if */
-            } /* if */
-          } /* while */
+          found_pos = memmem_strelem(main_mem, main_size,
+                                     searched->mem, searched_size);
+          if (found_pos != NULL) {
+            return ((intType) (found_pos - main_mem)) + fromIndex;
+          } /* if */
         } /* if */
       } /* if */
     } /* if */
@@ -3285,64 +3577,25 @@ striType strMult (const const_striType stri, const intType factor)
  *  Determine leftmost position of string 'searched' in 'mainStri'.
  *  If the string is found the position of its first character
  *  is the result. The first character in a string has the position 1.
- *  This function uses a modified Boyer–Moore string search algorithm.
+ *  This function uses the Two-Way string search algorithm.
  *  @return the position of 'searched' or 0 if 'mainStri'
  *          does not contain 'searched'.
  */
 static intType strPos2 (const const_striType mainStri, const const_striType searched)
 
   {
-    memSizeType main_size;
-    memSizeType searched_size;
-    strElemType ch_n;
-    const strElemType *ch_n_pos;
-    memSizeType delta;
-    memSizeType charDelta[CHAR_DELTA_BEYOND + 1];
-    memSizeType pos;
-    const strElemType *main_mem;
-    const strElemType *searched_mem;
-    const strElemType *search_start;
-    const strElemType *search_end;
+    twoWaySearchType twoWay;
+    const strElemType *found_pos;
 
   /* strPos2 */
-    main_size = mainStri->size;
-    searched_size = searched->size;
-    for (ch_n = 0; ch_n <= CHAR_DELTA_BEYOND; ch_n++) {
-      charDelta[ch_n] = searched_size;
-    } /* for */
-    searched_mem = searched->mem;
-    for (pos = 0; pos < searched_size - 1; pos++) {
-      ch_n = searched_mem[pos];
-      if (ch_n < CHAR_DELTA_BEYOND) {
-        charDelta[ch_n] = searched_size - pos - 1;
-      } else {
-        charDelta[CHAR_DELTA_BEYOND] = searched_size - pos - 1;
-      } /* if */
-    } /* for */
-    ch_n = searched_mem[searched_size - 1];
-    ch_n_pos = rsearch_strelem(&searched_mem[searched_size - 2], ch_n, searched_size - 1);
-    if (ch_n_pos == NULL) {
-      delta = searched_size;
+    init_two_way(&twoWay, searched->mem, searched->size, FALSE);
+    found_pos = search_two_way(&twoWay, mainStri->mem, mainStri->size,
+                               searched->mem, searched->size, FALSE);
+    if (found_pos != NULL) {
+      return ((intType) (found_pos - mainStri->mem)) + 1;
     } else {
-      delta = (memSizeType) (&searched_mem[searched_size - 1] - ch_n_pos);
+      return 0;
     } /* if */
-    main_mem = mainStri->mem;
-    search_start = &main_mem[searched_size - 1];
-    search_end = &main_mem[main_size];
-    while (search_start < search_end) {
-      search_start = search_strelem2(search_start, ch_n, search_end, charDelta);
-      if (search_start == NULL) {
-        return 0;
-      } else {
-        if (memcmp(search_start - searched_size + 1, searched_mem,
-            (searched_size - 1) * sizeof(strElemType)) == 0) {
-          return ((intType) (search_start - searched_size + 1 - main_mem)) + 1;
-        } else {
-          search_start += delta;
-        } /* if */
-      } /* if */
-    } /* while */
-    return 0;
   } /* strPos2 */
 
 
@@ -3351,7 +3604,8 @@ static intType strPos2 (const const_striType mainStri, const const_striType sear
  *  Determine leftmost position of string 'searched' in 'mainStri'.
  *  If the string is found the position of its first character
  *  is the result. The first character in a string has the position 1.
- *  This function calls strPos2 if 'mainStri' is long.
+ *  This function uses memmem_strelem, or strPos2 if 'searched' and
+ *  'mainStri' are long.
  *  @return the position of 'searched' or 0 if 'mainStri'
  *          does not contain 'searched'.
  */
@@ -3360,13 +3614,7 @@ intType strPos (const const_striType mainStri, const const_striType searched)
   {
     memSizeType main_size;
     memSizeType searched_size;
-    strElemType ch_n;
-    const strElemType *ch_n_pos;
-    memSizeType delta;
-    const strElemType *main_mem;
-    const strElemType *searched_mem;
-    const strElemType *search_start;
-    const strElemType *search_end;
+    const strElemType *found_pos;
 
   /* strPos */
     logFunction(printf("strPos(\"%s\", ",
@@ -3376,37 +3624,17 @@ intType strPos (const const_striType mainStri, const const_striType searched)
     main_size = mainStri->size;
     searched_size = searched->size;
     if (searched_size != 0 && main_size >= searched_size) {
-      if (searched_size >= BOYER_MOORE_SEARCHED_STRI_THRESHOLD &&
-          main_size >= BOYER_MOORE_MAIN_STRI_THRESHOLD) {
+      if (searched_size >= TWO_WAY_FORWARD_SEARCHED_STRI_THRESHOLD &&
+          main_size >= TWO_WAY_MAIN_STRI_THRESHOLD) {
         return strPos2(mainStri, searched);
       } else if (searched_size == 1) {
         return strChPos(mainStri, searched->mem[0]);
       } else {
-        searched_mem = searched->mem;
-        ch_n = searched_mem[searched_size - 1];
-        ch_n_pos = rsearch_strelem(&searched_mem[searched_size - 2], ch_n, searched_size - 1);
-        if (ch_n_pos == NULL) {
-          delta = searched_size;
-        } else {
-          delta = (memSizeType) (&searched_mem[searched_size - 1] - ch_n_pos);
+        found_pos = memmem_strelem(mainStri->mem, main_size,
+                                   searched->mem, searched_size);
+        if (found_pos != NULL) {
+          return ((intType) (found_pos - mainStri->mem)) + 1;
         } /* if */
-        main_mem = mainStri->mem;
-        search_start = &main_mem[searched_size - 1];
-        search_end = &main_mem[main_size];
-        while (search_start < search_end) {
-          search_start = memchr_strelem(search_start, ch_n,
-              (memSizeType) (search_end - search_start));
-          if (search_start == NULL) {
-            return 0;
-          } else {
-            if (memcmp(search_start - searched_size + 1, searched_mem,
-                (searched_size - 1) * sizeof(strElemType)) == 0) {
-              return ((intType) (search_start - searched_size + 1 - main_mem)) + 1;
-            } else {
-              search_start += delta;
-            } /* if */
-          } /* if */
-        } /* while */
       } /* if */
     } /* if */
     return 0;
@@ -3631,86 +3859,52 @@ intType strRChPos (const const_striType mainStri, const charType searched)
 
 /**
  *  Replace all occurrences of 'searched' in 'mainStri' by 'replacement'.
- *  This function uses a modified Boyer–Moore string search algorithm.
+ *  This function uses the Two-Way string search algorithm.
  *  @return the result of the replacement.
  */
 static memSizeType strRepl2 (const const_striType mainStri, const const_striType searched,
     const const_striType replacement, const striType result)
 
   {
-    memSizeType main_size;
+    twoWaySearchType twoWay;
     memSizeType searched_size;
-    strElemType ch_n;
-    const strElemType *ch_n_pos;
-    memSizeType delta;
-    memSizeType charDelta[CHAR_DELTA_BEYOND + 1];
-    memSizeType pos;
-    const strElemType *main_mem;
-    const strElemType *searched_mem;
     const strElemType *search_start;
     const strElemType *search_end;
     const strElemType *copy_start;
     strElemType *result_end;
-    memSizeType result_size;
 
   /* strRepl2 */
-    main_size = mainStri->size;
     searched_size = searched->size;
-    for (ch_n = 0; ch_n <= CHAR_DELTA_BEYOND; ch_n++) {
-      charDelta[ch_n] = searched_size;
-    } /* for */
-    searched_mem = searched->mem;
-    for (pos = 0; pos < searched_size - 1; pos++) {
-      ch_n = searched_mem[pos];
-      if (ch_n < CHAR_DELTA_BEYOND) {
-        charDelta[ch_n] = searched_size - pos - 1;
-      } else {
-        charDelta[CHAR_DELTA_BEYOND] = searched_size - pos - 1;
-      } /* if */
-    } /* for */
-    ch_n = searched_mem[searched_size - 1];
-    ch_n_pos = rsearch_strelem(&searched_mem[searched_size - 2], ch_n, searched_size - 1);
-    if (ch_n_pos == NULL) {
-      delta = searched_size;
-    } else {
-      delta = (memSizeType) (&searched_mem[searched_size - 1] - ch_n_pos);
-    } /* if */
-    main_mem = mainStri->mem;
-    search_start = &main_mem[searched_size - 1];
-    search_end = &main_mem[main_size];
+    init_two_way(&twoWay, searched->mem, searched_size, FALSE);
+    search_start = mainStri->mem;
+    search_end = &mainStri->mem[mainStri->size];
     copy_start = mainStri->mem;
     result_end = result->mem;
-    while (search_start != NULL && search_start < search_end) {
-      search_start = search_strelem2(search_start, ch_n, search_end, charDelta);
-      if (search_start != NULL) {
-        if (memcmp(search_start - searched_size + 1, searched_mem,
-            (searched_size - 1) * sizeof(strElemType)) == 0) {
-          memcpy(result_end, copy_start,
-                 (memSizeType) (search_start - searched_size + 1 - copy_start) *
-                 sizeof(strElemType));
-          result_end += search_start - searched_size + 1 - copy_start;
-          memcpy(result_end, replacement->mem,
-                 replacement->size * sizeof(strElemType));
-          result_end += replacement->size;
-          copy_start = search_start + 1;
-          search_start += searched_size;
-        } else {
-          search_start += delta;
-        } /* if */
-      } /* if */
+    while ((memSizeType) (search_end - search_start) >= searched_size &&
+        (search_start = search_two_way(&twoWay, search_start,
+            (memSizeType) (search_end - search_start),
+            searched->mem, searched_size, FALSE)) != NULL) {
+      memcpy(result_end, copy_start,
+             (memSizeType) (search_start - copy_start) * sizeof(strElemType));
+      result_end += search_start - copy_start;
+      memcpy(result_end, replacement->mem,
+             replacement->size * sizeof(strElemType));
+      result_end += replacement->size;
+      search_start += searched_size;
+      copy_start = search_start;
     } /* while */
     memcpy(result_end, copy_start,
-           (memSizeType) (&mainStri->mem[main_size] - copy_start) * sizeof(strElemType));
-    result_end += &mainStri->mem[main_size] - copy_start;
-    result_size = (memSizeType) (result_end - result->mem);
-    return result_size;
+           (memSizeType) (search_end - copy_start) * sizeof(strElemType));
+    result_end += search_end - copy_start;
+    return (memSizeType) (result_end - result->mem);
   } /* strRepl2 */
 
 
 
 /**
  *  Replace all occurrences of 'searched' in 'mainStri' by 'replacement'.
- *  This function calls strRepl2 if 'mainStri' is long.
+ *  This function uses memmem_strelem, or strRepl2 if 'searched' and
+ *  'mainStri' are long.
  *  @return the result of the replacement.
  */
 striType strRepl (const const_striType mainStri,
@@ -3750,34 +3944,46 @@ striType strRepl (const const_striType mainStri,
     if (unlikely(!ALLOC_STRI_SIZE_OK(result, guessed_result_size))) {
       raise_error(MEMORY_ERROR);
     } else {
-      if (searched_size >= BOYER_MOORE_SEARCHED_STRI_THRESHOLD &&
-          main_size >= BOYER_MOORE_MAIN_STRI_THRESHOLD) {
+      if (searched_size >= TWO_WAY_FORWARD_SEARCHED_STRI_THRESHOLD &&
+          main_size >= TWO_WAY_MAIN_STRI_THRESHOLD) {
         result_size = strRepl2(mainStri, searched, replacement, result);
       } else {
         copy_start = mainStri->mem;
         result_end = result->mem;
-        if (searched_size != 0 && searched_size <= main_size) {
-          searched_mem = searched->mem;
-          ch_1 = searched_mem[0];
+        if (searched_size == 1) {
+          ch_1 = searched->mem[0];
           main_mem = mainStri->mem;
           search_start = main_mem;
-          search_end = &main_mem[main_size - searched_size + 1];
+          search_end = &main_mem[main_size];
           while (search_start < search_end &&
               (search_start = memchr_strelem(search_start, ch_1,
                   (memSizeType) (search_end - search_start))) != NULL) {
-            if (memcmp(search_start, searched_mem,
-                searched_size * sizeof(strElemType)) == 0) {
-              memcpy(result_end, copy_start,
-                     (memSizeType) (search_start - copy_start) * sizeof(strElemType));
-              result_end += search_start - copy_start;
-              memcpy(result_end, replacement->mem,
-                     replacement->size * sizeof(strElemType));
-              result_end += replacement->size;
-              search_start += searched_size;
-              copy_start = search_start;
-            } else {
-              search_start++;
-            } /* if */
+            memcpy(result_end, copy_start,
+                   (memSizeType) (search_start - copy_start) * sizeof(strElemType));
+            result_end += search_start - copy_start;
+            memcpy(result_end, replacement->mem,
+                   replacement->size * sizeof(strElemType));
+            result_end += replacement->size;
+            search_start++;
+            copy_start = search_start;
+          } /* while */
+        } else if (searched_size != 0 && searched_size <= main_size) {
+          searched_mem = searched->mem;
+          main_mem = mainStri->mem;
+          search_start = main_mem;
+          search_end = &main_mem[main_size];
+          while ((memSizeType) (search_end - search_start) >= searched_size &&
+              (search_start = memmem_strelem(search_start,
+                  (memSizeType) (search_end - search_start),
+                  searched_mem, searched_size)) != NULL) {
+            memcpy(result_end, copy_start,
+                   (memSizeType) (search_start - copy_start) * sizeof(strElemType));
+            result_end += search_start - copy_start;
+            memcpy(result_end, replacement->mem,
+                   replacement->size * sizeof(strElemType));
+            result_end += replacement->size;
+            search_start += searched_size;
+            copy_start = search_start;
           } /* while */
         } /* if */
         memcpy(result_end, copy_start,
@@ -3807,7 +4013,7 @@ striType strRepl (const const_striType mainStri,
  *  Search string 'searched' in 'mainStri' at or before 'fromIndex'.
  *  The search starts at 'fromIndex' and proceeds to the left.
  *  The first character in a string has the position 1.
- *  This function uses a modified Boyer–Moore string search algorithm.
+ *  This function uses the Two-Way string search algorithm.
  *  @return the position of 'searched' or 0 if 'mainStri'
  *          does not contain 'searched' at or before 'fromIndex'.
  */
@@ -3815,61 +4021,27 @@ static intType strRIPos2 (const const_striType mainStri, const const_striType se
     const intType fromIndex)
 
   {
-    memSizeType main_size;
+    twoWaySearchType twoWay;
     memSizeType searched_size;
-    strElemType ch_1;
-    const strElemType *ch_1_pos;
-    memSizeType delta;
-    memSizeType charDelta[CHAR_DELTA_BEYOND + 1];
-    memSizeType pos;
-    const strElemType *main_mem;
-    const strElemType *searched_mem;
-    const strElemType *search_start;
-    const strElemType *search_end;
+    memSizeType search_size;
+    const strElemType *found_pos;
 
   /* strRIPos2 */
-    main_size = mainStri->size;
     searched_size = searched->size;
-    for (ch_1 = 0; ch_1 <= CHAR_DELTA_BEYOND; ch_1++) {
-      charDelta[ch_1] = searched_size;
-    } /* for */
-    searched_mem = searched->mem;
-    for (pos = searched_size - 1; pos > 0; pos--) {
-      ch_1 = searched_mem[pos];
-      if (ch_1 < CHAR_DELTA_BEYOND) {
-        charDelta[ch_1] = pos;
-      } else {
-        charDelta[CHAR_DELTA_BEYOND] = pos;
-      } /* if */
-    } /* for */
-    ch_1 = searched_mem[0];
-    ch_1_pos = memchr_strelem(&searched_mem[1], ch_1, searched_size - 1);
-    if (ch_1_pos == NULL) {
-      delta = searched_size;
+    if ((uintType) fromIndex - 1 <= mainStri->size - searched_size) {
+      search_size = (memSizeType) fromIndex - 1 + searched_size;
     } else {
-      delta = (memSizeType) (ch_1_pos - &searched_mem[0]);
+      search_size = mainStri->size;
     } /* if */
-    main_mem = mainStri->mem;
-    if ((uintType) fromIndex - 1 <= main_size - searched_size) {
-      search_start = &main_mem[fromIndex - 1];
+    init_two_way(&twoWay, &searched->mem[searched_size - 1], searched_size, TRUE);
+    found_pos = search_two_way(&twoWay, &mainStri->mem[search_size - 1],
+                               search_size, &searched->mem[searched_size - 1],
+                               searched_size, TRUE);
+    if (found_pos != NULL) {
+      return ((intType) (found_pos - mainStri->mem)) + 1;
     } else {
-      search_start = &main_mem[main_size - searched_size];
+      return 0;
     } /* if */
-    search_end = &main_mem[-1];
-    while (search_start > search_end) {
-      search_start = rsearch_strelem2(search_start, ch_1, search_end, charDelta);
-      if (search_start == NULL) {
-        return 0;
-      } else {
-        if (memcmp(search_start + 1, &searched_mem[1],
-            (searched_size - 1) * sizeof(strElemType)) == 0) {
-          return ((intType) (search_start - main_mem)) + 1;
-        } else {
-          search_start -= delta;
-        } /* if */
-      } /* if */
-    } /* while */
-    return 0;
   } /* strRIPos2 */
 
 
@@ -3911,8 +4083,8 @@ intType strRIPos (const const_striType mainStri, const const_striType searched,
         main_size = mainStri->size;
         searched_size = searched->size;
         if (searched_size != 0 && main_size >= searched_size) {
-          if (searched_size >= BOYER_MOORE_SEARCHED_STRI_THRESHOLD &&
-              main_size >= BOYER_MOORE_MAIN_STRI_THRESHOLD) {
+          if (searched_size >= TWO_WAY_BACKWARD_SEARCHED_STRI_THRESHOLD &&
+              main_size >= TWO_WAY_MAIN_STRI_THRESHOLD) {
             return strRIPos2(mainStri, searched, fromIndex);
           } else {
             searched_mem = searched->mem;
@@ -3988,64 +4160,28 @@ striType strRpad (const const_striType stri, const intType padSize)
  *  Determine rightmost position of string 'searched' in 'mainStri'.
  *  If the string is found the position of its first character
  *  is the result. The first character in a string has the position 1.
- *  This function uses a modified Boyer–Moore string search algorithm.
+ *  This function uses the Two-Way string search algorithm.
  *  @return the position of 'searched' or 0 if 'mainStri'
  *          does not contain 'searched'.
  */
 static intType strRPos2 (const const_striType mainStri, const const_striType searched)
 
   {
-    memSizeType main_size;
+    twoWaySearchType twoWay;
     memSizeType searched_size;
-    strElemType ch_1;
-    const strElemType *ch_1_pos;
-    memSizeType delta;
-    memSizeType charDelta[CHAR_DELTA_BEYOND + 1];
-    memSizeType pos;
-    const strElemType *main_mem;
-    const strElemType *searched_mem;
-    const strElemType *search_start;
-    const strElemType *search_end;
+    const strElemType *found_pos;
 
   /* strRPos2 */
-    main_size = mainStri->size;
     searched_size = searched->size;
-    for (ch_1 = 0; ch_1 <= CHAR_DELTA_BEYOND; ch_1++) {
-      charDelta[ch_1] = searched_size;
-    } /* for */
-    searched_mem = searched->mem;
-    for (pos = searched_size - 1; pos > 0; pos--) {
-      ch_1 = searched_mem[pos];
-      if (ch_1 < CHAR_DELTA_BEYOND) {
-        charDelta[ch_1] = pos;
-      } else {
-        charDelta[CHAR_DELTA_BEYOND] = pos;
-      } /* if */
-    } /* for */
-    ch_1 = searched_mem[0];
-    ch_1_pos = memchr_strelem(&searched_mem[1], ch_1, searched_size - 1);
-    if (ch_1_pos == NULL) {
-      delta = searched_size;
+    init_two_way(&twoWay, &searched->mem[searched_size - 1], searched_size, TRUE);
+    found_pos = search_two_way(&twoWay, &mainStri->mem[mainStri->size - 1],
+                               mainStri->size, &searched->mem[searched_size - 1],
+                               searched_size, TRUE);
+    if (found_pos != NULL) {
+      return ((intType) (found_pos - mainStri->mem)) + 1;
     } else {
-      delta = (memSizeType) (ch_1_pos - &searched_mem[0]);
+      return 0;
     } /* if */
-    main_mem = mainStri->mem;
-    search_start = &main_mem[main_size - searched_size];
-    search_end = &main_mem[-1];
-    while (search_start > search_end) {
-      search_start = rsearch_strelem2(search_start, ch_1, search_end, charDelta);
-      if (search_start == NULL) {
-        return 0;
-      } else {
-        if (memcmp(search_start + 1, &searched_mem[1],
-            (searched_size - 1) * sizeof(strElemType)) == 0) {
-          return ((intType) (search_start - main_mem)) + 1;
-        } else {
-          search_start -= delta;
-        } /* if */
-      } /* if */
-    } /* while */
-    return 0;
   } /* strRPos2 */
 
 
@@ -4077,8 +4213,8 @@ intType strRPos (const const_striType mainStri, const const_striType searched)
     main_size = mainStri->size;
     searched_size = searched->size;
     if (searched_size != 0 && searched_size <= main_size) {
-      if (searched_size >= BOYER_MOORE_SEARCHED_STRI_THRESHOLD &&
-          main_size >= BOYER_MOORE_MAIN_STRI_THRESHOLD) {
+      if (searched_size >= TWO_WAY_BACKWARD_SEARCHED_STRI_THRESHOLD &&
+          main_size >= TWO_WAY_MAIN_STRI_THRESHOLD) {
         return strRPos2(mainStri, searched);
       } else {
         searched_mem = searched->mem;
@@ -4154,10 +4290,8 @@ rtlArrayType strSplit (const const_striType mainStri,
   {
     memSizeType delimiter_size;
     const strElemType *delimiter_mem;
-    strElemType ch_1;
     intType used_max_position;
     const strElemType *search_start;
-    const strElemType *segment_start;
     const strElemType *search_end;
     const strElemType *found_pos;
     rtlArrayType result_array;
@@ -4173,32 +4307,26 @@ rtlArrayType strSplit (const const_striType mainStri,
       delimiter_size = delimiter->size;
       delimiter_mem = delimiter->mem;
       search_start = mainStri->mem;
-      segment_start = search_start;
-      if (delimiter_size != 0 && mainStri->size >= delimiter_size) {
-        ch_1 = delimiter_mem[0];
-        search_end = &mainStri->mem[mainStri->size - delimiter_size + 1];
-        while ((found_pos = memchr_strelem(search_start, ch_1,
-            (memSizeType) (search_end - search_start))) != NULL &&
+      search_end = &mainStri->mem[mainStri->size];
+      if (delimiter_size != 0) {
+        while ((memSizeType) (search_end - search_start) >= delimiter_size &&
+            (found_pos = delimiter_size == 1 ?
+                memchr_strelem(search_start, delimiter_mem[0],
+                               (memSizeType) (search_end - search_start)) :
+                memmem_strelem(search_start,
+                               (memSizeType) (search_end - search_start),
+                               delimiter_mem, delimiter_size)) != NULL &&
             result_array != NULL) {
-          if (memcmp(found_pos, delimiter_mem,
-              delimiter_size * sizeof(strElemType)) == 0) {
-            result_array = addCopiedStriToRtlArray(segment_start,
-                (memSizeType) (found_pos - segment_start), result_array,
-                used_max_position);
-            used_max_position++;
-            search_start = found_pos + delimiter_size;
-            segment_start = search_start;
-            if (search_start > search_end) {
-              search_start = search_end;
-            } /* if */
-          } else {
-            search_start = found_pos + 1;
-          } /* if */
+          result_array = addCopiedStriToRtlArray(search_start,
+              (memSizeType) (found_pos - search_start), result_array,
+              used_max_position);
+          used_max_position++;
+          search_start = found_pos + delimiter_size;
         } /* while */
       } /* if */
       if (likely(result_array != NULL)) {
-        result_array = addCopiedStriToRtlArray(segment_start,
-            (memSizeType) (&mainStri->mem[mainStri->size] - segment_start), result_array,
+        result_array = addCopiedStriToRtlArray(search_start,
+            (memSizeType) (search_end - search_start), result_array,
             used_max_position);
         used_max_position++;
         result_array = completeRtlStriArray(result_array, used_max_position);
@@ -4469,63 +4597,60 @@ striType strToUtf8 (const const_striType stri)
     register strElemType *dest;
     register strElemType ch;
     register memSizeType pos;
+    memSizeType converted;
     memSizeType result_size;
-    striType resized_result;
     striType result;
 
   /* strToUtf8 */
-    if (unlikely(stri->size > MAX_STRI_LEN / MAX_UTF8_EXPANSION_FACTOR ||
-                 !ALLOC_STRI_SIZE_OK(result, max_utf8_size(stri->size)))) {
+    if (unlikely(stri->size > MAX_STRI_LEN / MAX_UTF8_EXPANSION_FACTOR)) {
       raise_error(MEMORY_ERROR);
       result = NULL;
     } else {
-      dest = result->mem;
-      for (pos = 0; pos < stri->size; pos++) {
-        ch = stri->mem[pos];
-        if (ch <= 0x7F) {
-          *dest++ = ch;
-        } else if (ch <= 0x7FF) {
-          dest[0] = 0xC0 | ( ch >>  6);
-          dest[1] = 0x80 | ( ch        & 0x3F);
-          dest += 2;
-        } else if (ch <= 0xFFFF) {
-          dest[0] = 0xE0 | ( ch >> 12);
-          dest[1] = 0x80 | ((ch >>  6) & 0x3F);
-          dest[2] = 0x80 | ( ch        & 0x3F);
-          dest += 3;
-        } else if (ch <= 0x1FFFFF) {
-          dest[0] = 0xF0 | ( ch >> 18);
-          dest[1] = 0x80 | ((ch >> 12) & 0x3F);
-          dest[2] = 0x80 | ((ch >>  6) & 0x3F);
-          dest[3] = 0x80 | ( ch        & 0x3F);
-          dest += 4;
-        } else if (ch <= 0x3FFFFFF) {
-          dest[0] = 0xF8 | ( ch >> 24);
-          dest[1] = 0x80 | ((ch >> 18) & 0x3F);
-          dest[2] = 0x80 | ((ch >> 12) & 0x3F);
-          dest[3] = 0x80 | ((ch >>  6) & 0x3F);
-          dest[4] = 0x80 | ( ch        & 0x3F);
-          dest += 5;
-        } else {
-          dest[0] = 0xFC | ( ch >> 30);
-          dest[1] = 0x80 | ((ch >> 24) & 0x3F);
-          dest[2] = 0x80 | ((ch >> 18) & 0x3F);
-          dest[3] = 0x80 | ((ch >> 12) & 0x3F);
-          dest[4] = 0x80 | ((ch >>  6) & 0x3F);
-          dest[5] = 0x80 | ( ch        & 0x3F);
-          dest += 6;
-        } /* if */
-      } /* for */
-      result_size = (memSizeType) (dest - result->mem);
-      REALLOC_STRI_SIZE_SMALLER(resized_result, result, max_utf8_size(stri->size), result_size);
-      if (unlikely(resized_result == NULL)) {
-        FREE_STRI(result, max_utf8_size(stri->size));
+      result_size = utf8_size_of_strelem(stri->mem, stri->size);
+      if (unlikely(!ALLOC_STRI_SIZE_OK(result, result_size))) {
         raise_error(MEMORY_ERROR);
-        result = NULL;
       } else {
-        result = resized_result;
-        COUNT3_STRI(max_utf8_size(stri->size), result_size);
         result->size = result_size;
+        dest = result->mem;
+        for (pos = 0; pos < stri->size; pos++) {
+          ch = stri->mem[pos];
+          if (ch <= 0x7F) {
+            converted = copy_ascii_prefix_strelem(dest, &stri->mem[pos],
+                                                  stri->size - pos);
+            dest += converted;
+            pos += converted - 1;
+          } else if (ch <= 0x7FF) {
+            dest[0] = 0xC0 | ( ch >>  6);
+            dest[1] = 0x80 | ( ch        & 0x3F);
+            dest += 2;
+          } else if (ch <= 0xFFFF) {
+            dest[0] = 0xE0 | ( ch >> 12);
+            dest[1] = 0x80 | ((ch >>  6) & 0x3F);
+            dest[2] = 0x80 | ( ch        & 0x3F);
+            dest += 3;
+          } else if (ch <= 0x1FFFFF) {
+            dest[0] = 0xF0 | ( ch >> 18);
+            dest[1] = 0x80 | ((ch >> 12) & 0x3F);
+            dest[2] = 0x80 | ((ch >>  6) & 0x3F);
+            dest[3] = 0x80 | ( ch        & 0x3F);
+            dest += 4;
+          } else if (ch <= 0x3FFFFFF) {
+            dest[0] = 0xF8 | ( ch >> 24);
+            dest[1] = 0x80 | ((ch >> 18) & 0x3F);
+            dest[2] = 0x80 | ((ch >> 12) & 0x3F);
+            dest[3] = 0x80 | ((ch >>  6) & 0x3F);
+            dest[4] = 0x80 | ( ch        & 0x3F);
+            dest += 5;
+          } else {
+            dest[0] = 0xFC | ( ch >> 30);
+            dest[1] = 0x80 | ((ch >> 24) & 0x3F);
+            dest[2] = 0x80 | ((ch >> 18) & 0x3F);
+            dest[3] = 0x80 | ((ch >> 12) & 0x3F);
+            dest[4] = 0x80 | ((ch >>  6) & 0x3F);
+            dest[5] = 0x80 | ( ch        & 0x3F);
+            dest += 6;
+          } /* if */
+        } /* for */
       } /* if */
     } /* if */
     return result;
@@ -4636,6 +4761,7 @@ striType strUtf8ToStri (const const_striType utf8)
     memSizeType utf8Size;
     memSizeType pos;
     const strElemType *utf8ptr;
+    memSizeType converted;
     boolType okay = TRUE;
     striType resized_result;
     striType result;
@@ -4651,7 +4777,10 @@ striType strUtf8ToStri (const const_striType utf8)
       pos = 0;
       for (; utf8Size > 0; pos++, utf8Size--) {
         if (*utf8ptr <= 0x7F) {
-          result->mem[pos] = *utf8ptr++;
+          converted = copy_ascii_prefix_strelem(&result->mem[pos], utf8ptr, utf8Size);
+          utf8ptr += converted;
+          pos += converted - 1;
+          utf8Size -= converted - 1;
         } else if (utf8ptr[0] >= 0xC0 && utf8ptr[0] <= 0xDF && utf8Size >= 2 &&
                    utf8ptr[1] >= 0x80 && utf8ptr[1] <= 0xBF) {
           /* utf8ptr[0]   range 192 to 223 (leading bits 110.....) */
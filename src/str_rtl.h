@@ -29,18 +29,6 @@
 /*                                                                  */
 /********************************************************************/
 
-/**
- *  Macro to compute the hashcode of a string.
- *  A corresponding macro is inlined by the compiler. If this macro
- *  is changed the code in the compiler must be changed as well.
- */
-#define hashCode(stri) (intType) ((stri)->size == 0 ? 0 : \
-                                     ((stri)->mem[0] << 5 ^ \
-                                      (stri)->mem[(stri)->size >> 1] << 3 ^ \
-                                      (stri)->mem[(stri)->size - 1] << 1 ^ \
-                                      (stri)->size))
-
-
 void toLower (const strElemType *const stri, memSizeType length,
     strElemType *const dest);
 void toUpper (const strElemType *const stri, memSizeType length,
@@ -64,6 +52,8 @@ striType strChRepl (const const_striType mainStri,
     const charType delimiter); */
 striType strCLit (const const_striType stri);
 intType strCompare (const const_striType stri1, const const_striType stri2);
+intType strCompareIgnoreCase (const const_striType stri1,
+                              const const_striType stri2);
 striType strConcat (const const_striType stri1, const const_striType stri2);
 striType strConcatChar (const const_striType stri1, const charType aChar);
 striType strConcatCharTemp (striType stri1, const charType aChar);
@@ -76,6 +66,7 @@ striType strEmpty (void);
 boolType strGe (const const_striType stri1, const const_striType stri2);
 boolType strGt (const const_striType stri1, const const_striType stri2);
 intType strHashCode (const const_striType stri);
+intType strHashCodeIgnoreCase (const const_striType stri);
 #if ALLOW_STRITYPE_SLICES
 void strHeadSlice (const const_striType stri, const intType stop, striType slice);
 #endif
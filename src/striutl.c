@@ -38,9 +38,14 @@
 #include "stdio.h"
 #include "string.h"
 #include "ctype.h"
-#ifdef OS_STRI_WCHAR
+#if defined OS_STRI_WCHAR || HAS_WMEMCHR
 #include "wchar.h"
 #endif
+#if HAS_AVX2_TARGET_ATTRIBUTE
+#include "immintrin.h"
+#elif HAS_SSE2_INTRINSICS
+#include "emmintrin.h"
+#endif
 
 #include "common.h"
 #include "heaputl.h"
@@ -649,6 +654,257 @@ const strElemType *memchr_strelem (register const strElemType *mem,
 
 
 
+#if HAS_SSE2_INTRINSICS || HAS_AVX2_TARGET_ATTRIBUTE
+/**
+ *  Check the candidates of a vectorized substring search.
+ *  The bits of 'mask' correspond to the positions mem[0] .. mem[31]
+ *  where the first and the last character of 'searched' match.
+ *  @return a pointer to the first candidate, where the characters
+ *          in between match also, or NULL if there is none.
+ */
+static inline const strElemType *check_candidates_strelem (
+    const strElemType *mem, unsigned int mask,
+    const strElemType *searched, memSizeType searched_len)
+
+  { /* check_candidates_strelem */
+    while (mask != 0) {
+      mem += __builtin_ctz(mask);
+      if (memcmp(&mem[1], &searched[1],
+          (searched_len - 2) * sizeof(strElemType)) == 0) {
+        return mem;
+      } /* if */
+      mem++;
+      mask >>= __builtin_ctz(mask);
+      mask >>= 1;
+    } /* while */
+    return NULL;
+  } /* check_candidates_strelem */
+
+#endif
+
+
+
+/**
+ *  Scalar search for the remaining positions of a substring search.
+ *  Candidates are found with memchr_strelem and filtered by the
+ *  last character of 'searched', before the rest is compared.
+ *  @param num_positions Number of positions in 'mem', where an
+ *         occurrence of 'searched' could start.
+ */
+static const strElemType *search_strelem_scalar (const strElemType *mem,
+    memSizeType num_positions, const strElemType *searched,
+    memSizeType searched_len)
+
+  {
+    const strElemType ch_1 = searched[0];
+    const strElemType ch_n = searched[searched_len - 1];
+    const strElemType *const beyond = &mem[num_positions];
+
+  /* search_strelem_scalar */
+    while (mem < beyond &&
+        (mem = memchr_strelem(mem, ch_1,
+                              (memSizeType) (beyond - mem))) != NULL) {
+      if (mem[searched_len - 1] == ch_n &&
+          memcmp(&mem[1], &searched[1],
+                 (searched_len - 2) * sizeof(strElemType)) == 0) {
+        return mem;
+      } /* if */
+      mem++;
+    } /* while */
+    return NULL;
+  } /* search_strelem_scalar */
+
+
+
+#if HAS_SSE2_INTRINSICS
+/**
+ *  Compare the first and the last character of 'searched' at 4
+ *  positions of 'mem' at once.
+ *  @return a vector where the elements of matching positions are -1.
+ */
+#define MATCH_FIRST_AND_LAST_SSE2(mem, searched_len, ch_1, ch_n) \
+    _mm_and_si128( \
+        _mm_cmpeq_epi32((ch_1), _mm_loadu_si128((const __m128i *) (mem))), \
+        _mm_cmpeq_epi32((ch_n), _mm_loadu_si128((const __m128i *) \
+                                                &(mem)[(searched_len) - 1])))
+#define MASK_SSE2(vector) \
+    ((unsigned int) _mm_movemask_ps(_mm_castsi128_ps(vector)))
+
+/**
+ *  Substring search, which compares 16 positions at once with SSE2.
+ *  For every position the first and the last character of 'searched'
+ *  are compared. Only for positions where both match the characters
+ *  in between are compared.
+ */
+static const strElemType *search_strelem_sse2 (const strElemType *mem,
+    memSizeType num_positions, const strElemType *searched,
+    memSizeType searched_len)
+
+  {
+    const __m128i ch_1 = _mm_set1_epi32((int) searched[0]);
+    const __m128i ch_n = _mm_set1_epi32((int) searched[searched_len - 1]);
+    __m128i match0;
+    __m128i match1;
+    __m128i match2;
+    __m128i match3;
+    unsigned int mask;
+    const strElemType *found;
+
+  /* search_strelem_sse2 */
+    for (; num_positions >= 16; mem += 16, num_positions -= 16) {
+      match0 = MATCH_FIRST_AND_LAST_SSE2(mem,      searched_len, ch_1, ch_n);
+      match1 = MATCH_FIRST_AND_LAST_SSE2(&mem[4],  searched_len, ch_1, ch_n);
+      match2 = MATCH_FIRST_AND_LAST_SSE2(&mem[8],  searched_len, ch_1, ch_n);
+      match3 = MATCH_FIRST_AND_LAST_SSE2(&mem[12], searched_len, ch_1, ch_n);
+      if (unlikely(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(match0, match1),
+                                                  _mm_or_si128(match2, match3))) != 0)) {
+        mask = MASK_SSE2(match0)       | MASK_SSE2(match1) << 4 |
+               MASK_SSE2(match2) << 8  | MASK_SSE2(match3) << 12;
+        if ((found = check_candidates_strelem(mem, mask,
+            searched, searched_len)) != NULL) {
+          return found;
+        } /* if */
+      } /* if */
+    } /* for */
+    for (; num_positions >= 4; mem += 4, num_positions -= 4) {
+      mask = MASK_SSE2(MATCH_FIRST_AND_LAST_SSE2(mem, searched_len, ch_1, ch_n));
+      if (mask != 0 && (found = check_candidates_strelem(mem, mask,
+          searched, searched_len)) != NULL) {
+        return found;
+      } /* if */
+    } /* for */
+    return search_strelem_scalar(mem, num_positions, searched, searched_len);
+  } /* search_strelem_sse2 */
+
+#endif
+
+
+
+#if HAS_AVX2_TARGET_ATTRIBUTE
+#define MATCH_FIRST_AND_LAST_AVX2(mem, searched_len, ch_1, ch_n) \
+    _mm256_and_si256( \
+        _mm256_cmpeq_epi32((ch_1), _mm256_loadu_si256((const __m256i *) (mem))), \
+        _mm256_cmpeq_epi32((ch_n), _mm256_loadu_si256((const __m256i *) \
+                                                      &(mem)[(searched_len) - 1])))
+#define MASK_AVX2(vector) \
+    ((unsigned int) _mm256_movemask_ps(_mm256_castsi256_ps(vector)))
+
+/**
+ *  Substring search, which compares 32 positions at once with AVX2.
+ *  This function is only called if the CPU supports AVX2.
+ */
+__attribute__((target("avx2")))
+static const strElemType *search_strelem_avx2 (const strElemType *mem,
+    memSizeType num_positions, const strElemType *searched,
+    memSizeType searched_len)
+
+  {
+    const __m256i ch_1 = _mm256_set1_epi32((int) searched[0]);
+    const __m256i ch_n = _mm256_set1_epi32((int) searched[searched_len - 1]);
+    __m256i match0;
+    __m256i match1;
+    __m256i match2;
+    __m256i match3;
+    __m256i any_match;
+    unsigned int mask;
+    const strElemType *found;
+
+  /* search_strelem_avx2 */
+    for (; num_positions >= 32; mem += 32, num_positions -= 32) {
+      match0 = MATCH_FIRST_AND_LAST_AVX2(mem,      searched_len, ch_1, ch_n);
+      match1 = MATCH_FIRST_AND_LAST_AVX2(&mem[8],  searched_len, ch_1, ch_n);
+      match2 = MATCH_FIRST_AND_LAST_AVX2(&mem[16], searched_len, ch_1, ch_n);
+      match3 = MATCH_FIRST_AND_LAST_AVX2(&mem[24], searched_len, ch_1, ch_n);
+      any_match = _mm256_or_si256(_mm256_or_si256(match0, match1),
+                                  _mm256_or_si256(match2, match3));
+      if (unlikely(!_mm256_testz_si256(any_match, any_match))) {
+        mask = MASK_AVX2(match0)       | MASK_AVX2(match1) << 8 |
+               MASK_AVX2(match2) << 16 | MASK_AVX2(match3) << 24;
+        if ((found = check_candidates_strelem(mem, mask,
+            searched, searched_len)) != NULL) {
+          return found;
+        } /* if */
+      } /* if */
+    } /* for */
+    for (; num_positions >= 8; mem += 8, num_positions -= 8) {
+      mask = MASK_AVX2(MATCH_FIRST_AND_LAST_AVX2(mem, searched_len, ch_1, ch_n));
+      if (mask != 0 && (found = check_candidates_strelem(mem, mask,
+          searched, searched_len)) != NULL) {
+        return found;
+      } /* if */
+    } /* for */
+    return search_strelem_scalar(mem, num_positions, searched, searched_len);
+  } /* search_strelem_avx2 */
+
+
+
+static const strElemType *search_strelem_select (const strElemType *mem,
+    memSizeType num_positions, const strElemType *searched,
+    memSizeType searched_len);
+
+static const strElemType *(*search_strelem_kernel) (const strElemType *mem,
+    memSizeType num_positions, const strElemType *searched,
+    memSizeType searched_len) = search_strelem_select;
+
+
+
+/**
+ *  Select the substring search kernel with the features of the CPU.
+ *  The selection is done at the first call of memmem_strelem.
+ */
+static const strElemType *search_strelem_select (const strElemType *mem,
+    memSizeType num_positions, const strElemType *searched,
+    memSizeType searched_len)
+
+  { /* search_strelem_select */
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      search_strelem_kernel = search_strelem_avx2;
+    } else {
+#if HAS_SSE2_INTRINSICS
+      search_strelem_kernel = search_strelem_sse2;
+#else
+      search_strelem_kernel = search_strelem_scalar;
+#endif
+    } /* if */
+    return search_strelem_kernel(mem, num_positions, searched, searched_len);
+  } /* search_strelem_select */
+
+#endif
+
+
+
+/**
+ *  Search the first occurrence of 'searched' in the first len Seed7
+ *  characters of 'mem'. If the CPU supports it, the search uses a
+ *  vectorized kernel (AVX2 or SSE2), which checks the first and the
+ *  last character of 'searched' at several positions at once.
+ *  @param mem Array with UTF-32 characters.
+ *  @param len Number of UTF-32 characters in 'mem'.
+ *  @param searched Array with the UTF-32 characters to be searched.
+ *  @param searched_len Number of UTF-32 characters in 'searched'.
+ *         The caller must assure that 2 <= searched_len <= len holds.
+ *  @return a pointer to the first character of the match, or NULL if
+ *          'searched' does not occur in the given string area.
+ */
+const strElemType *memmem_strelem (const strElemType *mem, memSizeType len,
+    const strElemType *searched, memSizeType searched_len)
+
+  { /* memmem_strelem */
+#if HAS_AVX2_TARGET_ATTRIBUTE
+    return search_strelem_kernel(mem, len - searched_len + 1,
+                                 searched, searched_len);
+#elif HAS_SSE2_INTRINSICS
+    return search_strelem_sse2(mem, len - searched_len + 1,
+                               searched, searched_len);
+#else
+    return search_strelem_scalar(mem, len - searched_len + 1,
+                                 searched, searched_len);
+#endif
+  } /* memmem_strelem */
+
+
+
 #if STACK_LIKE_ALLOC_FOR_OS_STRI
 os_striType heapAllocOsStri (memSizeType len)
 
@@ -705,6 +961,328 @@ void heapFreeOsStri (const_os_striType var)
 
 
 
+#if HAS_SSE2_INTRINSICS
+/**
+ *  Check if the 16 UTF-32 characters starting at 'strelem' are ASCII.
+ *  @return TRUE if all characters are in the range 0 to 127,
+ *          FALSE otherwise.
+ */
+static inline boolType is_ascii_block_sse2 (const strElemType *strelem)
+
+  {
+    __m128i any_bits;
+
+  /* is_ascii_block_sse2 */
+    any_bits = _mm_or_si128(
+        _mm_or_si128(_mm_loadu_si128((const __m128i *) strelem),
+                     _mm_loadu_si128((const __m128i *) &strelem[4])),
+        _mm_or_si128(_mm_loadu_si128((const __m128i *) &strelem[8]),
+                     _mm_loadu_si128((const __m128i *) &strelem[12])));
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(
+        _mm_and_si128(any_bits, _mm_set1_epi32(~0x7F)),
+        _mm_setzero_si128())) == 0xFFFF;
+  } /* is_ascii_block_sse2 */
+
+#endif
+
+
+
+/**
+ *  Determine the number of leading ASCII characters in 'strelem'.
+ *  If SSE2 is available 16 characters are checked at once.
+ *  @return the position of the first character > 127 or 'len' if
+ *          there is none.
+ */
+static inline memSizeType ascii_prefix_length (const strElemType *strelem,
+    memSizeType len)
+
+  {
+    memSizeType pos = 0;
+
+  /* ascii_prefix_length */
+#if HAS_SSE2_INTRINSICS
+    while (len - pos >= 16 && is_ascii_block_sse2(&strelem[pos])) {
+      pos += 16;
+    } /* while */
+#endif
+    while (pos < len && strelem[pos] <= 0x7F) {
+      pos++;
+    } /* while */
+    return pos;
+  } /* ascii_prefix_length */
+
+
+
+/**
+ *  Convert the leading ASCII characters of an UTF-8 encoded string.
+ *  ASCII characters are encoded with one byte in UTF-8. If SSE2 is
+ *  available 16 bytes are checked and widened to UTF-32 at once.
+ *  @param dest_stri Destination of the UTF-32 encoded characters.
+ *  @param ustri UTF-8 encoded string to be converted.
+ *  @param len Number of bytes in ustri.
+ *  @return the number of converted bytes. This is the position of
+ *          the first byte > 127 or 'len' if there is none.
+ */
+memSizeType ascii_prefix_to_stri (strElemType *const dest_stri,
+    const_ustriType ustri, memSizeType len)
+
+  {
+    memSizeType pos = 0;
+#if HAS_SSE2_INTRINSICS
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes;
+    __m128i low;
+    __m128i high;
+#endif
+
+  /* ascii_prefix_to_stri */
+#if HAS_SSE2_INTRINSICS
+    while (len - pos >= 16 &&
+           _mm_movemask_epi8(bytes = _mm_loadu_si128((const __m128i *) &ustri[pos])) == 0) {
+      low  = _mm_unpacklo_epi8(bytes, zero);
+      high = _mm_unpackhi_epi8(bytes, zero);
+      _mm_storeu_si128((__m128i *) &dest_stri[pos],      _mm_unpacklo_epi16(low,  zero));
+      _mm_storeu_si128((__m128i *) &dest_stri[pos + 4],  _mm_unpackhi_epi16(low,  zero));
+      _mm_storeu_si128((__m128i *) &dest_stri[pos + 8],  _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128((__m128i *) &dest_stri[pos + 12], _mm_unpackhi_epi16(high, zero));
+      pos += 16;
+    } /* while */
+#endif
+    while (pos < len && ustri[pos] <= 0x7F) {
+      dest_stri[pos] = (strElemType) ustri[pos];
+      pos++;
+    } /* while */
+    return pos;
+  } /* ascii_prefix_to_stri */
+
+
+
+/**
+ *  Convert the leading ASCII characters of an UTF-32 encoded string.
+ *  ASCII characters are encoded with one byte in UTF-8. If SSE2 is
+ *  available 16 characters are checked and narrowed at once.
+ *  @param out_stri Destination of the UTF-8 encoded bytes.
+ *  @param strelem UTF-32 encoded string to be converted.
+ *  @param len Number of UTF-32 characters in strelem.
+ *  @return the number of converted characters. This is the position
+ *          of the first character > 127 or 'len' if there is none.
+ */
+memSizeType stri_ascii_prefix_to_utf8 (const ustriType out_stri,
+    const strElemType *strelem, memSizeType len)
+
+  {
+    memSizeType pos = 0;
+
+  /* stri_ascii_prefix_to_utf8 */
+#if HAS_SSE2_INTRINSICS
+    while (len - pos >= 16 && is_ascii_block_sse2(&strelem[pos])) {
+      _mm_storeu_si128((__m128i *) &out_stri[pos], _mm_packus_epi16(
+          _mm_packs_epi32(_mm_loadu_si128((const __m128i *) &strelem[pos]),
+                          _mm_loadu_si128((const __m128i *) &strelem[pos + 4])),
+          _mm_packs_epi32(_mm_loadu_si128((const __m128i *) &strelem[pos + 8]),
+                          _mm_loadu_si128((const __m128i *) &strelem[pos + 12]))));
+      pos += 16;
+    } /* while */
+#endif
+    while (pos < len && strelem[pos] <= 0x7F) {
+      out_stri[pos] = (ucharType) strelem[pos];
+      pos++;
+    } /* while */
+    return pos;
+  } /* stri_ascii_prefix_to_utf8 */
+
+
+
+/**
+ *  Copy the leading ASCII characters of 'source' to 'dest'.
+ *  This is used when UTF-8 bytes are stored in UTF-32 strings.
+ *  @return the number of copied characters. This is the position
+ *          of the first character > 127 or 'len' if there is none.
+ */
+memSizeType copy_ascii_prefix_strelem (strElemType *const dest,
+    const strElemType *source, memSizeType len)
+
+  {
+    memSizeType ascii_len;
+
+  /* copy_ascii_prefix_strelem */
+    ascii_len = ascii_prefix_length(source, len);
+    memcpy(dest, source, ascii_len * sizeof(strElemType));
+    return ascii_len;
+  } /* copy_ascii_prefix_strelem */
+
+
+
+#if HAS_SSE2_INTRINSICS
+/**
+ *  Check if the 16 UTF-32 characters starting at 'strelem' are in
+ *  the Latin-1 range (0 to 255) and differ from 'stop1' and 'stop2'.
+ */
+static inline boolType is_latin1_block_sse2 (const strElemType *strelem,
+    const __m128i stop1, const __m128i stop2)
+
+  {
+    __m128i chars;
+    __m128i any_bits = _mm_setzero_si128();
+    __m128i stops_found = _mm_setzero_si128();
+    memSizeType index;
+
+  /* is_latin1_block_sse2 */
+    for (index = 0; index < 16; index += 4) {
+      chars = _mm_loadu_si128((const __m128i *) &strelem[index]);
+      any_bits = _mm_or_si128(any_bits, chars);
+      stops_found = _mm_or_si128(stops_found, _mm_or_si128(
+          _mm_cmpeq_epi32(chars, stop1), _mm_cmpeq_epi32(chars, stop2)));
+    } /* for */
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(
+        _mm_and_si128(any_bits, _mm_set1_epi32(~0xFF)),
+        _mm_setzero_si128())) == 0xFFFF &&
+        _mm_movemask_epi8(stops_found) == 0;
+  } /* is_latin1_block_sse2 */
+
+#endif
+
+
+
+/**
+ *  Copy the leading Latin-1 characters of 'source' to 'dest' and
+ *  toggle the case of the letters. The letters are the characters
+ *  from 'first' to 'first' + 25 and from 'latin1First' to
+ *  'latin1First' + 30 (except 'latin1First' + 23). The conversion
+ *  stops at the first character > 255 or equal to 'stop1' or 'stop2'.
+ *  If SSE2 is available 16 characters are converted at once.
+ *  @return the number of converted characters.
+ */
+static memSizeType toggle_latin1_case_prefix (strElemType *const dest,
+    const strElemType *source, memSizeType len, const strElemType first,
+    const strElemType latin1First, const strElemType stop1,
+    const strElemType stop2)
+
+  {
+    memSizeType pos = 0;
+    strElemType ch;
+#if HAS_SSE2_INTRINSICS
+    const __m128i before_first = _mm_set1_epi32((int) first - 1);
+    const __m128i beyond_last = _mm_set1_epi32((int) first + 26);
+    const __m128i before_latin1_first = _mm_set1_epi32((int) latin1First - 1);
+    const __m128i beyond_latin1_last = _mm_set1_epi32((int) latin1First + 31);
+    const __m128i latin1_no_letter = _mm_set1_epi32((int) latin1First + 23);
+    const __m128i stop1_vector = _mm_set1_epi32((int) stop1);
+    const __m128i stop2_vector = _mm_set1_epi32((int) stop2);
+    const __m128i case_bit = _mm_set1_epi32(0x20);
+    __m128i chars;
+    __m128i letters;
+    memSizeType index;
+#endif
+
+  /* toggle_latin1_case_prefix */
+#if HAS_SSE2_INTRINSICS
+    while (len - pos >= 16 &&
+           is_latin1_block_sse2(&source[pos], stop1_vector, stop2_vector)) {
+      for (index = pos; index < pos + 16; index += 4) {
+        chars = _mm_loadu_si128((const __m128i *) &source[index]);
+        letters = _mm_or_si128(
+            _mm_and_si128(_mm_cmpgt_epi32(chars, before_first),
+                          _mm_cmpgt_epi32(beyond_last, chars)),
+            _mm_andnot_si128(_mm_cmpeq_epi32(chars, latin1_no_letter),
+                _mm_and_si128(_mm_cmpgt_epi32(chars, before_latin1_first),
+                              _mm_cmpgt_epi32(beyond_latin1_last, chars))));
+        _mm_storeu_si128((__m128i *) &dest[index],
+            _mm_xor_si128(chars, _mm_and_si128(letters, case_bit)));
+      } /* for */
+      pos += 16;
+    } /* while */
+#endif
+    while (pos < len && (ch = source[pos]) <= 0xFF &&
+           ch != stop1 && ch != stop2) {
+      /* Branch free: The case bit is toggled for letters only. */
+      dest[pos] = ch ^ (strElemType) (((ch - first <= 25) |
+          (ch - latin1First <= 30 && ch != latin1First + 23)) << 5);
+      pos++;
+    } /* while */
+    return pos;
+  } /* toggle_latin1_case_prefix */
+
+
+
+/**
+ *  Copy the leading Latin-1 characters of 'source' as lower case
+ *  characters to 'dest'. 'Source' and 'dest' may be identical.
+ *  The result is the same as the one of toLower.
+ *  @return the number of converted characters. This is the position
+ *          of the first character > 255 or 'len' if there is none.
+ */
+memSizeType lower_latin1_prefix_strelem (strElemType *const dest,
+    const strElemType *source, memSizeType len)
+
+  { /* lower_latin1_prefix_strelem */
+    /* Latin-1 upper case letters: 0xc0 to 0xde without 0xd7. */
+    return toggle_latin1_case_prefix(dest, source, len, 'A', 0xc0,
+                                     0x100, 0x100);
+  } /* lower_latin1_prefix_strelem */
+
+
+
+/**
+ *  Copy the leading Latin-1 characters of 'source' as upper case
+ *  characters to 'dest'. 'Source' and 'dest' may be identical.
+ *  The result is the same as the one of toUpper. The characters
+ *  0xb5 and 0xff have upper case forms outside of Latin-1. They
+ *  are not converted and stop the conversion.
+ *  @return the number of converted characters. This is the position
+ *          of the first character > 255, 0xb5 or 0xff or 'len' if
+ *          there is none.
+ */
+memSizeType upper_latin1_prefix_strelem (strElemType *const dest,
+    const strElemType *source, memSizeType len)
+
+  { /* upper_latin1_prefix_strelem */
+    /* Latin-1 lower case letters: 0xe0 to 0xfe without 0xf7. */
+    return toggle_latin1_case_prefix(dest, source, len, 'a', 0xe0,
+                                     0xb5, 0xff);
+  } /* upper_latin1_prefix_strelem */
+
+
+
+/**
+ *  Determine the number of bytes needed to encode 'strelem' in UTF-8.
+ *  The encoding is the one used by stri_to_utf8.
+ *  @param strelem UTF-32 encoded string to be examined.
+ *  @param len Number of UTF-32 characters in strelem.
+ *  @return the length of the UTF-8 encoded string.
+ */
+memSizeType utf8_size_of_strelem (const strElemType *strelem, memSizeType len)
+
+  {
+    strElemType ch;
+    memSizeType ascii_len;
+    memSizeType utf8_size = 0;
+
+  /* utf8_size_of_strelem */
+    for (; len > 0; strelem++, len--) {
+      ch = *strelem;
+      if (ch <= 0x7F) {
+        ascii_len = ascii_prefix_length(strelem, len);
+        utf8_size += ascii_len;
+        strelem += ascii_len - 1;
+        len -= ascii_len - 1;
+      } else if (ch <= 0x7FF) {
+        utf8_size += 2;
+      } else if (ch <= 0xFFFF) {
+        utf8_size += 3;
+      } else if (ch <= 0x1FFFFF) {
+        utf8_size += 4;
+      } else if (ch <= 0x3FFFFFF) {
+        utf8_size += 5;
+      } else {
+        utf8_size += 6;
+      } /* if */
+    } /* for */
+    return utf8_size;
+  } /* utf8_size_of_strelem */
+
+
+
 /**
  *  Convert an UTF-8 encoded string to an UTF-32 encoded string.
  *  The source and destination strings are not '\0' terminated.
@@ -721,12 +1299,16 @@ memSizeType utf8_to_stri (strElemType *const dest_stri,
 
   {
     strElemType *stri;
+    memSizeType converted;
 
   /* utf8_to_stri */
     stri = dest_stri;
     for (; len > 0; len--) {
       if (*ustri <= 0x7F) {
-        *stri++ = (strElemType) *ustri++;
+        converted = ascii_prefix_to_stri(stri, ustri, len);
+        stri += converted;
+        ustri += converted;
+        len -= converted - 1;
       } else if (ustri[0] >= 0xC0 && ustri[0] <= 0xDF && len >= 2 &&
                  ustri[1] >= 0x80 && ustri[1] <= 0xBF) {
         /* ustri[0]   range 192 to 223 (leading bits 110.....) */
@@ -908,13 +1490,17 @@ memSizeType stri_to_utf8 (const ustriType out_stri,
   {
     register ustriType ustri;
     register strElemType ch;
+    memSizeType converted;
 
   /* stri_to_utf8 */
     ustri = out_stri;
     for (; len > 0; strelem++, len--) {
       ch = *strelem;
       if (ch <= 0x7F) {
-        *ustri++ = (ucharType) ch;
+        converted = stri_ascii_prefix_to_utf8(ustri, strelem, len);
+        ustri += converted;
+        strelem += converted - 1;
+        len -= converted - 1;
       } else if (ch <= 0x7FF) {
         ustri[0] = (ucharType) (0xC0 | (ch >>  6));
         ustri[1] = (ucharType) (0x80 |( ch        & 0x3F));
@@ -186,6 +186,8 @@ boolType memcpy_from_strelem (register const ustriType dest,
 const strElemType *memchr_strelem (register const strElemType *mem,
     const strElemType ch, memSizeType len);
 #endif
+const strElemType *memmem_strelem (const strElemType *mem, memSizeType len,
+    const strElemType *searched, memSizeType searched_len);
 #if STACK_LIKE_ALLOC_FOR_OS_STRI
 os_striType heapAllocOsStri (memSizeType len);
 void heapFreeOsStri (const_os_striType var);
@@ -193,6 +195,17 @@ void heapFreeOsStri (const_os_striType var);
 #ifdef OS_STRI_USES_CODE_PAGE
 charType mapFromCodePage (unsigned char key);
 #endif
+memSizeType ascii_prefix_to_stri (strElemType *const dest_stri,
+                                  const_ustriType ustri, memSizeType len);
+memSizeType stri_ascii_prefix_to_utf8 (const ustriType out_stri,
+                                       const strElemType *strelem, memSizeType len);
+memSizeType copy_ascii_prefix_strelem (strElemType *const dest,
+                                       const strElemType *source, memSizeType len);
+memSizeType lower_latin1_prefix_strelem (strElemType *const dest,
+                                         const strElemType *source, memSizeType len);
+memSizeType upper_latin1_prefix_strelem (strElemType *const dest,
+                                         const strElemType *source, memSizeType len);
+memSizeType utf8_size_of_strelem (const strElemType *strelem, memSizeType len);
 memSizeType utf8_to_stri (strElemType *const dest_stri, memSizeType *const dest_len,
                           const_ustriType ustri, memSizeType len);
 memSizeType utf8_bytes_missing (const const_ustriType ustri, const memSizeType len);
@@ -109,9 +109,9 @@ static arrayType addCopiedStriToArray (const strElemType *stri_elems,
       memcpy(new_stri->mem, stri_elems, length * sizeof(strElemType));
       if (used_max_position >= work_array->max_position) {
         if (unlikely(work_array->max_position > (intType) (MAX_ARR_INDEX / ARRAY_SIZE_FACTOR) ||
-            (resized_work_array = REALLOC_ARRAY(work_array,
+            (REALLOC_ARRAY(resized_work_array, work_array,
                 (uintType) work_array->max_position,
-                (uintType) work_array->max_position * ARRAY_SIZE_FACTOR)) == NULL)) {
+                (uintType) work_array->max_position * ARRAY_SIZE_FACTOR), resized_work_array == NULL))) {
           FREE_STRI(new_stri, new_stri->size);
           freeStriArray(work_array, used_max_position);
           work_array = NULL;
@@ -145,7 +145,7 @@ static inline arrayType completeStriArray (arrayType work_array,
 
   /* completeStriArray */
     if (work_array != NULL) {
-      resized_work_array = REALLOC_ARRAY(work_array,
+      REALLOC_ARRAY(resized_work_array, work_array,
           (uintType) work_array->max_position,
           (uintType) used_max_position);
       if (resized_work_array == NULL) {
@@ -214,10 +214,8 @@ static arrayType strSplit (const const_striType mainStri,
   {
     memSizeType delimiter_size;
     const strElemType *delimiter_mem;
-    strElemType ch_1;
     intType used_max_position;
     const strElemType *search_start;
-    const strElemType *segment_start;
     const strElemType *search_end;
     const strElemType *found_pos;
     arrayType result_array;
@@ -233,33 +231,27 @@ static arrayType strSplit (const const_striType mainStri,
       delimiter_size = delimiter->size;
       delimiter_mem = delimiter->mem;
       search_start = mainStri->mem;
-      segment_start = search_start;
-      if (delimiter_size != 0 && mainStri->size >= delimiter_size) {
-        ch_1 = delimiter_mem[0];
-        search_end = &mainStri->mem[mainStri->size - delimiter_size + 1];
-        while ((found_pos = memchr_strelem(search_start, ch_1,
-            (memSizeType) (search_end - search_start))) != NULL &&
+      search_end = &mainStri->mem[mainStri->size];
+      if (delimiter_size != 0) {
+        while ((memSizeType) (search_end - search_start) >= delimiter_size &&
+            (found_pos = delimiter_size == 1 ?
+                memchr_strelem(search_start, delimiter_mem[0],
+                               (memSizeType) (search_end - search_start)) :
+                memmem_strelem(search_start,
+                               (memSizeType) (search_end - search_start),
+                               delimiter_mem, delimiter_size)) != NULL &&
             result_array != NULL) {
-          if (memcmp(found_pos, delimiter_mem,
-              delimiter_size * sizeof(strElemType)) == 0) {
-            result_array = addCopiedStriToArray(segment_start,
-                (memSizeType) (found_pos - segment_start), result_array,
-                used_max_position);
-            used_max_position++;
-            search_start = found_pos + delimiter_size;
-            segment_start = search_start;
-            if (search_start > search_end) {
-              search_start = search_end;
-            } /* if */
-          } else {
-            search_start = found_pos + 1;
-          } /* if */
+          result_array = addCopiedStriToArray(search_start,
+              (memSizeType) (found_pos - search_start), result_array,
+              used_max_position);
+          used_max_position++;
+          search_start = found_pos + delimiter_size;
         } /* while */
       } /* if */
       if (likely(result_array != NULL)) {
-        result_array = addCopiedStriToArray(segment_start,
-            (memSizeType) (&mainStri->mem[mainStri->size] - segment_start),
-            result_array, used_max_position);
+        result_array = addCopiedStriToArray(search_start,
+            (memSizeType) (search_end - search_start), result_array,
+            used_max_position);
         used_max_position++;
         result_array = completeStriArray(result_array, used_max_position);
       } /* if */
@@ -496,6 +488,24 @@ objectType str_cmp (listType arguments)
 
 
 
+/**
+ *  Compare two strings without regard to case.
+ *  The result is the same as compare(lower(stri1), lower(stri2)).
+ *  @return -1, 0 or 1 if the first argument is considered to be
+ *          respectively less than, equal to, or greater than the
+ *          second.
+ */
+objectType str_cmp_ignore_case (listType arguments)
+
+  { /* str_cmp_ignore_case */
+    isit_stri(arg_1(arguments));
+    isit_stri(arg_2(arguments));
+    return bld_int_temp(strCompareIgnoreCase(take_stri(arg_1(arguments)),
+                                             take_stri(arg_2(arguments))));
+  } /* str_cmp_ignore_case */
+
+
+
 /**
  *  Assign source/arg_3 to dest/arg_1.
  *  A copy function assumes that dest/arg_1 contains a legal value.
@@ -535,6 +545,15 @@ objectType str_cpy (listType arguments)
           memcpy(stri_dest->mem, take_stri(source)->mem,
                  new_size * sizeof(strElemType));
         } /* if */
+#if WITH_STRI_CAPACITY
+      } else if (stri_dest->capacity >= new_size &&
+                 !SHRINK_REASON(stri_dest, new_size)) {
+        /* The destination is reused without allocating memory. */
+        COUNT_GROW2_STRI(stri_dest->size, new_size);
+        stri_dest->size = new_size;
+        memcpy(stri_dest->mem, take_stri(source)->mem,
+               new_size * sizeof(strElemType));
+#endif
       } else {
         if (unlikely(!ALLOC_STRI_SIZE_OK(stri_dest, new_size))) {
           return raise_exception(SYS_MEM_EXCEPTION);
@@ -855,11 +874,25 @@ objectType str_hashcode (listType arguments)
   /* str_hashcode */
     isit_stri(arg_1(arguments));
     stri = take_stri(arg_1(arguments));
-    return bld_int_temp(hashCode(stri));
+    return bld_int_temp(strHashCode(stri));
   } /* str_hashcode */
 
 
 
+/**
+ *  Compute the hash value of a string without regard to case.
+ *  The result is the same as hashCode(lower(stri)).
+ *  @return the hash value.
+ */
+objectType str_hashcode_ignore_case (listType arguments)
+
+  { /* str_hashcode_ignore_case */
+    isit_stri(arg_1(arguments));
+    return bld_int_temp(strHashCodeIgnoreCase(take_stri(arg_1(arguments))));
+  } /* str_hashcode_ignore_case */
+
+
+
 /**
  *  Get a substring ending at a stop position.
  *  The first character in a string has the position 1.
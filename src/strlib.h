@@ -32,6 +32,7 @@ objectType str_chpos       (listType arguments);
 objectType str_chsplit     (listType arguments);
 objectType str_clit        (listType arguments);
 objectType str_cmp         (listType arguments);
+objectType str_cmp_ignore_case (listType arguments);
 objectType str_cpy         (listType arguments);
 objectType str_create      (listType arguments);
 objectType str_destr       (listType arguments);
@@ -43,6 +44,7 @@ objectType str_for_var_key (listType arguments);
 objectType str_ge          (listType arguments);
 objectType str_gt          (listType arguments);
 objectType str_hashcode    (listType arguments);
+objectType str_hashcode_ignore_case (listType arguments);
 objectType str_head        (listType arguments);
 objectType str_idx         (listType arguments);
 objectType str_ipos        (listType arguments);
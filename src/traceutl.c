@@ -368,6 +368,8 @@ void prot_bstri (bstriType bstri)
 void prot_set (const_setType setValue)
 
   {
+    memSizeType size;
+    memSizeType index;
     intType position;
     bitSetType bitset_elem;
     unsigned int bit_index;
@@ -381,8 +383,19 @@ void prot_set (const_setType setValue)
       prot_int(setValue->max_position);
       prot_cstri("]{");
       first_elem = TRUE;
-      for (position = setValue->min_position; position <= setValue->max_position; position++) {
-        bitset_elem = setValue->bitset[position - setValue->min_position];
+      if (setIsSparse(setValue)) {
+        size = sparseUsed(setValue);
+      } else {
+        size = bitsetSize(setValue);
+      } /* if */
+      for (index = 0; index < size; index++) {
+        if (setIsSparse(setValue)) {
+          position = (intType) setValue->bitset[index];
+          bitset_elem = setValue->bitset[sparseSize(setValue) + index];
+        } else {
+          position = setValue->min_position + (intType) index;
+          bitset_elem = setValue->bitset[index];
+        } /* if */
         if (bitset_elem != 0) {
           for (bit_index = 0; bit_index < CHAR_BIT * sizeof(bitSetType); bit_index++) {
             if (bitset_elem & ((bitSetType) 1) << bit_index) {